@@ -9,10 +9,10 @@
 template<class T>
 class ArrayIDFunc{
 public:
-	ArrayIDFunc()noexcept:preimage_count_(0), data_(nullptr){}
+	ArrayIDFunc()noexcept:preimage_count_(0), data_(nullptr), capacity_(0){}
 
 	explicit ArrayIDFunc(int preimage_count)
-		:preimage_count_(preimage_count){
+		:preimage_count_(preimage_count), capacity_(preimage_count){
 		assert(preimage_count >= 0 && "ids may not be negative");
 		if(preimage_count == 0)
 			data_ = nullptr;
@@ -22,7 +22,7 @@ public:
 
 	template<class IDFunc>
 	ArrayIDFunc(const IDFunc&o)
-		:preimage_count_(o.preimage_count()){
+		:preimage_count_(o.preimage_count()), capacity_(o.preimage_count()){
 		if(preimage_count_ == 0)
 			data_ = nullptr;
 		else{
@@ -38,7 +38,7 @@ public:
 	}
 
 	ArrayIDFunc(const ArrayIDFunc&o)
-		:preimage_count_(o.preimage_count_){
+		:preimage_count_(o.preimage_count_), capacity_(o.preimage_count_){
 		if(preimage_count_ == 0)
 			data_ = nullptr;
 		else{
@@ -53,9 +53,10 @@ public:
 	}
 
 	ArrayIDFunc(ArrayIDFunc&&o)noexcept
-		:preimage_count_(o.preimage_count_), data_(o.data_){
+		:preimage_count_(o.preimage_count_), data_(o.data_), capacity_(o.capacity_){
 		o.preimage_count_ = 0;
 		o.data_ = nullptr;
+		o.capacity_ = 0;
 	}
 
 	~ArrayIDFunc(){
@@ -65,6 +66,7 @@ public:
 	void swap(ArrayIDFunc&o)noexcept{
 		std::swap(preimage_count_, o.preimage_count_);
 		std::swap(data_, o.data_);
+		std::swap(capacity_, o.capacity_);
 	}
 
 	template<class IDFunc>
@@ -85,6 +87,7 @@ public:
 		this->~ArrayIDFunc();
 		data_ = nullptr;
 		preimage_count_ = 0;
+		capacity_ = 0;
 		swap(o);
 		return *this;
 	}
@@ -112,6 +115,20 @@ public:
 		std::fill(data_, data_+preimage_count_, t);
 	}
 
+	//! Changes the preimage count and leaves the values unspecified. The memory is only
+	//! reallocated if the array never had as many elements before. This allows reusing an
+	//! array for many differently sized inputs without allocating each time.
+	void discard_and_resize(int new_preimage_count){
+		assert(new_preimage_count >= 0 && "ids may not be negative");
+		if(new_preimage_count > capacity_)
+			ArrayIDFunc(new_preimage_count).swap(*this);
+		preimage_count_ = new_preimage_count;
+	}
+
+	int capacity()const{
+		return capacity_;
+	}
+
 	// Array only functionality
 	T&operator[](int id){
 		assert(0 <= id && id < preimage_count_ && "id out of bounds");
@@ -130,6 +147,7 @@ public:
 
 	int preimage_count_;
 	T*data_;
+	int capacity_;
 };
 
 struct ArrayIDIDFunc : public ArrayIDFunc<int>{
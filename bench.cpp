@@ -0,0 +1,637 @@
+#include "graph_generator.h"
+#include "list_graph.h"
+#include "flow_cutter.h"
+#include "flow_cutter_config.h"
+#include "cut_enumeration.h"
+#include "separator.h"
+#include "min_fill_in.h"
+#include "elimination_tree.h"
+#include "tree_decomposition.h"
+#include "id_multi_func.h"
+#include "back_arc.h"
+#include "permutation.h"
+#include "chain.h"
+#include "min_max.h"
+#include "timer.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <stdexcept>
+#include <random>
+#include <cmath>
+#include <cstdio>
+
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+using namespace std;
+
+// Runs fixed workloads on deterministic synthetic graphs and reports running times, peak memory and
+// quality metrics as JSON. Every combination of generator, scale and workload runs in a child
+// process of its own, so that the peak resident set size of the child belongs to exactly this
+// combination. It includes the memory of the generated graph.
+
+namespace{
+
+	struct Options{
+		vector<string>generators = {"grid", "rgg", "delaunay", "road", "power_law"};
+		vector<string>scales = {"small"};
+		vector<string>workloads = {"dfs", "enum_cuts", "nested_dissection", "cch_order", "tree_decomposition"};
+		int warmup_count = 1;
+		int repetition_count = 3;
+		int seed = 1;
+		int thread_count = 1;
+		string output_file = "-";
+		string compare_file;
+		double tolerance = 0.1;
+	};
+
+	int get_scale_node_count(const string&scale){
+		if(scale == "tiny")
+			return 1000;
+		else if(scale == "small")
+			return 10000;
+		else if(scale == "medium")
+			return 100000;
+		else if(scale == "large")
+			return 1000000;
+		else
+			throw runtime_error("unknown scale "+scale+", valid are tiny, small, medium and large");
+	}
+
+	ListGraph generate_graph(const string&generator, int node_count, int seed){
+		if(generator == "grid")
+			return graph_generator::make_grid_graph((int)std::sqrt((double)node_count));
+		else if(generator == "rgg")
+			return graph_generator::make_random_geometric_graph(node_count, 8.0, seed);
+		else if(generator == "delaunay")
+			return graph_generator::make_delaunay_graph(node_count, seed);
+		else if(generator == "road")
+			return graph_generator::make_road_like_graph(node_count, 0.15, seed);
+		else if(generator == "power_law")
+			return graph_generator::make_power_law_graph(node_count, 3, seed);
+		else
+			throw runtime_error("unknown generator "+generator+", valid are grid, rgg, delaunay, road and power_law");
+	}
+
+	// The quality metrics of a workload as JSON members.
+	typedef vector<pair<string, long long>> Quality;
+
+	struct Workload{
+		//! Untimed preparation, run once before the warmups.
+		function<void()>prepare;
+		//! The timed part. Every call must do the same work.
+		function<void()>run;
+		//! Evaluated after the last repetition.
+		function<Quality()>get_quality;
+	};
+
+	Quality get_order_quality(const ListGraph&g, const ArrayIDIDFunc&order){
+		auto inv_order = inverse_permutation(order);
+		auto t = elimination_tree::compute_elimination_tree(chain(g.tail, inv_order), chain(g.head, inv_order));
+		long long arc_count = 0;
+		int max_upward_degree = 0, height = 0;
+		for(int x=0; x<g.node_count(); ++x){
+			arc_count += t.upward_degree(x);
+			max_to(max_upward_degree, t.upward_degree(x));
+			max_to(height, t.depth(x));
+		}
+		return {
+			{"tree_width", max_upward_degree},
+			{"chordal_supergraph_arc_count", arc_count},
+			{"elimination_tree_height", height}
+		};
+	}
+
+	Workload make_workload(const string&name, const ListGraph&g, const flow_cutter::Config&config, int seed){
+		auto state = make_shared<pair<ArrayIDIDFunc, Quality>>();
+		Workload w;
+		w.prepare = []{};
+
+		if(name == "dfs"){
+			// Ten pseudo depth first searches from random roots, as speed_test_pseudo_depth_first_search.
+			w.run = [&g, state, seed]{
+				const int node_count = g.node_count();
+				auto out_arc = invert_sorted_id_id_func(g.tail);
+				ArrayIDFunc<int>stack(node_count);
+				BitIDFunc seen(node_count);
+				std::mt19937 gen(seed);
+				long long seen_count = 0;
+				for(int i=0; i<10; ++i){
+					int r = std::uniform_int_distribution<int>(0, node_count-1)(gen);
+					seen.fill(false);
+					seen.set(r, true);
+					++seen_count;
+					int stack_end = 1;
+					stack[0] = r;
+					while(stack_end != 0){
+						int x = stack[--stack_end];
+						for(auto xy:out_arc(x)){
+							int y = g.head(xy);
+							if(!seen(y)){
+								seen.set(y, true);
+								stack[stack_end++] = y;
+								++seen_count;
+							}
+						}
+					}
+				}
+				state->second = {{"visited_node_count", seen_count}};
+			};
+		}else if(name == "enum_cuts"){
+			w.run = [&g, state, config]{
+				const int node_count = g.node_count();
+				auto out_arc = invert_sorted_id_id_func(g.tail);
+				auto back_arc = compute_back_arc_permutation(g.tail, g.head);
+				auto graph = flow_cutter::make_graph(
+					make_const_ref_id_id_func(g.tail),
+					make_const_ref_id_id_func(g.head),
+					make_const_ref_id_id_func(back_arc),
+					make_const_ref_id_func(g.arc_weight),
+					ConstIntIDFunc<1>(g.arc_count()),
+					make_const_ref_id_func(out_arc)
+				);
+				auto cutter = flow_cutter::make_simple_cutter(graph, config);
+				cutter.init(flow_cutter::select_random_source_target_pairs(node_count, config.cutter_count, config.random_seed), config.random_seed);
+
+				long long cut_count = 0, balanced_cut_size = -1, last_cut_size = 0, last_smaller_side_size = 0;
+				flow_cutter::forall_cuts(
+					cutter, config.max_cut_size,
+					[&](const decltype(cutter)&cutter){
+						++cut_count;
+						last_cut_size = cutter.get_current_cut().size();
+						last_smaller_side_size = cutter.get_current_smaller_cut_side_size();
+						if(balanced_cut_size == -1 && last_smaller_side_size >= config.max_imbalance * node_count)
+							balanced_cut_size = last_cut_size;
+						return true;
+					}
+				);
+				state->second = {
+					{"cut_count", cut_count},
+					{"balanced_cut_size", balanced_cut_size},
+					{"most_balanced_cut_size", last_cut_size},
+					{"most_balanced_smaller_side_size", last_smaller_side_size}
+				};
+			};
+		}else if(name == "nested_dissection" || name == "cch_order"){
+			bool is_cch_order = name == "cch_order";
+			w.run = [&g, state, config, is_cch_order]{
+				if(is_cch_order)
+					state->first = cch_order::compute_cch_graph_order(g.tail, g.head, g.arc_weight, flow_cutter::ComputeSeparator(config), flow_cutter::get_nested_dissection_cutoff(config));
+				else
+					state->first = cch_order::compute_nested_dissection_graph_order(g.tail, g.head, g.arc_weight, flow_cutter::ComputeSeparator(config), flow_cutter::get_nested_dissection_cutoff(config));
+			};
+			w.get_quality = [&g, state]{ return get_order_quality(g, state->first); };
+		}else if(name == "tree_decomposition"){
+			// The CCH order is computed untimed. Only the decomposition itself is measured.
+			auto ranked = make_shared<pair<ArrayIDIDFunc, ArrayIDIDFunc>>();
+			w.prepare = [&g, ranked, config]{
+				auto order = cch_order::compute_cch_graph_order(g.tail, g.head, g.arc_weight, flow_cutter::ComputeSeparator(config), flow_cutter::get_nested_dissection_cutoff(config));
+				auto inv_order = inverse_permutation(order);
+				ranked->first = chain(g.tail, inv_order);
+				ranked->second = chain(g.head, inv_order);
+			};
+			w.run = [ranked, state]{
+				auto td = compute_tree_decomposition(ranked->first, ranked->second);
+				state->second = {{"bag_count", td.bag_count()}, {"maximum_bag_size", td.maximum_bag_size}};
+			};
+		}else{
+			throw runtime_error("unknown workload "+name+", valid are dfs, enum_cuts, nested_dissection, cch_order and tree_decomposition");
+		}
+
+		if(!w.get_quality)
+			w.get_quality = [state]{ return state->second; };
+		return w;
+	}
+
+	struct Result{
+		string generator, scale, workload;
+		int node_count, arc_count;
+		vector<long long>running_time;
+		long long peak_rss_kb;
+		Quality quality;
+		string error;
+	};
+
+	long long median(vector<long long>v){
+		if(v.empty())
+			return 0;
+		sort(v.begin(), v.end());
+		return v[v.size()/2];
+	}
+
+	// Runs a workload in a child process. The child reports its results as text over a pipe and the
+	// parent obtains the peak memory of the child from wait4.
+	Result run_isolated(const Options&opt, const string&generator, const string&scale, const string&workload){
+		Result r;
+		r.generator = generator;
+		r.scale = scale;
+		r.workload = workload;
+		r.node_count = r.arc_count = 0;
+		r.peak_rss_kb = 0;
+
+		int fd[2];
+		if(pipe(fd) != 0)
+			throw runtime_error("pipe failed");
+		cout << flush;
+		cerr << flush;
+		pid_t pid = fork();
+		if(pid < 0)
+			throw runtime_error("fork failed");
+
+		if(pid == 0){
+			close(fd[0]);
+			ostringstream out;
+			try{
+				auto g = generate_graph(generator, get_scale_node_count(scale), opt.seed);
+
+				flow_cutter::Config config;
+				config.random_seed = opt.seed;
+				config.thread_count = opt.thread_count;
+
+				auto w = make_workload(workload, g, config, opt.seed);
+				w.prepare();
+				for(int i=0; i<opt.warmup_count; ++i)
+					w.run();
+				out << "ok\n" << g.node_count() << ' ' << g.arc_count() << '\n';
+				for(int i=0; i<opt.repetition_count; ++i){
+					long long time = -get_micro_time();
+					w.run();
+					time += get_micro_time();
+					out << time << ' ';
+				}
+				out << '\n';
+				for(auto&q:w.get_quality())
+					out << q.first << ' ' << q.second << '\n';
+			}catch(exception&err){
+				out.str("");
+				out << "error\n" << err.what() << '\n';
+			}
+			string text = out.str();
+			size_t done = 0;
+			while(done < text.size()){
+				ssize_t n = write(fd[1], text.data()+done, text.size()-done);
+				if(n <= 0)
+					break;
+				done += n;
+			}
+			close(fd[1]);
+			_exit(0);
+		}
+
+		close(fd[1]);
+		string text;
+		char buffer[4096];
+		ssize_t n;
+		while((n = read(fd[0], buffer, sizeof(buffer))) > 0)
+			text.append(buffer, n);
+		close(fd[0]);
+
+		int status;
+		rusage usage;
+		wait4(pid, &status, 0, &usage);
+		r.peak_rss_kb = usage.ru_maxrss;
+
+		istringstream in(text);
+		string line;
+		getline(in, line);
+		if(line == "ok"){
+			in >> r.node_count >> r.arc_count;
+			getline(in, line);
+			getline(in, line);
+			istringstream times(line);
+			long long t;
+			while(times >> t)
+				r.running_time.push_back(t);
+			string key;
+			long long value;
+			while(in >> key >> value)
+				r.quality.push_back({key, value});
+		}else if(line == "error"){
+			getline(in, r.error);
+		}else{
+			r.error = "child process terminated abnormally";
+		}
+		return r;
+	}
+
+	string escape_json(const string&s){
+		string r;
+		for(char c:s){
+			if(c == '"' || c == '\\')
+				r += '\\';
+			if((unsigned char)c < 0x20)
+				continue;
+			r += c;
+		}
+		return r;
+	}
+
+	void write_json(ostream&out, const Options&opt, const vector<Result>&results){
+		out
+			<< "{\n"
+			<< "\"seed\": " << opt.seed << ",\n"
+			<< "\"warmup_count\": " << opt.warmup_count << ",\n"
+			<< "\"repetition_count\": " << opt.repetition_count << ",\n"
+			<< "\"thread_count\": " << opt.thread_count << ",\n"
+			<< "\"results\": [\n";
+		for(int i=0; i<(int)results.size(); ++i){
+			const auto&r = results[i];
+			out
+				<< "{\"generator\": \"" << r.generator << "\", \"scale\": \"" << r.scale << "\", \"workload\": \"" << r.workload << "\", "
+				<< "\"node_count\": " << r.node_count << ", \"arc_count\": " << r.arc_count << ", ";
+			if(!r.error.empty()){
+				out << "\"error\": \"" << escape_json(r.error) << "\"";
+			}else{
+				out << "\"running_time_musec\": [";
+				for(int j=0; j<(int)r.running_time.size(); ++j)
+					out << (j == 0 ? "" : ", ") << r.running_time[j];
+				out
+					<< "], \"median_running_time_musec\": " << median(r.running_time)
+					<< ", \"peak_rss_kb\": " << r.peak_rss_kb
+					<< ", \"quality\": {";
+				for(int j=0; j<(int)r.quality.size(); ++j)
+					out << (j == 0 ? "" : ", ") << '"' << r.quality[j].first << "\": " << r.quality[j].second;
+				out << "}";
+			}
+			out << "}" << (i+1 == (int)results.size() ? "" : ",") << '\n';
+		}
+		out << "]\n}" << endl;
+	}
+
+	// A minimal JSON reader, sufficient for files written by write_json.
+	struct JsonValue{
+		enum class Type{null, boolean, number, string, array, object}type = Type::null;
+		double number = 0;
+		string text;
+		vector<JsonValue>array;
+		vector<pair<string, JsonValue>>object;
+
+		const JsonValue*find(const string&key)const{
+			for(auto&m:object)
+				if(m.first == key)
+					return &m.second;
+			return nullptr;
+		}
+	};
+
+	class JsonParser{
+	public:
+		explicit JsonParser(const string&text):text(text), pos(0){}
+
+		JsonValue parse(){
+			JsonValue v = parse_value();
+			skip_space();
+			if(pos != text.size())
+				fail("trailing characters");
+			return v;
+		}
+
+	private:
+		[[noreturn]] void fail(const string&msg)const{
+			throw runtime_error("JSON parse error at offset "+to_string(pos)+": "+msg);
+		}
+
+		void skip_space(){
+			while(pos < text.size() && isspace((unsigned char)text[pos]))
+				++pos;
+		}
+
+		void expect(char c){
+			skip_space();
+			if(pos >= text.size() || text[pos] != c)
+				fail(string("expected ")+c);
+			++pos;
+		}
+
+		bool try_consume(char c){
+			skip_space();
+			if(pos < text.size() && text[pos] == c){
+				++pos;
+				return true;
+			}
+			return false;
+		}
+
+		string parse_string(){
+			expect('"');
+			string s;
+			while(pos < text.size() && text[pos] != '"'){
+				if(text[pos] == '\\'){
+					++pos;
+					if(pos >= text.size())
+						break;
+				}
+				s += text[pos++];
+			}
+			expect('"');
+			return s; // NVRO
+		}
+
+		JsonValue parse_value(){
+			skip_space();
+			if(pos >= text.size())
+				fail("unexpected end");
+			JsonValue v;
+			char c = text[pos];
+			if(c == '{'){
+				++pos;
+				v.type = JsonValue::Type::object;
+				if(!try_consume('}')){
+					do{
+						skip_space();
+						string key = parse_string();
+						expect(':');
+						v.object.push_back({key, parse_value()});
+					}while(try_consume(','));
+					expect('}');
+				}
+			}else if(c == '['){
+				++pos;
+				v.type = JsonValue::Type::array;
+				if(!try_consume(']')){
+					do{
+						v.array.push_back(parse_value());
+					}while(try_consume(','));
+					expect(']');
+				}
+			}else if(c == '"'){
+				v.type = JsonValue::Type::string;
+				v.text = parse_string();
+			}else if(text.compare(pos, 4, "true") == 0 || text.compare(pos, 5, "false") == 0){
+				v.type = JsonValue::Type::boolean;
+				v.number = text[pos] == 't';
+				pos += text[pos] == 't' ? 4 : 5;
+			}else if(text.compare(pos, 4, "null") == 0){
+				pos += 4;
+			}else{
+				size_t end;
+				v.type = JsonValue::Type::number;
+				try{
+					v.number = stod(text.substr(pos, 32), &end);
+				}catch(exception&){
+					fail("invalid value");
+				}
+				pos += end;
+			}
+			return v;
+		}
+
+		const string&text;
+		size_t pos;
+	};
+
+	//! Prints the change of the median running time and of the quality of every result that is also
+	//! in the baseline. Returns the number of running time regressions above the tolerance.
+	int compare_with_baseline(const string&file_name, const vector<Result>&results, double tolerance){
+		ifstream in(file_name);
+		if(!in)
+			throw runtime_error("could not open "+file_name);
+		stringstream buffer;
+		buffer << in.rdbuf();
+		string text = buffer.str();
+		JsonValue baseline = JsonParser(text).parse();
+		auto baseline_results = baseline.find("results");
+		if(baseline_results == nullptr)
+			throw runtime_error(file_name+" has no results");
+
+		int regression_count = 0;
+		cerr << left << setw(12) << "generator" << setw(8) << "scale" << setw(20) << "workload" << right << setw(14) << "old musec" << setw(14) << "new musec" << setw(9) << "change" << "  quality" << endl;
+		for(auto&r:results){
+			if(!r.error.empty())
+				continue;
+			for(auto&b:baseline_results->array){
+				auto g = b.find("generator"), s = b.find("scale"), w = b.find("workload"), t = b.find("median_running_time_musec");
+				if(!g || !s || !w || !t || g->text != r.generator || s->text != r.scale || w->text != r.workload)
+					continue;
+
+				long long old_time = t->number, new_time = median(r.running_time);
+				double change = old_time == 0 ? 0.0 : (double)new_time/old_time - 1.0;
+				bool is_regression = change > tolerance;
+				if(is_regression)
+					++regression_count;
+
+				string quality_change;
+				if(auto q = b.find("quality"))
+					for(auto&m:r.quality)
+						if(auto old_q = q->find(m.first))
+							if((long long)old_q->number != m.second)
+								quality_change += " "+m.first+" "+to_string((long long)old_q->number)+"->"+to_string(m.second);
+				if(quality_change.empty())
+					quality_change = " unchanged";
+
+				cerr
+					<< left << setw(12) << r.generator << setw(8) << r.scale << setw(20) << r.workload << right
+					<< setw(14) << old_time << setw(14) << new_time
+					<< setw(8) << fixed << setprecision(1) << 100.0*change << '%'
+					<< quality_change << (is_regression ? "  REGRESSION" : "") << endl;
+			}
+		}
+		return regression_count;
+	}
+
+	vector<string>split_list(const string&s){
+		vector<string>l;
+		istringstream in(s);
+		string x;
+		while(getline(in, x, ','))
+			if(!x.empty())
+				l.push_back(x);
+		return l; // NVRO
+	}
+
+	void print_usage(const char*name){
+		Options d;
+		cout
+			<< "Usage: " << name << " [options]\n\n"
+			<< "  --generators list    comma separated list of grid, rgg, delaunay, road and power_law\n"
+			<< "  --scales list        comma separated list of tiny, small, medium and large (10^3 to 10^6 nodes), default small\n"
+			<< "  --workloads list     comma separated list of dfs, enum_cuts, nested_dissection, cch_order and tree_decomposition\n"
+			<< "  --warmups n          untimed runs before the measurement, default " << d.warmup_count << "\n"
+			<< "  --repetitions n      timed runs, default " << d.repetition_count << "\n"
+			<< "  --seed n             seed of the generators and the flow cutter, default " << d.seed << "\n"
+			<< "  --threads n          flow cutter thread count, default " << d.thread_count << "\n"
+			<< "  --output file        JSON output file, default stdout\n"
+			<< "  --compare file       JSON output of an earlier run to compare against, the exit code is 1 on regressions\n"
+			<< "  --tolerance x        relative slowdown of the median reported as regression, default " << d.tolerance << endl;
+	}
+}
+
+int main(int argc, char*argv[]){
+	try{
+		Options opt;
+		for(int i=1; i<argc; ++i){
+			string arg = argv[i];
+			if(arg == "--help" || arg == "help"){
+				print_usage(argv[0]);
+				return 0;
+			}
+			if(i+1 == argc)
+				throw runtime_error("option "+arg+" needs a value");
+			string val = argv[++i];
+			if(arg == "--generators")
+				opt.generators = split_list(val);
+			else if(arg == "--scales")
+				opt.scales = split_list(val);
+			else if(arg == "--workloads")
+				opt.workloads = split_list(val);
+			else if(arg == "--warmups")
+				opt.warmup_count = stoi(val);
+			else if(arg == "--repetitions")
+				opt.repetition_count = max(1, stoi(val));
+			else if(arg == "--seed")
+				opt.seed = stoi(val);
+			else if(arg == "--threads")
+				opt.thread_count = max(1, stoi(val));
+			else if(arg == "--output")
+				opt.output_file = val;
+			else if(arg == "--compare")
+				opt.compare_file = val;
+			else if(arg == "--tolerance")
+				opt.tolerance = stod(val);
+			else
+				throw runtime_error("unknown option "+arg);
+		}
+
+		for(auto&s:opt.scales)
+			get_scale_node_count(s);
+
+		vector<Result>results;
+		for(auto&scale:opt.scales){
+			for(auto&generator:opt.generators){
+				for(auto&workload:opt.workloads){
+					auto r = run_isolated(opt, generator, scale, workload);
+					cerr << generator << ' ' << scale << ' ' << workload << " : ";
+					if(r.error.empty())
+						cerr << median(r.running_time) << "musec, " << r.peak_rss_kb << "kb" << endl;
+					else
+						cerr << "error " << r.error << endl;
+					results.push_back(move(r));
+				}
+			}
+		}
+
+		if(opt.output_file == "-"){
+			write_json(cout, opt, results);
+		}else{
+			ofstream out(opt.output_file);
+			if(!out)
+				throw runtime_error("could not open "+opt.output_file+" for writing");
+			write_json(out, opt, results);
+		}
+
+		if(!opt.compare_file.empty() && compare_with_baseline(opt.compare_file, results, opt.tolerance) != 0)
+			return 1;
+	}catch(exception&err){
+		cerr << "Exception : " << err.what() << endl;
+		return 1;
+	}
+}
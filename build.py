@@ -27,6 +27,12 @@ ignore_warnings = ("--ignore-warnings" in sys.argv)
 # Get rid of GPL dependencies
 no_gpl = ("--no-gpl" in sys.argv)
 
+# Collect the flow cutter work counters?
+use_instrumentation = ("--instrument" in sys.argv)
+
+# Specialize the flow cutter for every pierce rating at the expense of a much longer compile time?
+specialize_every_pierce_rating = ("--specialize-every-pierce-rating" in sys.argv)
+
 # Clean up after being finished?
 show_header_scanning = ("--show-header-scanning" in sys.argv)
 
@@ -42,6 +48,12 @@ else:
 if no_gpl:
 	compiler_settings += ["-DNO_GPL"]
 
+if use_instrumentation:
+	compiler_settings += ["-DFLOW_CUTTER_INSTRUMENTATION"]
+
+if specialize_every_pierce_rating:
+	compiler_settings += ["-DFLOW_CUTTER_SPECIALIZE_EVERY_PIERCE_RATING"]
+
 linker_settings = []
 
 source_extensions = [".cpp", ".cxx"]
@@ -60,6 +72,12 @@ def make_object_file_name(whole_path):
 	base_name, extension = os.path.splitext(file_name)
 	return os.path.join(path, "."+base_name+".o")
 
+# Objects of shared libraries are compiled as position independent code and stored separately.
+def make_pic_object_file_name(whole_path):
+	path, file_name = os.path.split(whole_path)
+	base_name, extension = os.path.splitext(file_name)
+	return os.path.join(path, "."+base_name+".pic.o")
+
 if use_colors:
 	color_command = '\033[92m'
 	color_error = '\033[91m'
@@ -134,6 +152,7 @@ main_file_list = []
 def gen_file_lists():
 	global source_file_list
 	global main_file_list
+	global shared_library_list
 	global header_file_list
 
 	header_file_list = []
@@ -154,6 +173,11 @@ def gen_file_lists():
 			re.search(r"int\s+main\s*\(", open(x,"r").read(), re.M) != None and
 			re.search(r"//\s+do\s+not\s+build", open(x,"r").read(), re.M) == None)
 
+	# Source files containing "// build shared library libname.so" are the roots of shared libraries.
+	shared_library_list = list((x, m.group(1)) for x in source_file_list
+		for m in [re.search(r"//\s+build\s+shared\s+library\s+(\S+)", open(x,"r").read(), re.M)]
+		if m != None)
+
 gen_file_lists()
 
 if use_verbose:
@@ -178,6 +202,11 @@ if use_verbose:
 		print(" * "+"\n * ".join(main_file_list))
 	print("")
 
+	if len(shared_library_list) != 0:
+		print("The following source files were identified as shared library roots:")
+		print(" * "+"\n * ".join(x+" -> "+y for x, y in shared_library_list))
+		print("")
+
 ################################################################################
 ## Generate Dependencies
 ##
@@ -349,11 +378,37 @@ def build_all_files():
 
 build_all_files()
 
+def build_all_shared_libraries():
+
+	for library_file, so_file in shared_library_list:
+		object_files = list(make_pic_object_file_name(x) for x in link_against[library_file])
+
+		for x in link_against[library_file]:
+			object_file = make_pic_object_file_name(x)
+
+			if get_last_modified(object_file) < source_last_modify[x]:
+				if use_verbose:
+					print("Compiling "+object_file)
+				run_compiler(x, object_file, compiler_flags[x] + ["-fPIC"])
+			else:
+				if use_verbose:
+					print("No need to recompile "+object_file)
+
+		if get_last_modified(so_file) < max([get_last_modified(x) for x in object_files]):
+			if use_verbose:
+				print("Linking "+so_file)
+			run_linker(object_files, so_file, linker_flags[library_file] + ["-shared"])
+		else:
+			if use_verbose:
+				print("No need to relink "+so_file)
+
+build_all_shared_libraries()
+
 ################################################################################
 ## Cleanup
 ##
 def do_cleanup():
-	for x in (make_object_file_name(y) for y in source_file_list):
+	for x in (f(y) for y in source_file_list for f in [make_object_file_name, make_pic_object_file_name]):
 		if os.path.exists(x):
 			cmd(["rm", x])
 
@@ -0,0 +1,267 @@
+#ifndef CCH_H
+#define CCH_H
+
+#include "array_id_func.h"
+#include "id_func.h"
+#include "tiny_id_func.h"
+#include "count_range.h"
+#include "contraction_graph.h"
+#include "min_max.h"
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <omp.h>
+
+// Customizable Contraction Hierarchies. The node IDs of the input graph are interpreted as the
+// contraction order, i.e., the graph is expected to have been reordered using one of the
+// reorder_nodes_in_*_cch_order commands. The topology dependent preprocessing computes the chordal
+// supergraph. The customization assigns weights to all its arcs by enumerating lower triangles and
+// the queries walk up the elimination tree.
+namespace cch{
+
+	const int inf_weight = std::numeric_limits<int>::max();
+
+	class ContractionHierarchy{
+	public:
+		//! Builds the upward chordal supergraph of a symmetric graph whose node IDs are the order.
+		template<class Tail, class Head>
+		ContractionHierarchy(const Tail&input_tail, const Head&input_head){
+			const int node_count = input_tail.image_count();
+			const int input_arc_count = input_tail.preimage_count();
+
+			std::vector<int>up_tail, up_head;
+			if(node_count >= 2){
+				compute_chordal_supergraph(
+					input_tail, input_head,
+					[&](int x, int y){
+						up_tail.push_back(x);
+						up_head.push_back(y);
+					}
+				);
+			}
+
+			const int arc_count = up_head.size();
+
+			first_out = ArrayIDFunc<int>(node_count+1);
+			first_out.fill(0);
+			for(auto x:up_tail)
+				++first_out[x+1];
+			for(int x=0; x<node_count; ++x)
+				first_out[x+1] += first_out[x];
+
+			// compute_chordal_supergraph enumerates the arcs grouped by tail in increasing order
+			head = ArrayIDIDFunc(arc_count, node_count);
+			for(int i=0; i<arc_count; ++i)
+				head[i] = up_head[i];
+			for(int x=0; x<node_count; ++x)
+				std::sort(head.begin()+first_out(x), head.begin()+first_out(x+1));
+
+			elimination_tree_parent = ArrayIDFunc<int>(node_count);
+			for(int x=0; x<node_count; ++x){
+				if(first_out(x) == first_out(x+1))
+					elimination_tree_parent[x] = node_count;
+				else
+					elimination_tree_parent[x] = head(first_out(x));
+			}
+
+			// The customization of a node's upward arcs needs the arcs entering the node from below.
+			first_down = ArrayIDFunc<int>(node_count+1);
+			first_down.fill(0);
+			for(int a=0; a<arc_count; ++a)
+				++first_down[head(a)+1];
+			for(int x=0; x<node_count; ++x)
+				first_down[x+1] += first_down[x];
+			down_arc = ArrayIDFunc<int>(arc_count);
+			down_tail = ArrayIDFunc<int>(arc_count);
+			{
+				ArrayIDFunc<int>pos = first_down;
+				for(int x=0; x<node_count; ++x){
+					for(int a=first_out(x); a<first_out(x+1); ++a){
+						int i = pos[head(a)]++;
+						down_arc[i] = a;
+						down_tail[i] = x;
+					}
+				}
+			}
+
+			// Nodes of the same level have no lower triangle in common and are customized in parallel.
+			ArrayIDFunc<int>level(node_count);
+			level.fill(0);
+			int level_count = node_count == 0 ? 0 : 1;
+			for(int x=0; x<node_count; ++x){
+				int p = elimination_tree_parent(x);
+				if(p != node_count){
+					max_to(level[p], level(x)+1);
+					max_to(level_count, level(p)+1);
+				}
+			}
+			first_node_of_level = ArrayIDFunc<int>(level_count+1);
+			first_node_of_level.fill(0);
+			for(int x=0; x<node_count; ++x)
+				++first_node_of_level[level(x)+1];
+			for(int l=0; l<level_count; ++l)
+				first_node_of_level[l+1] += first_node_of_level[l];
+			node_by_level = ArrayIDFunc<int>(node_count);
+			{
+				ArrayIDFunc<int>pos = first_node_of_level;
+				for(int x=0; x<node_count; ++x)
+					node_by_level[pos[level(x)]++] = x;
+			}
+
+			input_arc_to_cch_arc = ArrayIDFunc<int>(input_arc_count);
+			input_arc_is_upward = BitIDFunc(input_arc_count);
+			for(int a=0; a<input_arc_count; ++a){
+				int x = input_tail(a), y = input_head(a);
+				if(x == y){
+					input_arc_to_cch_arc[a] = -1;
+					continue;
+				}
+				input_arc_is_upward.set(a, x < y);
+				if(y < x)
+					std::swap(x, y);
+				auto begin = head.begin()+first_out(x), end = head.begin()+first_out(x+1);
+				auto pos = std::lower_bound(begin, end, y);
+				assert(pos != end && *pos == y);
+				input_arc_to_cch_arc[a] = pos - head.begin();
+			}
+
+			forward_weight = ArrayIDFunc<int>(arc_count);
+			backward_weight = ArrayIDFunc<int>(arc_count);
+			forward_weight.fill(inf_weight);
+			backward_weight.fill(inf_weight);
+
+			forward_distance = ArrayIDFunc<int>(node_count);
+			backward_distance = ArrayIDFunc<int>(node_count);
+			forward_distance.fill(inf_weight);
+			backward_distance.fill(inf_weight);
+		}
+
+		int node_count()const{ return first_out.preimage_count()-1; }
+		int arc_count()const{ return head.preimage_count(); }
+		int level_count()const{ return first_node_of_level.preimage_count()-1; }
+
+		//! Computes the weights of all supergraph arcs. input_arc_weight is indexed by the arcs of
+		//! the graph that was passed to the constructor. Arc weights may differ per direction.
+		template<class ArcWeight>
+		void customize(const ArcWeight&input_arc_weight, int thread_count = 1){
+			const int node_count = this->node_count();
+
+			forward_weight.fill(inf_weight);
+			backward_weight.fill(inf_weight);
+			for(int a=0; a<input_arc_to_cch_arc.preimage_count(); ++a){
+				int b = input_arc_to_cch_arc(a);
+				if(b == -1)
+					continue;
+				if(input_arc_is_upward(a))
+					min_to(forward_weight[b], input_arc_weight(a));
+				else
+					min_to(backward_weight[b], input_arc_weight(a));
+			}
+
+			#pragma omp parallel num_threads(thread_count)
+			{
+				ArrayIDFunc<int>arc_to(node_count);
+				arc_to.fill(-1);
+
+				for(int l=0; l<level_count(); ++l){
+					#pragma omp for schedule(dynamic, 64)
+					for(int i=first_node_of_level(l); i<first_node_of_level(l+1); ++i){
+						int x = node_by_level(i);
+						for(int xy=first_out(x); xy<first_out(x+1); ++xy)
+							arc_to[head(xy)] = xy;
+
+						// Every lower triangle z < x < y relaxes the arc x -> y. As the chordal
+						// supergraph's heads are sorted, the arcs z -> y with y > x directly follow
+						// the arc z -> x.
+						for(int j=first_down(x); j<first_down(x+1); ++j){
+							int zx = down_arc(j);
+							int z = down_tail(j);
+							int zx_forward = forward_weight(zx), zx_backward = backward_weight(zx);
+							for(int zy=zx+1; zy<first_out(z+1); ++zy){
+								int xy = arc_to(head(zy));
+								assert(xy != -1);
+								if(zx_backward != inf_weight && forward_weight(zy) != inf_weight)
+									min_to(forward_weight[xy], zx_backward + forward_weight(zy));
+								if(backward_weight(zy) != inf_weight && zx_forward != inf_weight)
+									min_to(backward_weight[xy], backward_weight(zy) + zx_forward);
+							}
+						}
+
+						for(int xy=first_out(x); xy<first_out(x+1); ++xy)
+							arc_to[head(xy)] = -1;
+					}
+				}
+			}
+		}
+
+		//! Returns the shortest path distance from s to t with respect to the last customization or
+		//! inf_weight if t is not reachable. Only the elimination tree ancestors of s and t are
+		//! visited.
+		int query(int s, int t){
+			const int node_count = this->node_count();
+
+			forward_distance[s] = 0;
+			backward_distance[t] = 0;
+
+			int x = s, y = t;
+			while(x != y){
+				if(x < y){
+					relax_upward(x, forward_weight, forward_distance);
+					x = elimination_tree_parent(x);
+				}else{
+					relax_upward(y, backward_weight, backward_distance);
+					y = elimination_tree_parent(y);
+				}
+			}
+
+			int dist = inf_weight;
+			for(; x != node_count; x = elimination_tree_parent(x)){
+				if(forward_distance(x) != inf_weight && backward_distance(x) != inf_weight)
+					min_to(dist, forward_distance(x) + backward_distance(x));
+				relax_upward(x, forward_weight, forward_distance);
+				relax_upward(x, backward_weight, backward_distance);
+			}
+
+			for(x = s; x != node_count; x = elimination_tree_parent(x))
+				forward_distance[x] = inf_weight;
+			for(y = t; y != node_count; y = elimination_tree_parent(y))
+				backward_distance[y] = inf_weight;
+
+			return dist;
+		}
+
+	private:
+		void relax_upward(int x, const ArrayIDFunc<int>&weight, ArrayIDFunc<int>&dist){
+			int d = dist(x);
+			if(d == inf_weight)
+				return;
+			for(int xy=first_out(x); xy<first_out(x+1); ++xy)
+				if(weight(xy) != inf_weight)
+					min_to(dist[head(xy)], d + weight(xy));
+		}
+
+		ArrayIDFunc<int>first_out;
+		ArrayIDIDFunc head;
+		ArrayIDFunc<int>elimination_tree_parent;
+
+		ArrayIDFunc<int>first_down;
+		ArrayIDFunc<int>down_arc;
+		ArrayIDFunc<int>down_tail;
+
+		ArrayIDFunc<int>first_node_of_level;
+		ArrayIDFunc<int>node_by_level;
+
+		ArrayIDFunc<int>input_arc_to_cch_arc;
+		BitIDFunc input_arc_is_upward;
+
+		ArrayIDFunc<int>forward_weight;
+		ArrayIDFunc<int>backward_weight;
+
+		ArrayIDFunc<int>forward_distance;
+		ArrayIDFunc<int>backward_distance;
+	};
+}
+
+#endif
+
@@ -0,0 +1,76 @@
+#ifndef COMPACT_ID_FUNC_H
+#define COMPACT_ID_FUNC_H
+
+#include "array_id_func.h"
+#include "count_range.h"
+#include <limits>
+#include <iterator>
+#include <cassert>
+
+//! An id-id function that stores its images as T, for example std::uint16_t. For small graphs
+//! this halves the memory footprint of the arrays compared to ArrayIDIDFunc.
+template<class T>
+class CompactIDIDFunc{
+public:
+	//! Whether every id below id_count fits into T.
+	static bool can_store_ids_below(int id_count){
+		return id_count <= (long long)std::numeric_limits<T>::max() + 1;
+	}
+
+	CompactIDIDFunc():image_count_(0){}
+
+	template<class IDIDFunc>
+	explicit CompactIDIDFunc(const IDIDFunc&f):
+		data_(f.preimage_count()), image_count_(f.image_count()){
+		assert(can_store_ids_below(image_count_));
+		for(int i=0; i<f.preimage_count(); ++i)
+			data_[i] = f(i);
+	}
+
+	int preimage_count()const{ return data_.preimage_count(); }
+	int image_count()const{ return image_count_; }
+
+	int operator()(int x)const{
+		return data_(x);
+	}
+
+private:
+	ArrayIDFunc<T>data_;
+	int image_count_;
+};
+
+//! Same as RangeIDIDMultiFunc but stores the range borders as T. It can be built from any id-id
+//! multi function whose ranges are consecutive count ranges, such as the out arcs of a graph
+//! with sorted tails.
+template<class T>
+class CompactRangeIDIDMultiFunc{
+public:
+	CompactRangeIDIDMultiFunc(){}
+
+	template<class IDIDMultiFunc>
+	explicit CompactRangeIDIDMultiFunc(const IDIDMultiFunc&f):
+		range_begin(f.preimage_count()+1){
+		int end = 0;
+		for(int x=0; x<f.preimage_count(); ++x){
+			auto r = f(x);
+			assert(*std::begin(r) == end && "ranges must be consecutive");
+			range_begin[x] = end;
+			end += std::end(r) - std::begin(r);
+		}
+		assert(CompactIDIDFunc<T>::can_store_ids_below(end+1));
+		range_begin[f.preimage_count()] = end;
+	}
+
+	int preimage_count()const{ return range_begin.preimage_count()-1; }
+	int image_count()const{ return range_begin(preimage_count()); }
+
+	CountRange operator()(int id)const{
+		assert(0 <= id && id < preimage_count() && "id out of bounds");
+		return count_range(range_begin(id), range_begin(id+1));
+	}
+
+private:
+	ArrayIDFunc<T>range_begin;
+};
+
+#endif
@@ -23,6 +23,8 @@
 
 #include "dijkstra.h"
 #include "node_flow_cutter.h"
+#include "hypergraph.h"
+#include "hypergraph_flow_cutter.h"
 #include "triangle_count.h"
 #include "contraction_graph.h"
 #include "separator.h"
@@ -40,6 +42,17 @@
 
 #include "inertial_flow.h"
 
+#include "multilevel_separator.h"
+
+#include "karger_cut.h"
+
+#include "cch.h"
+
+#include "elimination_tree.h"
+
+#include "portfolio.h"
+#include "cut_enumeration.h"
+
 #ifdef USE_KAHIP
 #include "my_kahip.h"
 #endif
@@ -57,6 +70,13 @@
 #include <functional>
 #include <stack>
 #include <omp.h>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <array>
+#include <limits>
 using namespace std;
 
 ArrayIDIDFunc tail, head;
@@ -67,6 +87,8 @@ ArrayIDFunc<GeoPos> node_geo_pos;
 
 ArrayIDIDFunc node_original_position;
 
+Hypergraph hypergraph;
+
 void check_graph_consitency(){
 	#ifndef NDEBUG
 	const int node_count = tail.image_count(), arc_count = tail.preimage_count();
@@ -92,6 +114,8 @@ void check_graph_consitency(){
 stack<ArrayIDIDFunc>node_color_stack;
 
 flow_cutter::Config flow_cutter_config;
+bool use_node_color_as_separator_hint = false;
+bool use_node_weight_as_flow_cutter_balance = false;
 
 bool show_arc_ids = false;
 bool show_undirected = false;
@@ -110,6 +134,239 @@ int select_color(string str){
 		return stoi(str);
 }
 
+//! The elimination tree of the current graph and order. It is cached together with the arcs it
+//! was computed from. Commands that change the graph therefore do not need to invalidate it.
+static elimination_tree::EliminationTree cached_elimination_tree;
+static ArrayIDIDFunc cached_elimination_tree_tail, cached_elimination_tree_head;
+
+static
+bool is_equal_id_id_func(const ArrayIDIDFunc&l, const ArrayIDIDFunc&r){
+	return l.image_count() == r.image_count() && l.preimage_count() == r.preimage_count() && std::equal(l.begin(), l.end(), r.begin());
+}
+
+static
+const elimination_tree::EliminationTree&get_elimination_tree(){
+	if(
+		cached_elimination_tree_tail.image_count() == 0 ||
+		!is_equal_id_id_func(cached_elimination_tree_tail, tail) ||
+		!is_equal_id_id_func(cached_elimination_tree_head, head)
+	){
+		cached_elimination_tree = elimination_tree::compute_elimination_tree(tail, head);
+		cached_elimination_tree_tail = tail;
+		cached_elimination_tree_head = head;
+	}
+	return cached_elimination_tree;
+}
+
+//! Set by the SIGTERM handler and polled by another thread. A lock-free atomic is safe in both.
+static_assert(ATOMIC_BOOL_LOCK_FREE == 2, "std::atomic<bool> must be lock-free to be set in a signal handler");
+static std::atomic<bool> termination_requested(false);
+
+static
+void request_termination(int){
+	termination_requested = true;
+}
+
+//! The width of the tree decomposition induced by an order, where order maps ranks onto nodes.
+static
+int compute_width_of_order(const ArrayIDIDFunc&order){
+	auto inv_order = inverse_permutation(order);
+	auto t = elimination_tree::compute_elimination_tree(chain(tail, inv_order), chain(head, inv_order));
+	int width = 0;
+	for(auto d:t.upward_degree)
+		max_to(width, d);
+	return width;
+}
+
+//! The config of the i-th anytime iteration. Iteration 0 uses the unmodified config. The others
+//! cycle through pierce ratings and augmenting path avoidance strategies with fresh seeds.
+static
+flow_cutter::Config make_anytime_config(int i){
+	typedef flow_cutter::Config Config;
+	static const Config::PierceRating pierce_rating[] = {
+		Config::PierceRating::max_target_minus_source_hop_dist,
+		Config::PierceRating::min_source_hop_dist,
+		Config::PierceRating::max_target_hop_dist,
+		Config::PierceRating::circular_hop,
+		Config::PierceRating::oldest,
+		Config::PierceRating::random
+	};
+	static const Config::AvoidAugmentingPath avoid_augmenting_path[] = {
+		Config::AvoidAugmentingPath::avoid_and_pick_best,
+		Config::AvoidAugmentingPath::avoid_and_pick_oldest,
+		Config::AvoidAugmentingPath::do_not_avoid
+	};
+	const int pierce_rating_count = sizeof(pierce_rating)/sizeof(pierce_rating[0]);
+	const int avoid_augmenting_path_count = sizeof(avoid_augmenting_path)/sizeof(avoid_augmenting_path[0]);
+
+	Config config = flow_cutter_config;
+	config.thread_count = 1;
+	if(i != 0){
+		config.random_seed = flow_cutter_config.random_seed + i;
+		config.pierce_rating = pierce_rating[(i-1) % pierce_rating_count];
+		config.avoid_augmenting_path = avoid_augmenting_path[((i-1) / pierce_rating_count) % avoid_augmenting_path_count];
+		config.cutter_count = flow_cutter_config.cutter_count + (i-1) % 3;
+	}
+	return config;
+}
+
+//! Checks the preconditions of the cut enumeration commands on the current graph.
+static
+void check_cut_enumeration_input(){
+	int node_count = tail.image_count();
+	int arc_count = tail.preimage_count();
+
+	if(!is_sorted(tail.begin(), tail.end()))
+		throw runtime_error("arc tails must be sorted");
+	if(!is_symmetric(tail, head))
+		throw runtime_error("graph must be symmetric");
+	if(!is_connected(tail, head))
+		throw runtime_error("graph must be connected");
+	if(flow_cutter_config.source < -1 || flow_cutter_config.source >= node_count)
+		throw std::runtime_error("source node ID out of bounds");
+	if(flow_cutter_config.target < -1 || flow_cutter_config.target >= node_count)
+		throw std::runtime_error("target node ID out of bounds");
+
+	if(flow_cutter::requires_non_negative_weights(flow_cutter_config)){
+		for(int i=0; i<arc_count; ++i)
+			if(arc_weight(i) < 0)
+				throw std::runtime_error("arc weights must be non-negative");
+	}
+}
+
+//! Random source target pairs in which the source or target of the config replaces the random one.
+static
+std::vector<flow_cutter::SourceTargetPair>select_cut_enumeration_source_target_pairs(){
+	int node_count = tail.image_count();
+
+	std::vector<flow_cutter::SourceTargetPair>pairs;
+	if(flow_cutter_config.source != -1 && flow_cutter_config.target != -1){
+		for(int i=0; i<flow_cutter_config.cutter_count; ++i)
+			pairs.push_back({flow_cutter_config.source, flow_cutter_config.target});
+	}else if(flow_cutter_config.source != -1 || flow_cutter_config.target != -1){
+		pairs = flow_cutter::select_random_source_target_pairs(node_count, flow_cutter_config.cutter_count, flow_cutter_config.random_seed);
+		if(flow_cutter_config.source != -1){
+			for(auto&x:pairs){
+				if(x.target == flow_cutter_config.source)
+					x.target = x.source;
+				x.source = flow_cutter_config.source;
+			}
+		}else{
+			for(auto&x:pairs){
+				if(x.source == flow_cutter_config.target)
+					x.source = x.target;
+				x.target = flow_cutter_config.target;
+			}
+		}
+	}else{
+		pairs = flow_cutter::select_random_source_target_pairs(node_count, flow_cutter_config.cutter_count, flow_cutter_config.random_seed);
+	}
+	return pairs; // NVRO
+}
+
+//! The cutter instance, the smaller side size and the cut size of every enumerated cut. Used to
+//! check that two cutters enumerate the same cuts.
+template<class Cutter>
+static
+std::vector<std::array<int, 3>>enumerate_cut_sizes(Cutter&cutter, int max_cut_size){
+	std::vector<std::array<int, 3>>cuts;
+	flow_cutter::forall_cuts(
+		cutter, max_cut_size,
+		[&](const Cutter&cutter){
+			cuts.push_back({{cutter.get_current_cutter_id(), cutter.get_current_smaller_cut_side_size(), cutter.get_current_cut_size()}});
+			return true;
+		}
+	);
+	return cuts; // NVRO
+}
+
+//! Like SimpleCutter but evaluates the pierce rating and the avoid policy of the config at run
+//! time for every candidate. Only used to measure what the specialization in SimpleCutter saves.
+template<class Graph, class SearchAlgorithm>
+class RuntimePierceNodeScoreCutter{
+public:
+	RuntimePierceNodeScoreCutter(const Graph&graph, flow_cutter::Config config):
+		graph(graph), tmp(config.thread_count, flow_cutter::TemporaryData(graph.node_count())), config(config), score(config){}
+
+	void init(const std::vector<flow_cutter::SourceTargetPair>&p, int random_seed){
+		cutter.init(graph, tmp, SearchAlgorithm(), score, flow_cutter::get_distance_type(config), p, random_seed, should_skip());
+	}
+
+	bool advance(){
+		return cutter.advance(graph, tmp, SearchAlgorithm(), score, should_skip());
+	}
+
+	int get_current_smaller_cut_side_size()const{ return cutter.get_current_smaller_cut_side_size(); }
+	const std::vector<int>&get_current_cut()const{ return cutter.get_current_cut(); }
+	int get_current_cut_size()const{ return cutter.get_current_cut_size(); }
+	int get_current_cutter_id()const{ return cutter.get_current_cutter_id(); }
+
+private:
+	bool should_skip()const{
+		return config.skip_non_maximum_sides == flow_cutter::Config::SkipNonMaximumSides::skip;
+	}
+
+	const Graph&graph;
+	std::vector<flow_cutter::TemporaryData>tmp;
+	flow_cutter::MultiCutter cutter;
+	flow_cutter::Config config;
+	flow_cutter::PierceNodeScore score;
+};
+
+//! Enumerates the cuts up to flow_cutter_config.max_cut_size repetition_count times with the run
+//! time and with the compile time pierce node score and reports the fastest running time of each.
+template<class Graph>
+static
+void benchmark_pierce_node_score(const Graph&graph, int repetition_count){
+	auto pairs = select_cut_enumeration_source_target_pairs();
+
+	auto run = [&](std::function<std::vector<std::array<int, 3>>()>enumerate, std::vector<std::array<int, 3>>&cuts){
+		long long best_time = std::numeric_limits<long long>::max();
+		for(int i=0; i<repetition_count; ++i){
+			long long time = -get_micro_time();
+			cuts = enumerate();
+			time += get_micro_time();
+			min_to(best_time, time);
+		}
+		return best_time;
+	};
+
+	std::vector<std::array<int, 3>>runtime_cuts, specialized_cuts;
+	long long runtime_time = run(
+		[&]{
+			switch(flow_cutter_config.graph_search_algorithm){
+			case flow_cutter::Config::GraphSearchAlgorithm::pseudo_depth_first_search:{
+				RuntimePierceNodeScoreCutter<Graph, flow_cutter::PseudoDepthFirstSearch>cutter(graph, flow_cutter_config);
+				cutter.init(pairs, flow_cutter_config.random_seed);
+				return enumerate_cut_sizes(cutter, flow_cutter_config.max_cut_size);
+			}
+			case flow_cutter::Config::GraphSearchAlgorithm::breadth_first_search:{
+				RuntimePierceNodeScoreCutter<Graph, flow_cutter::BreadthFirstSearch>cutter(graph, flow_cutter_config);
+				cutter.init(pairs, flow_cutter_config.random_seed);
+				return enumerate_cut_sizes(cutter, flow_cutter_config.max_cut_size);
+			}
+			default:
+				throw std::runtime_error("depth first search is not yet implemented");
+			}
+		},
+		runtime_cuts
+	);
+	long long specialized_time = run(
+		[&]{
+			auto cutter = flow_cutter::make_simple_cutter(graph, flow_cutter_config);
+			cutter.init(pairs, flow_cutter_config.random_seed);
+			return enumerate_cut_sizes(cutter, flow_cutter_config.max_cut_size);
+		},
+		specialized_cuts
+	);
+
+	cout << "                 cut_count : " << specialized_cuts.size() << endl;
+	cout << "    run_time_score [musec] : " << runtime_time << endl;
+	cout << " specialized_score [musec] : " << specialized_time << endl;
+	if(runtime_cuts != specialized_cuts)
+		throw runtime_error("the specialized pierce node score enumerates different cuts");
+}
+
 static
 void keep_nodes_if(const BitIDFunc&node_keep_flag){
 	int new_node_count = count_true(node_keep_flag);
@@ -145,6 +402,30 @@ void permutate_nodes(const ArrayIDIDFunc&p){
 	node_original_position = chain(p, std::move(node_original_position));
 }
 
+//! The flow cutter separator used by the nested dissection commands. If enabled, the current node
+//! colors are the hint that selects the terminals and the node weights measure the balance.
+static
+flow_cutter::ComputeSeparator make_flow_cutter_separator(const flow_cutter::Config&config){
+	std::shared_ptr<const flow_cutter::SeparatorHint>hint;
+	if(use_node_color_as_separator_hint)
+		hint = std::make_shared<flow_cutter::SeparatorHint>(ArrayIDFunc<int>(node_color));
+	std::shared_ptr<const ArrayIDFunc<int>>weight;
+	if(use_node_weight_as_flow_cutter_balance)
+		weight = std::make_shared<ArrayIDFunc<int>>(node_weight);
+	return flow_cutter::ComputeSeparator(config, std::move(hint), std::move(weight));
+}
+
+static
+inertial_flow::InertialFlowSeparator<ArrayIDFunc<GeoPos>> make_inertial_flow_separator(double min_balance){
+	return inertial_flow::ComputeSeparator(
+		node_geo_pos, min_balance, flow_cutter_config.thread_count, 
+		flow_cutter_config.inertial_flow_direction_count,
+		flow_cutter_config.inertial_flow_principal_directions == flow_cutter::Config::InertialFlowPrincipalDirections::yes,
+		flow_cutter_config.inertial_flow_max_flow_algorithm == flow_cutter::Config::InertialFlowMaxFlowAlgorithm::push_relabel ? 
+			inertial_flow::MaxFlowAlgorithm::push_relabel : inertial_flow::MaxFlowAlgorithm::dinic
+	);
+}
+
 static
 void keep_arcs_if(const BitIDFunc&keep_flag){
 	int new_arc_count = count_true(keep_flag);
@@ -346,83 +627,31 @@ vector<Command>cmd = {
 			if(node_count <= 1)
 				throw runtime_error("Graph must have at least 2 nodes");
 
-			int super_graph_arc_count = 0;
-			int current_tail = -1;
-			int current_tail_up_deg = 0;
-			int max_up_deg = 0;
-			ArrayIDFunc<int>
-				out_deg(node_count),
-				parent(node_count);
-			out_deg.fill(0);
-			parent.fill(std::numeric_limits<int>::max());
-			compute_chordal_supergraph(
-				tail, head,
-				[&](int x, int y){
-					++out_deg[x];
-					if(current_tail != x){
-						current_tail = x;
-						max_to(max_up_deg, current_tail_up_deg);
-						current_tail_up_deg = 0;
-					}
-					++super_graph_arc_count;
-					++current_tail_up_deg;
-					min_to(parent[x], y);
-				}
-			);
-
-			ArrayIDFunc<int>ancestor_count(node_count);
-			ancestor_count.fill(-1);
+			const auto&t = get_elimination_tree();
 
-			for(int x=0; x<node_count; ++x){
-				if(ancestor_count(x) == -1){
-					int n = 0;
-					for(int y = x; y != std::numeric_limits<int>::max(); y = parent(y)){
-						if(ancestor_count(y) == -1){
-							++n;
-						}else{
-							n += ancestor_count(y);
-							break;
-						}
-					}
-					for(int y = x; y != std::numeric_limits<int>::max(); y = parent(y)){
-						if(ancestor_count(y) != -1){
-							assert(ancestor_count(y) == n);
-							break;
-						}else{
-							ancestor_count[y] = n;
-							--n;
-						}
-					}
-				}
+			long long super_graph_arc_count = 0;
+			int max_up_deg = 0;
+			long long triangle_count = 0;
+			for(auto d:t.upward_degree){
+				super_graph_arc_count += d;
+				max_to(max_up_deg, d);
+				triangle_count += (static_cast<long long>(d)*(d-1))/2;
 			}
 
 			int max_ancestor_count = 0;
 			long long ancestor_count_sum = 0;
-			for(auto x:ancestor_count){
+			for(auto x:t.depth){
 				max_to(max_ancestor_count, x);
 				ancestor_count_sum += x;
 			}
 
-			ArrayIDFunc<int>arcs_in_search_space = out_deg;
-
-			for(int x=node_count-1; x>=0; --x){
-				if(parent(x) != std::numeric_limits<int>::max()){
-					arcs_in_search_space[x] += arcs_in_search_space(parent(x));
-				}
-			}
-
-			int max_arcs_in_search_space = 0;
+			long long max_arcs_in_search_space = 0;
 			long long arcs_in_search_space_sum = 0;
-			for(auto x:arcs_in_search_space){
+			for(auto x:t.arcs_in_search_space){
 				max_to(max_arcs_in_search_space, x);
 				arcs_in_search_space_sum += x;
 			}
 
-			long long triangle_count = 0;
-			for(int x=0; x<node_count; ++x){
-				triangle_count += (out_deg(x)*(out_deg(x)-1))/2;
-			}
-
 			auto w = setw(35);
 
 			cout
@@ -446,52 +675,15 @@ vector<Command>cmd = {
 			if(node_count <= 1)
 				throw runtime_error("Graph must have at least 2 nodes");
 
-			ArrayIDFunc<int>parent(tail.image_count());
-			parent.fill(std::numeric_limits<int>::max());
-
-			compute_chordal_supergraph(
-				tail, head,
-				[&](int x, int y){
-					min_to(parent[x], y);
-				}
-			);
+			const auto&t = get_elimination_tree();
 
-			ArrayIDFunc<int>ancestor_count(tail.image_count());
-			ancestor_count.fill(-1);
-
-			for(int x=0; x<node_count; ++x){
-				if(ancestor_count(x) == -1){
-					int n = 0;
-					for(int y = x; y != std::numeric_limits<int>::max(); y = parent(y)){
-						if(ancestor_count(y) == -1){
-							++n;
-						}else{
-							n += ancestor_count(y);
-							break;
-						}
-					}
-					for(int y = x; y != std::numeric_limits<int>::max(); y = parent(y)){
-						if(ancestor_count(y) != -1){
-							assert(ancestor_count(y) == n);
-							break;
-						}else{
-							ancestor_count[y] = n;
-							--n;
-						}
-					}
-				}
-			}
-
-			int x = max_preimage_over_id_func(ancestor_count);
+			int x = max_preimage_over_id_func(t.depth);
 
 			BitIDFunc in_tree(node_count);
 			in_tree.fill(false);
 
-			while(parent(x) != std::numeric_limits<int>::max()){
+			for(; x != -1; x = t.parent(x))
 				in_tree.set(x, true);
-				x = parent(x);
-			}
-			in_tree.set(x, true);
 
 			cout << make_id_string(in_tree) << endl;
 		}
@@ -606,7 +798,7 @@ vector<Command>cmd = {
 			while(in.read_row(node_id, color)){
 				if(color < 0)
 					throw runtime_error("invalid color id "+to_string(color));
-				if(color > node_color.image_count())
+				if(color >= node_color.image_count())
 					node_color.set_image_count(color+1);
 				if(node_id < 0 || node_id >= node_color.preimage_count())
 					throw runtime_error("invalid node id "+to_string(node_id));
@@ -873,6 +1065,20 @@ vector<Command>cmd = {
 			arc_color.fill(0);
 		}
 	},
+	{
+		"load_hmetis_hypergraph", 1,
+		"Loads a hypergraph in the hMETIS format. The current graph is not modified.",
+		[](vector<string>args){
+			hypergraph = load_hmetis_hypergraph(args[0]);
+		}
+	},
+	{
+		"load_patoh_hypergraph", 1,
+		"Loads a hypergraph in the PaToH format. The current graph is not modified.",
+		[](vector<string>args){
+			hypergraph = load_patoh_hypergraph(args[0]);
+		}
+	},
 	{
 		"load_pace_tree_decomposition_as_chordal_graph", 1,
 		"Loads tree decomposition in the PACE 2016 format and turns it into a chordal graph with multi arcs.",
@@ -944,6 +1150,60 @@ vector<Command>cmd = {
 			arc_color.fill(0);
 		}
 	},
+	{
+		"benchmark_cch", 2,
+		"Builds a customizable contraction hierarchy using the current node IDs as order, customizes it with the arc weights and runs arg1 random queries. If arg2 is 1 then every query is checked using Dijkstra's algorithm. The customization uses flow_cutter_config.thread_count threads.",
+		[](vector<string>args){
+			if(!is_symmetric(tail, head))
+				throw runtime_error("Graph must be symmetric");
+			const int node_count = tail.image_count();
+			if(node_count == 0)
+				throw runtime_error("Graph must not be empty");
+			int query_count = stoi(args[0]);
+			bool check = stoi(args[1]) != 0;
+
+			long long preprocessing_time = -get_micro_time();
+			cch::ContractionHierarchy ch(tail, head);
+			preprocessing_time += get_micro_time();
+
+			long long customization_time = -get_micro_time();
+			ch.customize(arc_weight, flow_cutter_config.thread_count);
+			customization_time += get_micro_time();
+
+			std::mt19937 rng(flow_cutter_config.random_seed);
+			std::uniform_int_distribution<int>dist(0, node_count-1);
+			std::vector<int>source(query_count), target(query_count), result(query_count);
+			for(int i=0; i<query_count; ++i){
+				source[i] = dist(rng);
+				target[i] = dist(rng);
+			}
+
+			long long query_time = -get_micro_time();
+			for(int i=0; i<query_count; ++i)
+				result[i] = ch.query(source[i], target[i]);
+			query_time += get_micro_time();
+
+			cout << "              cch_arc_count : " << ch.arc_count() << endl;
+			cout << "                level_count : " << ch.level_count() << endl;
+			cout << " preprocessing_time [musec] : " << preprocessing_time << endl;
+			cout << " customization_time [musec] : " << customization_time << endl;
+			if(query_count != 0)
+				cout << " average query_time [musec] : " << (double)query_time/query_count << endl;
+
+			if(check){
+				auto out_arc = invert_id_id_func(tail);
+				int wrong_count = 0;
+				for(int i=0; i<query_count; ++i){
+					auto d = compute_distances(out_arc, head, arc_weight, source[i]);
+					if(d(target[i]) != result[i])
+						++wrong_count;
+				}
+				cout << "          wrong_query_count : " << wrong_count << endl;
+				if(wrong_count != 0)
+					throw runtime_error("CCH query results differ from Dijkstra");
+			}
+		}
+	},
 	{
 		"compute_chordal_supergraph",
 		"Computes the chordal supergraph and replaces the current graph.",
@@ -1542,6 +1802,21 @@ vector<Command>cmd = {
 				<< w << "arc_color_count" << " : " << arc_color.image_count() << endl;
 		}
 	},
+	{
+		"hypergraph_stats",
+		"Prints basic stats about the current hypergraph",
+		[]{
+			int max_net_size = 0;
+			auto net_pin = invert_sorted_id_id_func(hypergraph.pin_net);
+			for(int i=0; i<hypergraph.net_count(); ++i)
+				max_to(max_net_size, *std::end(net_pin(i)) - *std::begin(net_pin(i)));
+			cout
+				<< w << "node_count" << " : " << hypergraph.node_count() << endl
+				<< w << "net_count" << " : " << hypergraph.net_count() << endl
+				<< w << "pin_count" << " : " << hypergraph.pin_count() << endl
+				<< w << "max_net_size" << " : " << max_net_size << endl;
+		}
+	},
 	{
 		"reverse",
 		"Reverses all arcs",
@@ -2182,29 +2457,41 @@ vector<Command>cmd = {
 			flow_cutter_config.set(args[0], args[1]);
 		}
 	},
+	{
+		"use_node_color_as_flow_cutter_separator_hint",
+		"The flow cutter nested dissection commands start every separator computation from the nodes of the most frequent node color of the subgraph that lie farthest from the other colors as sources and from those of the second most frequent color as targets. The colors are read when the nested dissection command runs and can, for example, be the partition of a previous run. Subgraphs in which the second most frequent color covers less than terminal_set_fraction of the nodes are cut as without colors.",
+		[]{
+			use_node_color_as_separator_hint = true;
+		}
+	},
+	{
+		"do_not_use_node_color_as_flow_cutter_separator_hint",
+		"The flow cutter nested dissection commands select random terminals",
+		[]{
+			use_node_color_as_separator_hint = false;
+		}
+	},
+	{
+		"use_node_weight_as_flow_cutter_balance",
+		"The flow cutter nested dissection commands and hypergraph_flow_cutter_enum_cuts measure the balance of a cut, including max_imbalance, in node weight instead of node count. This is meant for graphs whose nodes represent different amounts of work, such as graphs with contracted chains. The node weights must be positive.",
+		[]{
+			use_node_weight_as_flow_cutter_balance = true;
+		}
+	},
+	{
+		"do_not_use_node_weight_as_flow_cutter_balance",
+		"The flow cutter measures the balance in node count",
+		[]{
+			use_node_weight_as_flow_cutter_balance = false;
+		}
+	},
 	{
 		"flow_cutter_enum_cuts", 1,
-		"Enumerates balanced cuts.",
+		"Enumerates balanced cuts. If compiled with FLOW_CUTTER_INSTRUMENTATION, every line also contains the work counters summed over all cutter instances and the counters of every instance are printed at the end.",
 		[](vector<string>args){
-			int node_count = tail.image_count();
 			int arc_count = tail.preimage_count();
 
-			if(!is_sorted(tail.begin(), tail.end()))
-				throw runtime_error("arc tails must be sorted");
-			if(!is_symmetric(tail, head))
-				throw runtime_error("graph must be symmetric");
-			if(!is_connected(tail, head))
-				throw runtime_error("graph must be connected");
-			if(flow_cutter_config.source < -1 || flow_cutter_config.source >= node_count)
-				throw std::runtime_error("source node ID out of bounds");
-			if(flow_cutter_config.target < -1 || flow_cutter_config.target >= node_count)
-				throw std::runtime_error("target node ID out of bounds");
-
-			if(flow_cutter::requires_non_negative_weights(flow_cutter_config)){
-				for(int i=0; i<arc_count; ++i)
-					if(arc_weight(i) < 0)
-						throw std::runtime_error("arc weights must be non-negative");
-			}
+			check_cut_enumeration_input();
 
 			auto out_arc = invert_sorted_id_id_func(tail);
 			auto back_arc = compute_back_arc_permutation(tail, head);
@@ -2235,60 +2522,206 @@ vector<Command>cmd = {
 						out << ", cut";
 					if(flow_cutter_config.dump_state == flow_cutter::Config::DumpState::yes)
 						out << ", source_assimilated, target_assimilated, source_reachable, target_reachable, flow";
+					out << flow_cutter::instrumentation::get_csv_header();
 					out << endl;
 
 
 					long long start_time = get_micro_time();
 
 					auto cutter = flow_cutter::make_simple_cutter(graph, flow_cutter_config);
+					auto pairs = select_cut_enumeration_source_target_pairs();
 
-					std::vector<flow_cutter::SourceTargetPair>pairs;
-					if(flow_cutter_config.source != -1 && flow_cutter_config.target != -1){
-						for(int i=0; i<flow_cutter_config.cutter_count; ++i)
-							pairs.push_back({flow_cutter_config.source, flow_cutter_config.target});
-					}else if(flow_cutter_config.source != -1 || flow_cutter_config.target != -1){
-						pairs = flow_cutter::select_random_source_target_pairs(node_count, flow_cutter_config.cutter_count, flow_cutter_config.random_seed);
-						if(flow_cutter_config.source != -1){
-							for(auto&x:pairs){
-								if(x.target == flow_cutter_config.source)
-									x.target = x.source;
-								x.source = flow_cutter_config.source;
-							}
-						}else{
-							for(auto&x:pairs){
-								if(x.source == flow_cutter_config.target)
-									x.source = x.target;
-								x.target = flow_cutter_config.target;
+					cutter.init(pairs, flow_cutter_config.random_seed);
+					flow_cutter::forall_cuts(
+						cutter, flow_cutter_config.max_cut_size,
+						[&](const decltype(cutter)&cutter){
+							out
+								<< w << (get_micro_time() - start_time) << ','
+								<< w << cutter.get_current_cutter_id() << ','
+								<< w << pairs[cutter.get_current_cutter_id()].source << ','
+								<< w << pairs[cutter.get_current_cutter_id()].target << ','
+								<< w << cutter.get_current_smaller_cut_side_size() << ','
+								<< w << tail.image_count() - cutter.get_current_smaller_cut_side_size() << ','
+								<< w << cutter.get_current_cut().size();
+							if(flow_cutter_config.report_cuts == flow_cutter::Config::ReportCuts::yes)
+								out << ", " << make_id_string_from_list_with_back_arcs(cutter.get_current_cut(), back_arc);
+
+							if(flow_cutter_config.dump_state == flow_cutter::Config::DumpState::yes){
+								auto dump = cutter.dump_state();
+								out << ','
+									<< ' ' << make_id_string(dump.source_assimilated) << ','
+									<< ' ' << make_id_string(dump.target_assimilated) << ','
+									<< ' ' << make_id_string(dump.source_reachable) << ','
+									<< ' ' << make_id_string(dump.target_reachable) << ','
+									<< ' ' << make_id_string(dump.flow);
 							}
+							out << flow_cutter::instrumentation::get_csv_row(cutter.get_instrumentation_counters());
+							out << endl;
+							return true;
 						}
-					}else{
-						pairs = flow_cutter::select_random_source_target_pairs(node_count, flow_cutter_config.cutter_count, flow_cutter_config.random_seed);
+					);
+
+					if(flow_cutter::instrumentation::is_enabled){
+						auto counters = cutter.get_instrumentation_counters_of_every_cutter();
+						for(int i=0; i<(int)counters.size(); ++i)
+							cout << "cutter " << i << " : " << counters[i].wall_time_musec << "musec, " << counters[i].advance_count << " advances, " << counters[i].augmenting_path_count << " augmenting paths" << endl;
 					}
+				}
+			);
+		}
+	},
+	{
+		"benchmark_pierce_node_score", 1,
+		"Enumerates the cuts of flow_cutter_enum_cuts arg1 times using a pierce node score that evaluates the pierce rating and avoid_augmenting_path of the config for every candidate and arg1 times using the score of SimpleCutter, which is specialized at compile time for the default rating and avoid policy or for all of them if compiled with FLOW_CUTTER_SPECIALIZE_EVERY_PIERCE_RATING. Reports the fastest time of both and checks that they enumerate the same cuts.",
+		[](vector<string>args){
+			int arc_count = tail.preimage_count();
+			int repetition_count = stoi(args[0]);
+			if(repetition_count <= 0)
+				throw runtime_error("repetition count must be positive");
 
-					cutter.init(pairs, flow_cutter_config.random_seed);
-					do{
-						out
-							<< w << (get_micro_time() - start_time) << ','
-							<< w << cutter.get_current_cutter_id() << ','
-							<< w << pairs[cutter.get_current_cutter_id()].source << ','
-							<< w << pairs[cutter.get_current_cutter_id()].target << ','
-							<< w << cutter.get_current_smaller_cut_side_size() << ','
-							<< w << tail.image_count() - cutter.get_current_smaller_cut_side_size() << ','
-							<< w << cutter.get_current_cut().size();
-						if(flow_cutter_config.report_cuts == flow_cutter::Config::ReportCuts::yes)
-							out << ", " << make_id_string_from_list_with_back_arcs(cutter.get_current_cut(), back_arc);
-
-						if(flow_cutter_config.dump_state == flow_cutter::Config::DumpState::yes){
-							auto dump = cutter.dump_state();
-							out << ','
-								<< ' ' << make_id_string(dump.source_assimilated) << ','
-								<< ' ' << make_id_string(dump.target_assimilated) << ','
-								<< ' ' << make_id_string(dump.source_reachable) << ','
-								<< ' ' << make_id_string(dump.target_reachable) << ','
-								<< ' ' << make_id_string(dump.flow);
+			check_cut_enumeration_input();
+
+			auto out_arc = invert_sorted_id_id_func(tail);
+			auto back_arc = compute_back_arc_permutation(tail, head);
+
+			auto graph = flow_cutter::make_graph(
+				make_const_ref_id_id_func(tail),
+				make_const_ref_id_id_func(head),
+				make_const_ref_id_id_func(back_arc),
+				make_const_ref_id_func(arc_weight),
+				ConstIntIDFunc<1>(arc_count), // capacity
+				make_const_ref_id_func(out_arc)
+			);
+
+			benchmark_pierce_node_score(graph, repetition_count);
+		}
+	},
+	{
+		"flow_cutter_enum_pareto_cuts_binary", 1,
+		"Enumerates the Pareto front of cut size and balance and saves it in the binary cut list format to arg1. The cut arcs are delta encoded.",
+		[](vector<string>args){
+			int node_count = tail.image_count();
+			int arc_count = tail.preimage_count();
+
+			check_cut_enumeration_input();
+
+			auto out_arc = invert_sorted_id_id_func(tail);
+			auto back_arc = compute_back_arc_permutation(tail, head);
+
+			auto graph = flow_cutter::make_graph(
+				make_const_ref_id_id_func(tail),
+				make_const_ref_id_id_func(head),
+				make_const_ref_id_id_func(back_arc),
+				make_const_ref_id_func(arc_weight),
+				ConstIntIDFunc<1>(arc_count), // capacity
+				make_const_ref_id_func(out_arc)
+			);
+
+			std::ofstream out(args[0], std::ios::binary);
+			if(!out)
+				throw runtime_error("Could not open "+args[0]+" for binary writing");
+
+			auto cutter = flow_cutter::make_simple_cutter(graph, flow_cutter_config);
+			cutter.init(select_cut_enumeration_source_target_pairs(), flow_cutter_config.random_seed);
+
+			flow_cutter::binary_cut_list::Writer writer(out, node_count, arc_count);
+			flow_cutter::forall_pareto_cuts(
+				cutter, flow_cutter_config.max_cut_size,
+				[&](int cutter_id, int smaller_side_size, const std::vector<int>&cut){
+					writer.write(cutter_id, smaller_side_size, cut);
+					return true;
+				}
+			);
+		}
+	},
+	{
+		"convert_binary_cut_list_to_csv", 2,
+		"Reads a binary cut list from arg1 and saves it as CSV to arg2.",
+		[](vector<string>args){
+			std::ifstream in(args[0], std::ios::binary);
+			if(!in)
+				throw runtime_error("Could not open "+args[0]+" for binary reading");
+			save_text_file(
+				args[1],
+				[&](std::ostream&out){
+					out << "cutter_instance,small_side_size,cut_size,cut\n";
+					flow_cutter::binary_cut_list::read(
+						in,
+						[&](int cutter_id, int smaller_side_size, const std::vector<int>&cut){
+							out << cutter_id << ',' << smaller_side_size << ',' << cut.size() << ',' << make_id_string_from_list(cut) << '\n';
 						}
-						out << endl;
-					}while((int)cutter.get_current_cut().size() < flow_cutter_config.max_cut_size && cutter.advance());
+					);
+				}
+			);
+		}
+	},
+	{
+		"flow_cutter_portfolio", 2,
+		"Runs several flow cutter configs concurrently and saves the merged Pareto front of cut size and balance to arg2. arg1 is a file with one config per line given as variable value pairs applied to the current config, or \"default\" for a built-in set. The configs run in flow_cutter_config.thread_count threads.",
+		[](vector<string>args){
+			int node_count = tail.image_count();
+			int arc_count = tail.preimage_count();
+
+			if(!is_sorted(tail.begin(), tail.end()))
+				throw runtime_error("arc tails must be sorted");
+			if(!is_symmetric(tail, head))
+				throw runtime_error("graph must be symmetric");
+			if(!is_connected(tail, head))
+				throw runtime_error("graph must be connected");
+
+			std::vector<flow_cutter::Config>configs;
+			if(args[0] == "default"){
+				configs = portfolio::make_default_config_list(flow_cutter_config);
+			}else{
+				std::ifstream in(args[0]);
+				if(!in)
+					throw runtime_error("Could not open "+args[0]);
+				std::stringstream text;
+				text << in.rdbuf();
+				configs = portfolio::parse_config_list(text.str(), flow_cutter_config);
+			}
+			if(configs.empty())
+				throw runtime_error("The portfolio has no configs");
+
+			for(auto&config:configs){
+				if(flow_cutter::requires_non_negative_weights(config)){
+					for(int i=0; i<arc_count; ++i)
+						if(arc_weight(i) < 0)
+							throw std::runtime_error("arc weights must be non-negative");
+				}
+			}
+
+			auto out_arc = invert_sorted_id_id_func(tail);
+			auto back_arc = compute_back_arc_permutation(tail, head);
+
+			auto graph = flow_cutter::make_graph(
+				make_const_ref_id_id_func(tail),
+				make_const_ref_id_id_func(head),
+				make_const_ref_id_id_func(back_arc),
+				make_const_ref_id_func(arc_weight),
+				ConstIntIDFunc<1>(arc_count), // capacity
+				make_const_ref_id_func(out_arc)
+			);
+
+			std::vector<portfolio::RunStatistic>stat;
+			auto front = portfolio::run(graph, configs, flow_cutter_config.max_cut_size, flow_cutter_config.thread_count, &stat);
+
+			for(int i=0; i<(int)configs.size(); ++i)
+				cout << "config " << i << " : " << stat[i].cut_count << " cuts in " << stat[i].running_time << "musec" << (stat[i].was_stopped_early ? ", stopped because dominated" : "") << endl;
+
+			save_text_file(
+				args[1],
+				[&](std::ostream&out){
+					out << "config_id,small_side_size,large_side_size,cut_size";
+					if(flow_cutter_config.report_cuts == flow_cutter::Config::ReportCuts::yes)
+						out << ",cut";
+					out << '\n';
+					for(auto&c:front){
+						out << c.config_id << ',' << c.smaller_side_size << ',' << node_count - c.smaller_side_size << ',' << c.cut_size;
+						if(flow_cutter_config.report_cuts == flow_cutter::Config::ReportCuts::yes)
+							out << ',' << make_id_string_from_list_with_back_arcs(c.cut, back_arc);
+						out << '\n';
+					}
 				}
 			);
 		}
@@ -2371,29 +2804,130 @@ vector<Command>cmd = {
 					}
 
 					cutter.init(flow_cutter::expanded_graph::expand_source_target_pair_list(pairs), flow_cutter_config.random_seed);
-					do{
-						auto sep = flow_cutter::expanded_graph::extract_original_separator(tail, head, cutter);
-
-						out
-							<< w << (get_micro_time() - start_time) << ','
-							<< w << cutter.get_current_cutter_id() << ','
-							<< w << pairs[cutter.get_current_cutter_id()].source << ','
-							<< w << pairs[cutter.get_current_cutter_id()].target << ','
-							<< w << sep.small_side_size << ','
-							<< w << (tail.image_count() - sep.small_side_size - cutter.get_current_cut().size()) << ','
-							<< w << sep.sep.size() << ','
-							<< w << cutter.get_current_cut().size();
-						if(flow_cutter_config.report_cuts == flow_cutter::Config::ReportCuts::yes)
+					flow_cutter::forall_cuts(
+						cutter, flow_cutter_config.max_cut_size,
+						[&](const decltype(cutter)&cutter){
+							auto sep = flow_cutter::expanded_graph::extract_original_separator(tail, head, cutter);
+
 							out
-								<< ", "
-								<< make_id_string_from_list(sep.sep);
-						out << endl;
-					}while((int)cutter.get_current_cut().size() < flow_cutter_config.max_cut_size && cutter.advance());
+								<< w << (get_micro_time() - start_time) << ','
+								<< w << cutter.get_current_cutter_id() << ','
+								<< w << pairs[cutter.get_current_cutter_id()].source << ','
+								<< w << pairs[cutter.get_current_cutter_id()].target << ','
+								<< w << sep.small_side_size << ','
+								<< w << (tail.image_count() - sep.small_side_size - cutter.get_current_cut().size()) << ','
+								<< w << sep.sep.size() << ','
+								<< w << cutter.get_current_cut().size();
+							if(flow_cutter_config.report_cuts == flow_cutter::Config::ReportCuts::yes)
+								out
+									<< ", "
+									<< make_id_string_from_list(sep.sep);
+							out << endl;
+							return true;
+						}
+					);
 				}
 			);
 		}
 	},
 
+	{
+		"hypergraph_flow_cutter_enum_cuts", 1,
+		"Enumerates balanced net cuts of the current hypergraph using the flow cutter on its Lawler expansion, whose size is linear in the pin count. The side sizes count hypernodes or, if use_node_weight_as_flow_cutter_balance is set, sum their weights. The cut size is the number of cut nets.",
+		[](vector<string>args){
+			int node_count = hypergraph.node_count();
+
+			if(node_count < 2)
+				throw runtime_error("hypergraph must have at least two nodes");
+			if(flow_cutter_config.source < -1 || flow_cutter_config.source >= node_count)
+				throw std::runtime_error("source node ID out of bounds");
+			if(flow_cutter_config.target < -1 || flow_cutter_config.target >= node_count)
+				throw std::runtime_error("target node ID out of bounds");
+
+			ArrayIDFunc<int>hypernode_weight(node_count);
+			if(use_node_weight_as_flow_cutter_balance){
+				hypernode_weight = hypergraph.node_weight;
+				for(int x=0; x<node_count; ++x)
+					if(hypernode_weight(x) <= 0)
+						throw runtime_error("node weights must be positive");
+			}else
+				hypernode_weight.fill(1);
+
+			auto node_pin = invert_id_id_func(hypergraph.pin_node);
+			auto net_pin = invert_sorted_id_id_func(hypergraph.pin_net);
+
+			auto graph = flow_cutter::lawler_expansion::make_graph(
+				make_const_ref_id_id_func(hypergraph.pin_net),
+				make_const_ref_id_id_func(hypergraph.pin_node),
+				make_const_ref_id_func(node_pin),
+				make_const_ref_id_func(net_pin),
+				make_const_ref_id_func(hypernode_weight)
+			);
+
+			if(!is_connected(graph.tail, graph.head))
+				throw runtime_error("hypergraph must be connected and every net must have a pin");
+
+			save_text_file(
+				args[0],
+				[&](std::ostream&out){
+					auto w = std::setw(8);
+					out
+						<< w << "time" << ','
+						<< w << "cutter_instance" << ','
+						<< w << "source_node" << ','
+						<< w << "target_node" << ','
+						<< w << "small_side_size" << ','
+						<< w << "large_side_size" << ','
+						<< w << "cut_size" << ','
+						<< w << "flow";
+					if(flow_cutter_config.report_cuts == flow_cutter::Config::ReportCuts::yes)
+						out << ", cut";
+					out << endl;
+
+					long long start_time = get_micro_time();
+
+					auto cutter = flow_cutter::make_simple_cutter(graph, flow_cutter_config);
+					auto pairs = flow_cutter::select_random_source_target_pairs(node_count, flow_cutter_config.cutter_count, flow_cutter_config.random_seed);
+					if(flow_cutter_config.source != -1 || flow_cutter_config.target != -1){
+						for(auto&x:pairs){
+							if(flow_cutter_config.source != -1){
+								if(x.target == flow_cutter_config.source)
+									x.target = x.source;
+								x.source = flow_cutter_config.source;
+							}
+							if(flow_cutter_config.target != -1){
+								if(x.source == flow_cutter_config.target)
+									x.source = x.target;
+								x.target = flow_cutter_config.target;
+							}
+						}
+					}
+
+					cutter.init(pairs, flow_cutter_config.random_seed);
+					flow_cutter::forall_cuts(
+						cutter, flow_cutter_config.max_cut_size,
+						[&](const decltype(cutter)&cutter){
+							auto net_cut = flow_cutter::lawler_expansion::expanded_cut_to_net_cut(cutter.get_current_cut(), hypergraph.pin_net);
+
+							out
+								<< w << (get_micro_time() - start_time) << ','
+								<< w << cutter.get_current_cutter_id() << ','
+								<< w << pairs[cutter.get_current_cutter_id()].source << ','
+								<< w << pairs[cutter.get_current_cutter_id()].target << ','
+								<< w << cutter.get_current_smaller_cut_side_size() << ','
+								<< w << graph.total_node_weight() - cutter.get_current_smaller_cut_side_size() << ','
+								<< w << net_cut.size() << ','
+								<< w << cutter.get_current_cut().size();
+							if(flow_cutter_config.report_cuts == flow_cutter::Config::ReportCuts::yes)
+								out << ", " << make_id_string_from_list(net_cut);
+							out << endl;
+							return true;
+						}
+					);
+				}
+			);
+		}
+	},
 	{
 		"flow_cutter_expand_graph",
 		"Expands the currently loaded graph.",
@@ -2571,6 +3105,48 @@ vector<Command>cmd = {
 				throw std::runtime_error("pseudo depth first search is erronous");
 		}
 	},
+	{
+		"speed_test_max_flow", 1,
+		"Compares the running times of the max flow algorithms. The sources and targets are the nodes with the smallest and largest longitudes as in inertial flow. The argument is the fraction of nodes in each of the two sets, a value between 0.0 and 0.5.",
+		[](vector<string>args){
+			if(!is_symmetric(tail, head))
+				throw runtime_error("Graph must be symmetric");
+			if(node_geo_pos.preimage_count() != tail.image_count())
+				throw runtime_error("Graph must have geo positions");
+			double min_balance = stof(args[0]);
+			if(min_balance < 0 || min_balance > 0.5)
+				throw runtime_error("min balance parameter must be between 0.0 and 0.5");
+
+			const int node_count = tail.image_count();
+			auto inv_tail = invert_id_id_func(tail);
+			auto back_arc = compute_back_arc_permutation(tail, head);
+
+			ArrayIDIDFunc source_list, target_list;
+			inertial_flow::build_source_and_target_list(
+				node_count, min_balance, 
+				inertial_flow::project_geo_pos(node_geo_pos, inertial_flow::Direction{1.0, 0.0}), 
+				source_list, target_list
+			);
+
+			int expected_cut_size = -1;
+			auto run = [&](const string&name, const function<BitIDFunc()>&compute_flow){
+				long long time = -get_micro_time();
+				auto flow = compute_flow();
+				time += get_micro_time();
+				auto cut = inertial_flow::extract_cut_from_maximum_unit_flow(inv_tail, head, flow, source_list);
+				cout << setw(30) << name << " : " << setw(10) << time << "musec, cut size " << cut.cut_size << endl;
+				if(expected_cut_size == -1)
+					expected_cut_size = cut.cut_size;
+				else if(expected_cut_size != cut.cut_size)
+					throw runtime_error("max flow algorithms disagree on the flow intensity");
+			};
+
+			run("dinic", [&]{return max_flow::compute_maximum_unit_flow_using_dinic(inv_tail, head, back_arc, source_list, target_list);});
+			run("push_relabel", [&]{return max_flow::compute_maximum_unit_flow_using_push_relabel(inv_tail, head, back_arc, source_list, target_list);});
+			run("parallel_push_relabel", [&]{return max_flow::compute_maximum_unit_flow_using_parallel_push_relabel(inv_tail, head, back_arc, source_list, target_list, flow_cutter_config.thread_count);});
+			run("edmond_karp", [&]{return max_flow::compute_maximum_unit_flow_using_edmond_karp(inv_tail, head, back_arc, source_list, target_list);});
+		}
+	},
 	{
 		"is_symmetric",
 		"Checks whether a graph is symmetric",
@@ -2777,35 +3353,30 @@ vector<Command>cmd = {
 		"karger_cut", 1,
 		"Runs one round of Karger's random cut algorithm. The argument is the random seed.",
 		[](vector<string>args){
-			const int node_count = tail.image_count();
-			const int arc_count = tail.preimage_count();
-
-
-			ArrayIDIDFunc arc_order = identity_permutation(arc_count);
-			{
-				minstd_rand rand_gen;
-				rand_gen.seed(stoi(args[0]));
-				shuffle(arc_order.begin(), arc_order.end(), rand_gen);
-			}
-
-			UnionFind uf(node_count);
-			for(auto a:arc_order){
-				uf.unite(tail(a), head(a));
-				cout << uf.component_count() << " " << uf.component_size(uf(0)) << endl;
-
-				if(uf.component_count() == 2)
-					break;
-			}
-			int color_0_node = uf(0);
-
-			node_color.set_image_count(2);
-			for(int i=0; i<node_count; ++i){
-				if(uf(i) == color_0_node){
-					node_color[i] = 0;
-				}else{
-					node_color[i] = 1;
-				}
-			}
+			auto cut = karger::compute_karger_cut(tail, head, 1, stoi(args[0]), false);
+			cout << "cut_arc_count : " << cut.arc_count << endl;
+			node_color = ArrayIDIDFunc(tail.image_count(), 2);
+			for(int x=0; x<tail.image_count(); ++x)
+				node_color[x] = cut.side(x);
+		}
+	},
+	{
+		"karger_stein_cut", 2,
+		"Runs the recursive contraction algorithm of Karger and Stein. arg1 is the number of trials, arg2 is the random seed. The trials run in parallel using flow_cutter_config.thread_count threads. The best cut is stored as node color.",
+		[](vector<string>args){
+			int trial_count = stoi(args[0]);
+			if(trial_count < 1)
+				throw runtime_error("There must be at least one trial");
+			auto cut = karger::compute_karger_cut(tail, head, trial_count, stoi(args[1]), true, flow_cutter_config.thread_count);
+			int side_size = 0;
+			for(int x=0; x<tail.image_count(); ++x)
+				if(cut.side(x))
+					++side_size;
+			cout << "cut_arc_count : " << cut.arc_count << endl;
+			cout << "smaller_side_size : " << std::min(side_size, tail.image_count()-side_size) << endl;
+			node_color = ArrayIDIDFunc(tail.image_count(), 2);
+			for(int x=0; x<tail.image_count(); ++x)
+				node_color[x] = cut.side(x);
 		}
 	},
 	{
@@ -2823,7 +3394,7 @@ vector<Command>cmd = {
 			double min_balance = stof(args[0]);
 			if(min_balance < 0 || min_balance > 0.5)
 				throw runtime_error("min balance parameter must be between 0.0 and 0.5");
-			auto c = inertial_flow::compute_inertial_flow_cut(tail, head, node_geo_pos, min_balance);
+			auto c = inertial_flow::compute_inertial_flow_cut(tail, head, node_geo_pos, min_balance, flow_cutter_config.inertial_flow_direction_count, flow_cutter_config.thread_count);
 			node_color.set_image_count(2);
 			for(int i=0; i<node_count; ++i)
 				node_color[i] = c.is_on_smaller_side(i);
@@ -2845,7 +3416,7 @@ vector<Command>cmd = {
 			double min_balance = stof(args[0]);
 			if(min_balance < 0 || min_balance > 0.5)
 				throw runtime_error("min balance parameter must be between 0.0 and 0.5");
-			cout << make_id_string_from_list(inertial_flow::compute_inertial_flow_separator(tail, head, node_geo_pos, min_balance)) << endl;
+			cout << make_id_string_from_list(make_inertial_flow_separator(min_balance)(tail, head, id_id_func(tail.image_count(), tail.image_count(), [](int x){return x;}), arc_weight)) << endl;
 		}
 	},
 
@@ -2911,7 +3482,7 @@ vector<Command>cmd = {
 			if(min_balance < 0 || min_balance > 0.5)
 				throw runtime_error("min balance parameter must be between 0.0 and 0.5");
 
-			permutate_nodes(cch_order::compute_nested_dissection_graph_order(tail, head, arc_weight, inertial_flow::ComputeSeparator(node_geo_pos, min_balance)));
+			permutate_nodes(cch_order::compute_nested_dissection_graph_order(tail, head, arc_weight, make_inertial_flow_separator(min_balance)));
 		}
 	},
 #ifdef USE_KAHIP
@@ -3118,6 +3689,97 @@ vector<Command>cmd = {
 		}
 	},
 #endif
+	{
+		"reorder_nodes_in_multilevel_nested_dissection_order", 1,
+		"Reorders all nodes in nested dissection order using the multilevel separator. epsilon is arg1",
+		[](vector<string>args){
+			if(!is_symmetric(tail, head))
+				throw runtime_error("Graph must be symmetric");
+			if(has_multi_arcs(tail, head))
+				throw runtime_error("Graph must not have multi arcs");
+			if(!is_loop_free(tail, head))
+				throw runtime_error("Graph must not have loops");
+			double epsilon = stof(args[0]);
+			if(epsilon < 0 || epsilon > 1)
+				throw runtime_error("epsilon parameter must be between 0.0 and 1.0");
+
+			permutate_nodes(cch_order::compute_nested_dissection_graph_order(tail, head, arc_weight, multilevel::ComputeSeparator(epsilon, flow_cutter_config.random_seed)));
+		}
+	},
+	{
+		"reorder_nodes_in_multilevel_nested_dissection_order_with_separator_stats", 2,
+		"Reorders all nodes in nested dissection order using the multilevel separator. epsilon is arg1 and the separator stats are in arg2",
+		[](vector<string>args){
+			if(!is_symmetric(tail, head))
+				throw runtime_error("Graph must be symmetric");
+			if(has_multi_arcs(tail, head))
+				throw runtime_error("Graph must not have multi arcs");
+			if(!is_loop_free(tail, head))
+				throw runtime_error("Graph must not have loops");
+			double epsilon = stof(args[0]);
+			if(epsilon < 0 || epsilon > 1)
+				throw runtime_error("epsilon parameter must be between 0.0 and 1.0");
+
+			save_text_file(args[1],
+				[&](std::ostream&out){
+					permutate_nodes(
+						cch_order::compute_nested_dissection_graph_order(
+							tail, head, arc_weight,
+							separator::report_separator_statistics(out, multilevel::ComputeSeparator(epsilon, flow_cutter_config.random_seed))
+						)
+					);
+				}
+			);
+		}
+	},
+	{
+		"reorder_nodes_in_multilevel_cch_order", 1,
+		"Reorders all nodes in CCH order using the multilevel separator. epsilon is arg1",
+		[](vector<string>args){
+			if(!is_symmetric(tail, head))
+				throw runtime_error("Graph must be symmetric");
+			if(has_multi_arcs(tail, head))
+				throw runtime_error("Graph must not have multi arcs");
+			if(!is_loop_free(tail, head))
+				throw runtime_error("Graph must not have loops");
+			double epsilon = stof(args[0]);
+			if(epsilon < 0 || epsilon > 1)
+				throw runtime_error("epsilon parameter must be between 0.0 and 1.0");
+
+			permutate_nodes(
+				cch_order::compute_cch_graph_order(
+					tail, head, arc_weight,
+					multilevel::ComputeSeparator(epsilon, flow_cutter_config.random_seed)
+				)
+			);
+		}
+	},
+	{
+		"reorder_nodes_in_multilevel_cch_order_with_separator_stats", 2,
+		"Reorders all nodes in CCH order using the multilevel separator. epsilon is arg1 and the separator stats are in arg2",
+		[](vector<string>args){
+			if(!is_symmetric(tail, head))
+				throw runtime_error("Graph must be symmetric");
+			if(has_multi_arcs(tail, head))
+				throw runtime_error("Graph must not have multi arcs");
+			if(!is_loop_free(tail, head))
+				throw runtime_error("Graph must not have loops");
+			double epsilon = stof(args[0]);
+			if(epsilon < 0 || epsilon > 1)
+				throw runtime_error("epsilon parameter must be between 0.0 and 1.0");
+
+			save_text_file(args[1],
+				[&](std::ostream&out){
+					permutate_nodes(
+						cch_order::compute_cch_graph_order(
+							tail, head, arc_weight,
+							separator::report_separator_statistics(out, multilevel::ComputeSeparator(epsilon, flow_cutter_config.random_seed))
+						)
+					);
+				}
+			);
+		}
+	},
 	{
 		"reorder_nodes_in_inertial_flow_cch_order", 1,
 		"Reorders all nodes in nested dissection order. min_balance is arg1",
@@ -3132,7 +3794,7 @@ vector<Command>cmd = {
 			if(min_balance < 0 || min_balance > 0.5)
 				throw runtime_error("min balance parameter must be between 0.0 and 0.5");
 
-			permutate_nodes(cch_order::compute_cch_graph_order(tail, head, arc_weight, inertial_flow::ComputeSeparator(node_geo_pos, min_balance)));
+			permutate_nodes(cch_order::compute_cch_graph_order(tail, head, arc_weight, make_inertial_flow_separator(min_balance)));
 		}
 	},
 	{
@@ -3562,7 +4224,7 @@ vector<Command>cmd = {
 			if(min_balance < 0 || min_balance > 0.5)
 				throw runtime_error("min balance parameter must be between 0.0 and 0.5");
 
-			permutate_nodes(cch_order::compute_nested_dissection_graph_order(tail, head, arc_weight, inertial_flow::ComputeSeparator(node_geo_pos, min_balance)));
+			permutate_nodes(cch_order::compute_nested_dissection_graph_order(tail, head, arc_weight, make_inertial_flow_separator(min_balance)));
 		}
 	},
 	{
@@ -3588,7 +4250,7 @@ vector<Command>cmd = {
 							tail, head, arc_weight,
 							separator::report_separator_statistics(
 								out,
-								inertial_flow::ComputeSeparator(node_geo_pos, min_balance)
+								make_inertial_flow_separator(min_balance)
 							)
 						)
 					);
@@ -3610,7 +4272,7 @@ vector<Command>cmd = {
 			if(min_balance < 0 || min_balance > 0.5)
 				throw runtime_error("min balance parameter must be between 0.0 and 0.5");
 
-			permutate_nodes(cch_order::compute_cch_graph_order(tail, head, arc_weight, inertial_flow::ComputeSeparator(node_geo_pos, min_balance)));
+			permutate_nodes(cch_order::compute_cch_graph_order(tail, head, arc_weight, make_inertial_flow_separator(min_balance)));
 		}
 	},
 	{
@@ -3636,7 +4298,7 @@ vector<Command>cmd = {
 							tail, head, arc_weight,
 							separator::report_separator_statistics(
 								out,
-								inertial_flow::ComputeSeparator(node_geo_pos, min_balance)
+								make_inertial_flow_separator(min_balance)
 							)
 						)
 					);
@@ -3663,6 +4325,72 @@ vector<Command>cmd = {
 			);
 		}
 	},
+	{
+		"anytime_pace_tree_decomposition", 2,
+		"Searches for a tree decomposition of small width until arg2 seconds passed or SIGTERM is received. Then the best decomposition found is written in the PACE 2016 format to arg1 and the program terminates. A time limit of 0 means that only SIGTERM stops the search. The search runs flow_cutter_config.thread_count small tree width orderings with different seeds and configs in parallel. The node IDs are the input node IDs.",
+		[](vector<string>args){
+			if(!is_symmetric(tail, head))
+				throw runtime_error("Graph must be symmetric");
+			if(has_multi_arcs(tail, head))
+				throw runtime_error("Graph must not have multi arcs");
+			if(!is_loop_free(tail, head))
+				throw runtime_error("Graph must not have loops");
+			if(tail.image_count() <= 1)
+				throw runtime_error("Graph must have at least 2 nodes");
+
+			const string file_name = args[0];
+			const double time_limit = stof(args[1]);
+			if(time_limit < 0)
+				throw runtime_error("The time limit must not be negative");
+
+			const long long start_time = get_micro_time();
+
+			std::mutex best_mutex;
+			ArrayIDIDFunc best_order = compute_greedy_min_shortcut_order(tail, head);
+			int best_width = compute_width_of_order(best_order);
+			cerr << "c width " << best_width << " by greedy min shortcut" << endl;
+
+			termination_requested = false;
+			std::signal(SIGTERM, request_termination);
+
+			// Orderings can not be interrupted. The monitor therefore writes the result and
+			// terminates the process using std::_Exit while the workers are still running. The
+			// workers never stop on their own and nobody joins the monitor.
+			std::thread monitor(
+				[&]{
+					while(!termination_requested && (time_limit == 0 || get_micro_time() - start_time < time_limit*1000000))
+						std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+					std::lock_guard<std::mutex>lock(best_mutex);
+					auto inv_order = inverse_permutation(best_order);
+					auto td = compute_tree_decomposition(chain(tail, inv_order), chain(head, inv_order));
+					save_text_file(file_name,
+						[&](std::ostream&out){
+							write_tree_decomposition(out, td, chain(best_order, node_original_position));
+						}
+					);
+					cerr << "c final width " << best_width << endl;
+					std::_Exit(0);
+				}
+			);
+			monitor.detach();
+
+			std::atomic<int>next_iteration(0);
+			#pragma omp parallel num_threads(flow_cutter_config.thread_count)
+			for(;;){
+				int i = next_iteration++;
+				auto order = small_tree_width::compute_low_tree_width_order(tail, head, small_tree_width::ComputeSeparatorSet(make_anytime_config(i)));
+				int width = compute_width_of_order(order);
+
+				std::lock_guard<std::mutex>lock(best_mutex);
+				if(width < best_width){
+					best_width = width;
+					best_order = std::move(order);
+					cerr << "c width " << best_width << " in iteration " << i << " after " << (get_micro_time()-start_time)/1000 << "ms" << endl;
+				}
+			}
+		}
+	},
 	{
 		"reorder_nodes_in_flow_cutter_nested_dissection_order",
 		"Reorders all nodes in nested dissection order.",
@@ -3677,7 +4405,8 @@ vector<Command>cmd = {
 			permutate_nodes(
 				cch_order::compute_nested_dissection_graph_order(
 					tail, head, arc_weight,
-					flow_cutter::ComputeSeparator(flow_cutter_config)
+					make_flow_cutter_separator(flow_cutter_config),
+					flow_cutter::get_nested_dissection_cutoff(flow_cutter_config)
 				)
 			);
 		}
@@ -3698,7 +4427,8 @@ vector<Command>cmd = {
 					permutate_nodes(
 						cch_order::compute_nested_dissection_graph_order(
 							tail, head, arc_weight,
-							separator::report_separator_statistics(out, flow_cutter::ComputeSeparator(flow_cutter_config))
+							separator::report_separator_statistics(out, make_flow_cutter_separator(flow_cutter_config)),
+							flow_cutter::get_nested_dissection_cutoff(flow_cutter_config)
 						)
 					);
 				}
@@ -3718,7 +4448,8 @@ vector<Command>cmd = {
 			permutate_nodes(
 				cch_order::compute_cch_graph_order(
 					tail, head, arc_weight,
-					flow_cutter::ComputeSeparator(flow_cutter_config)
+					make_flow_cutter_separator(flow_cutter_config),
+					flow_cutter::get_nested_dissection_cutoff(flow_cutter_config)
 				)
 			);
 		}
@@ -3746,7 +4477,8 @@ vector<Command>cmd = {
 			permutate_nodes(
 				cch_order::compute_cch_graph_order_given_top_level_separator(
 					tail, head, arc_weight, std::move(separator),
-					flow_cutter::ComputeSeparator(flow_cutter_config)
+					make_flow_cutter_separator(flow_cutter_config),
+					flow_cutter::get_nested_dissection_cutoff(flow_cutter_config)
 				)
 			);
 		}
@@ -3767,13 +4499,74 @@ vector<Command>cmd = {
 					permutate_nodes(
 						cch_order::compute_cch_graph_order(
 							tail, head, arc_weight,
-							separator::report_separator_statistics(out, flow_cutter::ComputeSeparator(flow_cutter_config))
+							separator::report_separator_statistics(out, make_flow_cutter_separator(flow_cutter_config)),
+							flow_cutter::get_nested_dissection_cutoff(flow_cutter_config)
 						)
 					);
 				}
 			);
 		}
 	},
+	{
+		"benchmark_nested_dissection_cutoff", 1,
+		"Computes a flow cutter CCH order for every node count cutoff in the comma separated list arg1, where 0 disables the cutoff, and reports the running time and the upper tree width bound, the upward arc count of the chordal supergraph, the elimination tree height and the average number of arcs in the search space of the order. The tree width cutoff and the bottom level orderer are taken from the config. The graph is not modified.",
+		[](vector<string>args){
+			const int node_count = tail.image_count();
+			if(!is_symmetric(tail, head))
+				throw runtime_error("Graph must be symmetric");
+			if(has_multi_arcs(tail, head))
+				throw runtime_error("Graph must not have multi arcs");
+			if(!is_loop_free(tail, head))
+				throw runtime_error("Graph must not have loops");
+			if(node_count <= 1)
+				throw runtime_error("Graph must have at least 2 nodes");
+
+			vector<int>cutoff_list;
+			{
+				istringstream in(args[0]);
+				string x;
+				while(getline(in, x, ',')){
+					cutoff_list.push_back(stoi(x));
+					if(cutoff_list.back() < 0)
+						throw runtime_error("node count cutoffs must not be negative");
+				}
+			}
+
+			cout << "node_count_cutoff,running_time_musec,upper_tree_width_bound,super_graph_upward_arc_count,elimination_tree_height,average_arcs_in_search_space" << endl;
+			for(int max_node_count:cutoff_list){
+				auto config = flow_cutter_config;
+				config.nested_dissection_cutoff_node_count = max_node_count;
+
+				long long time = -get_micro_time();
+				auto order = cch_order::compute_cch_graph_order(
+					tail, head, arc_weight,
+					make_flow_cutter_separator(config),
+					flow_cutter::get_nested_dissection_cutoff(config)
+				);
+				time += get_micro_time();
+
+				auto inv_order = inverse_permutation(order);
+				auto t = elimination_tree::compute_elimination_tree(chain(tail, inv_order), chain(head, inv_order));
+
+				int max_up_deg = 0;
+				long long super_graph_arc_count = 0;
+				for(auto d:t.upward_degree){
+					max_to(max_up_deg, d);
+					super_graph_arc_count += d;
+				}
+				int height = 0;
+				for(auto d:t.depth)
+					max_to(height, d);
+				long long arcs_in_search_space_sum = 0;
+				for(auto x:t.arcs_in_search_space)
+					arcs_in_search_space_sum += x;
+
+				cout 
+					<< max_node_count << ',' << time << ',' << max_up_deg << ',' << super_graph_arc_count << ',' << height << ','
+					<< (static_cast<double>(arcs_in_search_space_sum)/node_count) << endl;
+			}
+		}
+	},
 	{
 		"print_pace_tree_decomposition", 1,
 		"Prints a tree decomposition in the PACE 2016 format corresponding the current node order. The outputted node IDs are the input node IDs and not with respect to the current order.",
@@ -3785,7 +4578,12 @@ vector<Command>cmd = {
 			if(node_count <= 1)
 				throw runtime_error("Graph must have at least 2 nodes");
 
-			print_tree_decompostion(args[0], tail, head, inverse_permutation(node_original_position));
+			auto td = compute_tree_decomposition(tail, head);
+			save_text_file(args[0],
+				[&](std::ostream&out){
+					write_tree_decomposition(out, td, node_original_position, flow_cutter_config.thread_count);
+				}
+			);
 		}
 	},
 	{
@@ -0,0 +1,178 @@
+#ifndef CUT_ENUMERATION_H
+#define CUT_ENUMERATION_H
+
+#include <vector>
+#include <string>
+#include <istream>
+#include <ostream>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+
+namespace flow_cutter{
+
+	//! Calls on_cut(cutter) for the current cut of an initialized cutter and then advances it. The
+	//! enumeration stops once on_cut returns false, the cut reaches max_cut_size arcs or the cutter
+	//! is exhausted. The cut arcs can be accessed without copy using cutter.get_current_cut().
+	template<class Cutter, class OnCut>
+	void forall_cuts(Cutter&cutter, int max_cut_size, const OnCut&on_cut){
+		do{
+			if(!on_cut(static_cast<const Cutter&>(cutter)))
+				return;
+		}while((int)cutter.get_current_cut().size() < max_cut_size && cutter.advance());
+	}
+
+	//! Like forall_cuts but only reports the Pareto front of cut size and balance. As the cut sizes
+	//! never decrease, a cut is held back until a larger cut is found, since a later cut of the
+	//! same size may have a larger smaller side. The held back cut is copied and therefore passed
+	//! as on_cut(cutter_id, smaller_side_size, cut) instead of the cutter.
+	template<class Cutter, class OnCut>
+	void forall_pareto_cuts(Cutter&cutter, int max_cut_size, const OnCut&on_cut){
+		int largest_smaller_side_size = -1;
+
+		bool has_candidate = false;
+		int candidate_cutter_id = -1;
+		int candidate_smaller_side_size = -1;
+		std::vector<int>candidate_cut;
+
+		forall_cuts(
+			cutter, max_cut_size,
+			[&](const Cutter&c){
+				const auto&cut = c.get_current_cut();
+				if(has_candidate && cut.size() > candidate_cut.size()){
+					has_candidate = false;
+					largest_smaller_side_size = candidate_smaller_side_size;
+					if(!on_cut(candidate_cutter_id, candidate_smaller_side_size, static_cast<const std::vector<int>&>(candidate_cut)))
+						return false;
+				}
+
+				int smaller_side_size = c.get_current_smaller_cut_side_size();
+				if(smaller_side_size <= largest_smaller_side_size)
+					return true;
+				if(has_candidate && smaller_side_size <= candidate_smaller_side_size)
+					return true;
+
+				has_candidate = true;
+				candidate_cutter_id = c.get_current_cutter_id();
+				candidate_smaller_side_size = smaller_side_size;
+				candidate_cut.assign(cut.begin(), cut.end());
+				return true;
+			}
+		);
+
+		if(has_candidate)
+			on_cut(candidate_cutter_id, candidate_smaller_side_size, static_cast<const std::vector<int>&>(candidate_cut));
+	}
+
+	// Binary cut lists. The file starts with the 8 byte magic "FCCUTS01", followed by the node and
+	// the arc count. Then a record per cut follows until the end of the file. A record consists of
+	// the cutter id, the size of the smaller side, the number of cut arcs and the sorted cut arc IDs.
+	// The first arc ID is stored as is and every further one as the difference to its predecessor.
+	// All numbers are unsigned LEB128 varints.
+	namespace binary_cut_list{
+		const char magic[8] = {'F', 'C', 'C', 'U', 'T', 'S', '0', '1'};
+
+		inline void write_varint(std::ostream&out, std::uint64_t x){
+			char buffer[10];
+			int n = 0;
+			while(x >= 0x80){
+				buffer[n++] = static_cast<char>((x & 0x7F) | 0x80);
+				x >>= 7;
+			}
+			buffer[n++] = static_cast<char>(x);
+			out.write(buffer, n);
+		}
+
+		//! Returns false if the stream ended before the first byte.
+		inline bool read_varint(std::istream&in, std::uint64_t&x){
+			x = 0;
+			int shift = 0;
+			for(;;){
+				int c = in.get();
+				if(c == std::char_traits<char>::eof()){
+					if(shift == 0)
+						return false;
+					throw std::runtime_error("binary cut list is truncated");
+				}
+				if(shift > 63)
+					throw std::runtime_error("binary cut list contains an overlong number");
+				x |= static_cast<std::uint64_t>(c & 0x7F) << shift;
+				if(!(c & 0x80))
+					return true;
+				shift += 7;
+			}
+		}
+
+		inline std::uint64_t read_required_varint(std::istream&in){
+			std::uint64_t x;
+			if(!read_varint(in, x))
+				throw std::runtime_error("binary cut list is truncated");
+			return x;
+		}
+
+		class Writer{
+		public:
+			Writer(std::ostream&out, int node_count, int arc_count):out(out){
+				out.write(magic, sizeof(magic));
+				write_varint(out, node_count);
+				write_varint(out, arc_count);
+			}
+
+			void write(int cutter_id, int smaller_side_size, const std::vector<int>&cut){
+				sorted_cut.assign(cut.begin(), cut.end());
+				std::sort(sorted_cut.begin(), sorted_cut.end());
+
+				write_varint(out, cutter_id);
+				write_varint(out, smaller_side_size);
+				write_varint(out, sorted_cut.size());
+				int prev = 0;
+				for(auto a:sorted_cut){
+					write_varint(out, a - prev);
+					prev = a;
+				}
+			}
+
+		private:
+			std::ostream&out;
+			std::vector<int>sorted_cut;
+		};
+
+		struct Header{
+			int node_count;
+			int arc_count;
+		};
+
+		//! Calls on_cut(cutter_id, smaller_side_size, cut) for every record. The cut is sorted and the
+		//! vector is reused between the calls.
+		template<class OnCut>
+		Header read(std::istream&in, const OnCut&on_cut){
+			char m[sizeof(magic)];
+			if(!in.read(m, sizeof(m)) || std::memcmp(m, magic, sizeof(magic)) != 0)
+				throw std::runtime_error("not a binary cut list");
+
+			Header h;
+			h.node_count = read_required_varint(in);
+			h.arc_count = read_required_varint(in);
+
+			std::vector<int>cut;
+			std::uint64_t cutter_id;
+			while(read_varint(in, cutter_id)){
+				int smaller_side_size = read_required_varint(in);
+				int cut_size = read_required_varint(in);
+				cut.resize(cut_size);
+				std::uint64_t a = 0;
+				for(auto&x:cut){
+					a += read_required_varint(in);
+					if(a >= static_cast<std::uint64_t>(h.arc_count))
+						throw std::runtime_error("binary cut list contains an arc ID out of bounds");
+					x = a;
+				}
+				on_cut(static_cast<int>(cutter_id), smaller_side_size, static_cast<const std::vector<int>&>(cut));
+			}
+			return h;
+		}
+	}
+}
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "tiny_id_func.h"
 #include "array_id_func.h"
+#include "timestamp_id_func.h"
 
 namespace max_flow{
 
@@ -158,11 +159,13 @@ namespace max_flow{
 		BitIDFunc is_target;
 		BitIDFunc is_saturated; 
 		int flow_intensity;
-		BitIDFunc is_blocked;
+		// Reset at the begin of every phase. Timestamps make the reset O(1)
+		// instead of touching every node and arc in each phase.
+		TimestampIDFunc is_blocked;
 
 		ArrayIDFunc<int> queue;
-		BitIDFunc was_pushed; 
-		BitIDFunc is_on_same_level_or_lower;
+		TimestampIDFunc was_pushed; 
+		TimestampIDFunc is_on_same_level_or_lower;
 
 		ArrayIDFunc<int>current_path_node;
 		ArrayIDFunc<int>current_path_arc;
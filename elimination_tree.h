@@ -0,0 +1,107 @@
+#ifndef ELIMINATION_TREE_H
+#define ELIMINATION_TREE_H
+
+#include "array_id_func.h"
+#include "id_multi_func.h"
+#include "min_max.h"
+#include <cassert>
+
+// The elimination tree of a symmetric graph with respect to the order given by the node IDs,
+// computed without building the chordal supergraph.
+namespace elimination_tree{
+
+	struct EliminationTree{
+		//! The parent of every node or -1 if the node is a root.
+		ArrayIDFunc<int>parent;
+		//! The number of ancestors of every node including the node itself.
+		ArrayIDFunc<int>depth;
+		//! The number of nodes in the subtree rooted at every node.
+		ArrayIDFunc<int>subtree_size;
+		//! The number of upward arcs of every node in the chordal supergraph.
+		ArrayIDFunc<int>upward_degree;
+		//! The number of chordal supergraph arcs reachable by following upward arcs.
+		ArrayIDFunc<long long>arcs_in_search_space;
+
+		int node_count()const{ return parent.preimage_count(); }
+	};
+
+	//! Liu's algorithm. The virtual ancestors are path compressed, which makes the running time
+	//! almost linear in the arc count.
+	template<class Tail, class Head>
+	ArrayIDFunc<int>compute_elimination_tree_parent(const Tail&tail, const Head&head){
+		const int node_count = tail.image_count();
+		auto inv_tail = invert_id_id_func(tail);
+
+		ArrayIDFunc<int>parent(node_count), ancestor(node_count);
+		for(int x=0; x<node_count; ++x){
+			parent[x] = -1;
+			ancestor[x] = -1;
+			for(auto xy:inv_tail(x)){
+				int y = head(xy);
+				while(y != -1 && y < x){
+					int next = ancestor(y);
+					ancestor[y] = x;
+					if(next == -1)
+						parent[y] = x;
+					y = next;
+				}
+			}
+		}
+		return parent; // NVRO
+	}
+
+	//! Calls on_arc(x, y) for every upward arc x -> y of the chordal supergraph. The arcs are
+	//! enumerated by increasing y. The upward neighbors of x are the nodes whose row subtree
+	//! contains x, where the row subtree of y is the union of the tree paths from the lower
+	//! neighbors of y to y. Marking the visited nodes makes the running time linear in the
+	//! supergraph size.
+	template<class Tail, class Head, class Parent, class OnArc>
+	void forall_chordal_supergraph_arcs(const Tail&tail, const Head&head, const Parent&parent, const OnArc&on_arc){
+		const int node_count = tail.image_count();
+		auto inv_tail = invert_id_id_func(tail);
+
+		ArrayIDFunc<int>mark(node_count);
+		mark.fill(-1);
+		for(int y=0; y<node_count; ++y){
+			mark[y] = y;
+			for(auto yx:inv_tail(y)){
+				for(int x = head(yx); x < y && mark(x) != y; x = parent(x)){
+					assert(x != -1);
+					mark[x] = y;
+					on_arc(x, y);
+				}
+			}
+		}
+	}
+
+	template<class Tail, class Head>
+	EliminationTree compute_elimination_tree(const Tail&tail, const Head&head){
+		const int node_count = tail.image_count();
+
+		EliminationTree t;
+		t.parent = compute_elimination_tree_parent(tail, head);
+
+		t.upward_degree = ArrayIDFunc<int>(node_count);
+		t.upward_degree.fill(0);
+		forall_chordal_supergraph_arcs(tail, head, t.parent, [&](int x, int){ ++t.upward_degree[x]; });
+
+		t.subtree_size = ArrayIDFunc<int>(node_count);
+		t.subtree_size.fill(1);
+		for(int x=0; x<node_count; ++x)
+			if(t.parent(x) != -1)
+				t.subtree_size[t.parent(x)] += t.subtree_size(x);
+
+		t.depth = ArrayIDFunc<int>(node_count);
+		t.arcs_in_search_space = ArrayIDFunc<long long>(node_count);
+		for(int x=node_count-1; x>=0; --x){
+			int p = t.parent(x);
+			t.depth[x] = 1 + (p == -1 ? 0 : t.depth(p));
+			t.arcs_in_search_space[x] = t.upward_degree(x) + (p == -1 ? 0 : t.arcs_in_search_space(p));
+		}
+
+		return t; // NVRO
+	}
+}
+
+#endif
+
@@ -8,14 +8,18 @@
 #include "dijkstra.h"
 #include "min_max.h"
 #include <vector>
+#include <array>
 #include <algorithm>
 #include <sstream>
 #include <random>
 #include <memory>
+#include <mutex>
 
 #include <omp.h>
 
 #include "flow_cutter_config.h"
+#include "flow_cutter_instrumentation.h"
+#include "timer.h"
 
 #include <iostream>
 #include <iomanip>
@@ -23,12 +27,27 @@ using namespace std;
 
 namespace flow_cutter{
 
-	template<class Tail, class Head, class BackArc, class ArcWeight, class Capacity, class OutArc>
+	template<class NodeWeight>
+	int compute_total_node_weight(const NodeWeight&node_weight){
+		int total = 0;
+		for(int x=0; x<node_weight.preimage_count(); ++x)
+			total += node_weight(x);
+		return total;
+	}
+
+	template<int value>
+	int compute_total_node_weight(const ConstIntIDFunc<value>&node_weight){
+		return value*node_weight.preimage_count();
+	}
+
+	//! The balance of a cut is measured in node weight. The weights must be non-negative.
+	template<class Tail, class Head, class BackArc, class NodeWeight, class ArcWeight, class Capacity, class OutArc>
 	struct Graph{
 		Graph(
 			Tail tail, 
 			Head head, 
 			BackArc back_arc,
+			NodeWeight node_weight,
 			ArcWeight arc_weight, 
 			Capacity capacity, 
 			OutArc out_arc
@@ -36,14 +55,16 @@ namespace flow_cutter{
 			tail(std::move(tail)), 
 			head(std::move(head)), 
 			back_arc(std::move(back_arc)), 
+			node_weight(std::move(node_weight)),
 			arc_weight(std::move(arc_weight)),
 			capacity(std::move(capacity)), 
-			out_arc(std::move(out_arc)){}
+			out_arc(std::move(out_arc)),
+			total_node_weight_(compute_total_node_weight(this->node_weight)){}
 
 		Tail tail;
 		Head head;
 		BackArc back_arc;
-		//NodeWeight node_weight;
+		NodeWeight node_weight;
 		ArcWeight arc_weight;
 		Capacity capacity;
 		OutArc out_arc;
@@ -55,6 +76,13 @@ namespace flow_cutter{
 		int arc_count()const{
 			return tail.preimage_count(); 
 		}
+
+		int total_node_weight()const{
+			return total_node_weight_;
+		}
+
+	private:
+		int total_node_weight_;
 	};
 
 	//! Each threads needs its own TemporaryData object.
@@ -62,22 +90,38 @@ namespace flow_cutter{
 		TemporaryData(){}
 		explicit TemporaryData(int node_count):
 			node_space(node_count){}
+
+		void resize(int node_count){
+			node_space.discard_and_resize(node_count);
+		}
+
 		ArrayIDFunc<int>node_space;
 	};
 
+	template<class Tail, class Head, class BackArc, class NodeWeight, class ArcWeight, class Capacity, class OutArc>
+	Graph<Tail, Head, BackArc, NodeWeight, ArcWeight, Capacity, OutArc>
+		make_graph(
+			Tail tail, Head head, BackArc back_arc, NodeWeight node_weight,
+			ArcWeight arc_weight, Capacity capacity, OutArc out_arc
+		){
+		return {std::move(tail), std::move(head), std::move(back_arc), std::move(node_weight), std::move(arc_weight), std::move(capacity), std::move(out_arc)};
+	}
+
+	//! Every node has weight 1.
 	template<class Tail, class Head, class BackArc, class ArcWeight, class Capacity, class OutArc>
-	Graph<Tail, Head, BackArc, ArcWeight, Capacity, OutArc>
+	Graph<Tail, Head, BackArc, ConstIntIDFunc<1>, ArcWeight, Capacity, OutArc>
 		make_graph(
 			Tail tail, Head head, BackArc back_arc,
 			ArcWeight arc_weight, Capacity capacity, OutArc out_arc
 		){
-		return {std::move(tail), std::move(head), std::move(back_arc), std::move(arc_weight), std::move(capacity), std::move(out_arc)};
+		int node_count = tail.image_count();
+		return {std::move(tail), std::move(head), std::move(back_arc), ConstIntIDFunc<1>(node_count), std::move(arc_weight), std::move(capacity), std::move(out_arc)};
 	}
 
 	template<class Tail, class Head, class BackArc, class OutArc>
 	Graph<
 		Tail, Head, BackArc, 
-		ConstIntIDFunc<1>, ConstIntIDFunc<1>, 
+		ConstIntIDFunc<1>, ConstIntIDFunc<1>, ConstIntIDFunc<1>, 
 		OutArc
 	>
 		make_graph(
@@ -86,7 +130,7 @@ namespace flow_cutter{
 		){
 		return {
 			std::move(tail), std::move(head), std::move(back_arc), 
-			ConstIntIDFunc<1>(tail.preimage_count()), ConstIntIDFunc<1>(tail.preimage_count()), 
+			ConstIntIDFunc<1>(tail.image_count()), ConstIntIDFunc<1>(tail.preimage_count()), ConstIntIDFunc<1>(tail.preimage_count()), 
 			std::move(out_arc)
 		};
 	}
@@ -152,6 +196,11 @@ namespace flow_cutter{
 		UnitFlow(){}
 		explicit UnitFlow(int preimage_count):flow(preimage_count){}
 
+		//! The flow must be cleared afterwards.
+		void resize(int preimage_count){
+			flow.discard_and_resize(preimage_count);
+		}
+
 		void clear(){
 			flow.fill(1);
 		}
@@ -191,21 +240,41 @@ namespace flow_cutter{
 		TinyIntIDFunc<2>flow;
 	};
 
+	//! The nodes added using set_extra_node since the last grow are the start nodes of the next
+	//! grow. Usually, this is a single terminal or pierce node but a cutter initialized from
+	//! terminal sets starts from all of them.
 	class BasicNodeSet{
 	public:
 		template<class Graph>
 		explicit BasicNodeSet(const Graph&graph):
 			node_count_inside_(0),
-			inside_flag(graph.node_count()),
-			extra_node(-1){}
+			node_weight_inside_(0),
+			inside_flag(graph.node_count()){}
 
 		void clear(){ 
 			node_count_inside_ = 0; 
+			node_weight_inside_ = 0;
 			inside_flag.fill(false); 
+			extra_node_list.clear();
+		}
+
+		//! The set must be cleared afterwards.
+		template<class Graph>
+		void resize(const Graph&graph){
+			inside_flag.discard_and_resize(graph.node_count());
+		}
+
+		//! Same as the copy assignment but does not allocate.
+		void copy_from(const BasicNodeSet&other){
+			assert(inside_flag.preimage_count() == other.inside_flag.preimage_count());
+			node_count_inside_ = other.node_count_inside_;
+			node_weight_inside_ = other.node_weight_inside_;
+			std::copy(other.inside_flag.data_.begin(), other.inside_flag.data_.end(), inside_flag.data_.begin());
+			extra_node_list = other.extra_node_list;
 		}
 
 		bool can_grow()const{
-			return extra_node != -1;
+			return !extra_node_list.empty();
 		}
 
 		template<class Graph, class SearchAlgorithm, class OnNewNode, class ShouldFollowArc, class OnNewArc>
@@ -219,28 +288,38 @@ namespace flow_cutter{
 		){
 			assert(can_grow());
 
+			bool was_stopped = false;
+
 			auto see_node = [&](int x){
 				assert(!inside_flag(x));
 				inside_flag.set(x, true);
 				++this->node_count_inside_;
-				return on_new_node(x);
+				this->node_weight_inside_ += graph.node_weight(x);
+				if(on_new_node(x))
+					return true;
+				was_stopped = true;
+				return false;
 			};
 
 			auto was_node_seen = [&](int x){
 				return inside_flag(x);
 			};
 
-			search_algo(graph, tmp, extra_node, was_node_seen, see_node, should_follow_arc, on_new_arc);
-			extra_node = -1;
+			for(auto x:extra_node_list){
+				search_algo(graph, tmp, x, was_node_seen, see_node, should_follow_arc, on_new_arc);
+				if(was_stopped)
+					break;
+			}
+			extra_node_list.clear();
 		}
 
 		template<class Graph>
 		void set_extra_node(const Graph&graph, int x){
 			assert(!inside_flag(x));
-			assert(extra_node == -1);
 			inside_flag.set(x, true);
 			++node_count_inside_;
-			extra_node = x;
+			node_weight_inside_ += graph.node_weight(x);
+			extra_node_list.push_back(x);
 		}
 
 		bool is_inside(int x) const { 
@@ -251,56 +330,98 @@ namespace flow_cutter{
 			return node_count_inside_; 
 		}
 
+		int node_weight_inside() const { 
+			return node_weight_inside_; 
+		}
+
 		int max_node_count_inside() const {
 			return inside_flag.preimage_count();
 		}
 
 	private:
 		int node_count_inside_;
+		int node_weight_inside_;
 		BitIDFunc inside_flag;
-		int extra_node;
+		std::vector<int>extra_node_list;
 	};
 
 	class ReachableNodeSet;
 
+	// The cut front of an assimilated set are the arcs xy with flow that leave the set, i.e., x is
+	// inside and y outside. An arc with flow is added when its tail enters the set and removed when
+	// its head enters the set. Every arc is in the front of at most one set, namely the one
+	// containing its tail, and therefore both sets of a cutter share the front_pos map, which
+	// stores for every arc its position in the front or -1. Removing an arc swaps it with the last
+	// front arc, which makes updates proportional to the degrees of the new nodes. The storage
+	// order is therefore not the insertion order. Consumers such as the separator extraction
+	// depend on the insertion order and get_cut_front restores it lazily using the stamps.
 	class AssimilatedNodeSet{
 		friend class ReachableNodeSet;
 	public:
 		template<class Graph>
 		explicit AssimilatedNodeSet(const Graph&graph):
-			node_set(graph){}
+			node_set(graph), next_front_stamp(0), is_ordered_front_valid(true){}
 
-		void clear(){ 
+		void clear(ArrayIDFunc<int>&front_pos){ 
 			node_set.clear(); 
+			for(auto xy:front)
+				front_pos[xy] = -1;
 			front.clear(); 
+			front_stamp.clear();
+			next_front_stamp = 0;
+			ordered_front.clear();
+			is_ordered_front_valid = true;
 		}
 
+		//! The front positions are not updated as they are resized as well. The set must be
+		//! cleared afterwards.
 		template<class Graph>
-		void set_extra_node(const Graph&graph, int x){
+		void resize(const Graph&graph){
+			node_set.resize(graph);
+			front.clear();
+			front_stamp.clear();
+			ordered_front.clear();
+		}
+
+		template<class Graph>
+		void set_extra_node(const Graph&graph, ArrayIDFunc<int>&front_pos, int x){
 			node_set.set_extra_node(graph, x);
+			remove_arcs_into_from_cut_front(graph, front_pos, x);
 		}
 
 		bool can_grow()const{
 			return node_set.can_grow();
 		}
 
-		template<class Graph, class SearchAlgorithm, class OnNewNode, class ShouldFollowArc, class OnNewArc, class HasFlow>
+		template<class Graph, class SearchAlgorithm, class OnNewNode, class ShouldFollowArc, class OnNewFrontArc, class HasFlow>
 		void grow(
 			const Graph&graph,
 			TemporaryData&tmp, 
 			const SearchAlgorithm&search_algo,
+			ArrayIDFunc<int>&front_pos,
 			const OnNewNode&on_new_node, // on_new_node(x) is called for every node x. If it returns false then the search is stopped, if it returns true it continues
 			const ShouldFollowArc&should_follow_arc, // is called for a subset of arcs and must say whether the arc sould be followed
-			const OnNewArc&on_new_arc, // on_new_arc(xy) is called for ever arc xy with x in the set
+			const OnNewFrontArc&on_new_front_arc, // on_new_front_arc(xy, stamp) is called for every arc added to the cut front
 			const HasFlow&has_flow
 		){
+			auto my_on_new_node = [&](int x){
+				remove_arcs_into_from_cut_front(graph, front_pos, x);
+				return on_new_node(x);
+			};
+
 			auto my_on_new_arc = [&](int xy){
-				if(has_flow(xy))
+				if(has_flow(xy) && !node_set.is_inside(graph.head(xy))){
+					assert(front_pos(xy) == -1);
+					front_pos[xy] = front.size();
 					front.push_back(xy);
-				on_new_arc(xy);
+					front_stamp.push_back(next_front_stamp);
+					is_ordered_front_valid = false;
+					on_new_front_arc(xy, next_front_stamp);
+					++next_front_stamp;
+				}
 			};
 
-			node_set.grow(graph, tmp, search_algo, on_new_node, should_follow_arc, my_on_new_arc);
+			node_set.grow(graph, tmp, search_algo, my_on_new_node, should_follow_arc, my_on_new_arc);
 		}
 
 		bool is_inside(int x) const { 
@@ -311,28 +432,69 @@ namespace flow_cutter{
 			return node_set.node_count_inside(); 
 		}
 
+		int node_weight_inside() const { 
+			return node_set.node_weight_inside(); 
+		}
+
 		int max_node_count_inside() const {
 			return node_set.max_node_count_inside();
 		}
 
-		template<class Graph>
-		void shrink_cut_front(const Graph&graph){
-			front.erase(
-				std::remove_if(
-					front.begin(), front.end(), 
-					[&](int xy){ return node_set.is_inside(graph.head(xy)); }
-				),
-				front.end()
-			);
+		//! The cut front in insertion order.
+		const std::vector<int>&get_cut_front() const { 
+			if(!is_ordered_front_valid){
+				ordered_front_buffer.clear();
+				for(int i=0; i<(int)front.size(); ++i)
+					ordered_front_buffer.push_back({front_stamp[i], front[i]});
+				std::sort(ordered_front_buffer.begin(), ordered_front_buffer.end());
+				ordered_front.clear();
+				for(auto&a:ordered_front_buffer)
+					ordered_front.push_back(a.second);
+				is_ordered_front_valid = true;
+			}
+			return ordered_front; 
 		}
 
-		const std::vector<int>&get_cut_front() const { 
+		int get_cut_front_size() const {
+			return front.size();
+		}
+
+		//! The cut front in storage order.
+		const std::vector<int>&get_unordered_cut_front() const { 
 			return front; 
 		}
 
+		//! The insertion stamps of the arcs in get_unordered_cut_front().
+		const std::vector<int>&get_unordered_cut_front_stamp() const { 
+			return front_stamp; 
+		}
+
 	private:
+		template<class Graph>
+		void remove_arcs_into_from_cut_front(const Graph&graph, ArrayIDFunc<int>&front_pos, int y){
+			for(auto yx : graph.out_arc(y)){
+				int xy = graph.back_arc(yx);
+				int pos = front_pos(xy);
+				if(pos != -1 && node_set.is_inside(graph.tail(xy))){
+					int last = front.back();
+					front[pos] = last;
+					front_stamp[pos] = front_stamp.back();
+					front_pos[last] = pos;
+					front.pop_back();
+					front_stamp.pop_back();
+					front_pos[xy] = -1;
+					is_ordered_front_valid = false;
+				}
+			}
+		}
+
 		BasicNodeSet node_set;
-		std::vector<int>front;
+		std::vector<int>front, front_stamp;
+		int next_front_stamp;
+
+		mutable std::vector<int>ordered_front;
+		mutable std::vector<std::pair<int, int>>ordered_front_buffer;
+		mutable bool is_ordered_front_valid;
 	};
 
 	class ReachableNodeSet{
@@ -342,7 +504,14 @@ namespace flow_cutter{
 			node_set(graph), predecessor(graph.node_count()){}
 
 		void reset(const AssimilatedNodeSet&other){
-			node_set = other.node_set;
+			node_set.copy_from(other.node_set);
+		}
+
+		//! The set must be cleared afterwards.
+		template<class Graph>
+		void resize(const Graph&graph){
+			node_set.resize(graph);
+			predecessor.discard_and_resize(graph.node_count());
 		}
 
 		void clear(){ 
@@ -383,6 +552,10 @@ namespace flow_cutter{
 			return node_set.node_count_inside(); 
 		}
 
+		int node_weight_inside() const { 
+			return node_set.node_weight_inside(); 
+		}
+
 		int max_node_count_inside() const {
 			return node_set.max_node_count_inside();
 		}
@@ -405,6 +578,17 @@ namespace flow_cutter{
 		int source, target;
 	};
 
+	//! The terminals of a cutter that starts from node sets instead of single nodes, for example
+	//! the nodes closest to and farthest from some node. The sets must be non-empty and disjoint.
+	struct SourceTargetSets{
+		std::vector<int>source_list, target_list;
+	};
+
+	inline std::array<int, 1> get_source_list(const SourceTargetPair&p){ return {{p.source}}; }
+	inline std::array<int, 1> get_target_list(const SourceTargetPair&p){ return {{p.target}}; }
+	inline const std::vector<int>&get_source_list(const SourceTargetSets&p){ return p.source_list; }
+	inline const std::vector<int>&get_target_list(const SourceTargetSets&p){ return p.target_list; }
+
 	struct CutterStateDump{
 		BitIDFunc source_assimilated, target_assimilated, source_reachable, target_reachable, flow;
 	};
@@ -416,21 +600,49 @@ namespace flow_cutter{
 			assimilated{AssimilatedNodeSet(graph), AssimilatedNodeSet(graph)}, 
 			reachable{ReachableNodeSet(graph), ReachableNodeSet(graph)}, 
 			flow(graph.arc_count()),
-			cut_available(false)
-		{}
+			cut_front_pos(graph.arc_count()),
+			cut_available(false),
+			cached_pierce_side(-1)
+		{
+			cut_front_pos.fill(-1);
+		}
 
-		template<class Graph, class SearchAlgorithm>
-		void init(const Graph&graph, TemporaryData&tmp, const SearchAlgorithm&search_algo, SourceTargetPair p){
-			assimilated[source_side].clear();
+		//! Adapts the cutter to another graph and reuses the memory if the graph is not larger than
+		//! every graph before. The cutter must be initialized afterwards.
+		template<class Graph>
+		void resize(const Graph&graph){
+			for(int side=0; side<2; ++side){
+				assimilated[side].resize(graph);
+				reachable[side].resize(graph);
+			}
+			flow.resize(graph.arc_count());
+			cut_front_pos.discard_and_resize(graph.arc_count());
+			cut_front_pos.fill(-1);
+			cut_available = false;
+		}
+
+		//! Terminals is either a SourceTargetPair or SourceTargetSets.
+		template<class Graph, class SearchAlgorithm, class Terminals>
+		void init(const Graph&graph, TemporaryData&tmp, const SearchAlgorithm&search_algo, const Terminals&p){
+			FLOW_CUTTER_INSTRUMENT(counters = instrumentation::Counters();)
+			assimilated[source_side].clear(cut_front_pos);
 			reachable[source_side].clear();
-			assimilated[target_side].clear();
+			assimilated[target_side].clear(cut_front_pos);
 			reachable[target_side].clear();
 			flow.clear();
+			pierce_queue[source_side].clear();
+			pierce_queue[target_side].clear();
+			cached_pierce_side = -1;
 
-			assimilated[source_side].set_extra_node(graph, p.source);
-			reachable[source_side].set_extra_node(graph, p.source);
-			assimilated[target_side].set_extra_node(graph, p.target);
-			reachable[target_side].set_extra_node(graph, p.target);
+			for(auto x:get_source_list(p)){
+				assimilated[source_side].set_extra_node(graph, cut_front_pos, x);
+				reachable[source_side].set_extra_node(graph, x);
+			}
+			for(auto x:get_target_list(p)){
+				assert(!assimilated[source_side].is_inside(x) && "source and target sets must be disjoint");
+				assimilated[target_side].set_extra_node(graph, cut_front_pos, x);
+				reachable[target_side].set_extra_node(graph, x);
+			}
 			
 			grow_reachable_sets(graph, tmp, search_algo, source_side);
 			grow_assimilated_sets(graph, tmp, search_algo);
@@ -483,7 +695,7 @@ namespace flow_cutter{
 
 			check_invariants(graph);
 			int side = get_current_cut_side();
-			if(assimilated[side].node_count_inside() >= graph.node_count()/2){
+			if(assimilated[side].node_weight_inside() >= graph.total_node_weight()/2){
 				cut_available = false;
 				return false;
 			}
@@ -497,7 +709,10 @@ namespace flow_cutter{
 
 			assert(!assimilated[1-side].is_inside(pierce_node));			
 
-			assimilated[side].set_extra_node(graph, pierce_node);
+			FLOW_CUTTER_INSTRUMENT(++counters.advance_count;)
+
+			cached_pierce_side = -1;
+			assimilated[side].set_extra_node(graph, cut_front_pos, pierce_node);
 			reachable[side].set_extra_node(graph, pierce_node);
 
 			grow_reachable_sets(graph, tmp, search_algo, side);
@@ -515,7 +730,7 @@ namespace flow_cutter{
 		bool does_next_advance_increase_cut(const Graph&graph, const ScorePierceNode&score_pierce_node){
 			int side = get_current_cut_side();	
 
-			if(assimilated[side].node_count_inside() >= graph.node_count()/2){
+			if(assimilated[side].node_weight_inside() >= graph.total_node_weight()/2){
 				return true;
 			}
 
@@ -541,7 +756,7 @@ namespace flow_cutter{
 			if(
 				reachable[source_side].node_count_inside() == assimilated[source_side].node_count_inside() && (
 					reachable[target_side].node_count_inside() != assimilated[target_side].node_count_inside() ||
-					assimilated[source_side].node_count_inside() <= assimilated[target_side].node_count_inside()
+					assimilated[source_side].node_weight_inside() <= assimilated[target_side].node_weight_inside()
 				)
 			)
 				return source_side;
@@ -549,37 +764,183 @@ namespace flow_cutter{
 				return target_side;
 		}
 
+		//! The node weight of the smaller side. This is its node count if all weights are 1.
 		int get_current_smaller_cut_side_size()const{
-			return assimilated[get_current_cut_side()].node_count_inside();
+			return assimilated[get_current_cut_side()].node_weight_inside();
 		}
 
 		const std::vector<int>&get_current_cut()const{
 			return assimilated[get_current_cut_side()].get_cut_front();
 		}
 
+		int get_current_cut_size()const{
+			return assimilated[get_current_cut_side()].get_cut_front_size();
+		}
+
 		int get_assimilated_node_count()const{
 			return assimilated[source_side].node_count_inside() + assimilated[target_side].node_count_inside();
 		}
 
+		#ifdef FLOW_CUTTER_INSTRUMENTATION
+		instrumentation::Counters&get_instrumentation_counters(){
+			return counters;
+		}
+
+		const instrumentation::Counters&get_instrumentation_counters()const{
+			return counters;
+		}
+		#endif
+
 	private:
+		#ifdef FLOW_CUTTER_INSTRUMENTATION
+		void count_reset(int side){
+			++counters.reachable_reset_count;
+			counters.reachable_reset_copied_node_count += reachable[side].max_node_count_inside();
+		}
+		#endif
+
+		// The pierce node is the head of the cut front arc with the maximum score. Among several such
+		// arcs the one that was added first to the cut front is chosen. Instead of scanning the
+		// whole cut front on every advance, the candidate arcs are kept in a binary max-heap per
+		// side. The score function must not change during the lifetime of the cutter.
+		//
+		// The heap entries are removed lazily once their head is assimilated by any side. The score
+		// of a candidate depends on whether its head is reachable from the other side. Between two
+		// flow augmentations the reachable sets only grow, which only changes candidates from not
+		// causing an augmenting path to causing one. For usual scores this only decreases the score
+		// and a stale heap key is thus an upper bound, which is fixed when the entry reaches the
+		// top. The few candidates whose score would rise are kept in an unordered list that is
+		// scanned. Flow augmentations reset the reachable sets and the heaps are rebuilt from the
+		// cut fronts when they are used next.
+
+		struct PierceCandidate{
+			int score;
+			//! Position in the order in which the arcs were added to the cut front.
+			int stamp;
+			int arc;
+		};
+
+		static bool is_worse_pierce_candidate(const PierceCandidate&l, const PierceCandidate&r){
+			return l.score < r.score || (l.score == r.score && l.stamp > r.stamp);
+		}
+
+		struct PierceCandidateQueue{
+			std::vector<PierceCandidate>heap;
+			std::vector<PierceCandidate>rising_candidates;
+			//! Arcs added to the cut front since the last refresh and their stamps.
+			std::vector<std::pair<int, int>>new_arcs;
+			bool must_rebuild;
+
+			void clear(){
+				heap.clear();
+				rising_candidates.clear();
+				new_arcs.clear();
+				must_rebuild = true;
+			}
+		};
+
+		void invalidate_pierce_candidate_queues(){
+			pierce_queue[source_side].must_rebuild = true;
+			pierce_queue[target_side].must_rebuild = true;
+			cached_pierce_side = -1;
+		}
+
+		template<class Graph>
+		bool is_stale_pierce_candidate(const Graph&graph, int xy)const{
+			int y = graph.head(xy);
+			return assimilated[source_side].is_inside(y) || assimilated[target_side].is_inside(y);
+		}
+
 		template<class Graph, class ScorePierceNode>
-		int select_pierce_node(const Graph&graph, int side, const ScorePierceNode&score_pierce_node){
+		int get_pierce_candidate_score(const Graph&graph, int side, const ScorePierceNode&score_pierce_node, int xy)const{
+			int y = graph.head(xy);
+			return score_pierce_node(y, side, reachable[1-side].is_inside(y), graph.arc_weight(xy));
+		}
 
-			int pierce_node = -1;
-			int max_score = std::numeric_limits<int>::min();
-			for(auto xy : assimilated[side].get_cut_front()){
-				int y = graph.head(xy);	
-				if(!assimilated[1-side].is_inside(y)){
-					int score = score_pierce_node(y, side, reachable[1-side].is_inside(y), graph.arc_weight(xy));
+		template<class Graph, class ScorePierceNode>
+		void add_pierce_candidate(const Graph&graph, int side, const ScorePierceNode&score_pierce_node, int xy, int stamp){
+			auto&q = pierce_queue[side];
+			int y = graph.head(xy);
+			if(assimilated[1-side].is_inside(y))
+				return;
+			bool causes_augmenting_path = reachable[1-side].is_inside(y);
+			int score = score_pierce_node(y, side, causes_augmenting_path, graph.arc_weight(xy));
+			if(!causes_augmenting_path && score_pierce_node(y, side, true, graph.arc_weight(xy)) > score){
+				q.rising_candidates.push_back({score, stamp, xy});
+			}else{
+				q.heap.push_back({score, stamp, xy});
+				std::push_heap(q.heap.begin(), q.heap.end(), is_worse_pierce_candidate);
+			}
+		}
 
-					if(score > max_score){
-						max_score = score;
-						pierce_node = y;
-					}
+		template<class Graph, class ScorePierceNode>
+		int find_pierce_node(const Graph&graph, int side, const ScorePierceNode&score_pierce_node){
+			auto&q = pierce_queue[side];
+			FLOW_CUTTER_INSTRUMENT(++counters.pierce_node_selection_count;)
+
+			if(q.must_rebuild){
+				q.clear();
+				q.must_rebuild = false;
+				const auto&front = assimilated[side].get_unordered_cut_front();
+				const auto&front_stamp = assimilated[side].get_unordered_cut_front_stamp();
+				for(int i=0; i<(int)front.size(); ++i)
+					add_pierce_candidate(graph, side, score_pierce_node, front[i], front_stamp[i]);
+				FLOW_CUTTER_INSTRUMENT(counters.pierce_node_candidate_arc_count += assimilated[side].get_cut_front_size();)
+			}else{
+				for(auto a : q.new_arcs)
+					add_pierce_candidate(graph, side, score_pierce_node, a.first, a.second);
+				FLOW_CUTTER_INSTRUMENT(counters.pierce_node_candidate_arc_count += q.new_arcs.size();)
+			}
+			q.new_arcs.clear();
+
+			while(!q.heap.empty()){
+				FLOW_CUTTER_INSTRUMENT(++counters.pierce_node_candidate_arc_count;)
+				auto top = q.heap.front();
+				bool is_stale = is_stale_pierce_candidate(graph, top.arc);
+				int score = is_stale ? 0 : get_pierce_candidate_score(graph, side, score_pierce_node, top.arc);
+				if(!is_stale && score == top.score)
+					break;
+				assert(is_stale || score < top.score);
+				std::pop_heap(q.heap.begin(), q.heap.end(), is_worse_pierce_candidate);
+				if(is_stale){
+					q.heap.pop_back();
+				}else{
+					q.heap.back().score = score;
+					std::push_heap(q.heap.begin(), q.heap.end(), is_worse_pierce_candidate);
 				}
 			}
 
-			return pierce_node;
+			q.rising_candidates.erase(
+				std::remove_if(
+					q.rising_candidates.begin(), q.rising_candidates.end(),
+					[&](const PierceCandidate&c){ return is_stale_pierce_candidate(graph, c.arc); }
+				),
+				q.rising_candidates.end()
+			);
+
+			const PierceCandidate*best = q.heap.empty() ? nullptr : &q.heap.front();
+			for(auto&c:q.rising_candidates){
+				FLOW_CUTTER_INSTRUMENT(++counters.pierce_node_candidate_arc_count;)
+				c.score = get_pierce_candidate_score(graph, side, score_pierce_node, c.arc);
+				if(best == nullptr || is_worse_pierce_candidate(*best, c))
+					best = &c;
+			}
+
+			if(best == nullptr)
+				return -1;
+			else
+				return graph.head(best->arc);
+		}
+
+		//! does_next_advance_increase_cut and advance ask for the same pierce node. The cache avoids
+		//! determining it twice.
+		template<class Graph, class ScorePierceNode>
+		int select_pierce_node(const Graph&graph, int side, const ScorePierceNode&score_pierce_node){
+			if(cached_pierce_side != side){
+				cached_pierce_node = find_pierce_node(graph, side, score_pierce_node);
+				cached_pierce_side = side;
+			}
+			return cached_pierce_node;
 		}
 
 		template<class Graph>
@@ -615,6 +976,7 @@ namespace flow_cutter{
 			};
 
 			auto increase_flow = [&](int xy){
+				FLOW_CUTTER_INSTRUMENT(++counters.augmenting_path_arc_count;)
 				if(pierced_side == source_side)
 					flow.increase(graph, xy);
 				else
@@ -627,21 +989,28 @@ namespace flow_cutter{
 			do{
 				target_hit = -1;
 				auto on_new_node = [&](int x){ 
+					FLOW_CUTTER_INSTRUMENT(++counters.reachable_scanned_node_count;)
 					if(is_target(x)){
 						target_hit = x; 
 						return false;
 					} else 
 						return true; 
 				};
-				auto should_follow_arc = [&](int xy){ return !is_forward_saturated(xy); }; 
+				auto should_follow_arc = [&](int xy){ 
+					FLOW_CUTTER_INSTRUMENT(++counters.reachable_scanned_arc_count;)
+					return !is_forward_saturated(xy); 
+				}; 
 				auto on_new_arc = [](int xy){};
 				reachable[my_source_side].grow(graph, tmp, search_algo, on_new_node, should_follow_arc, on_new_arc);
 
 				if(target_hit != -1){
+					FLOW_CUTTER_INSTRUMENT(++counters.augmenting_path_count;)
 					check_flow_conservation(graph);
 					reachable[my_source_side].forall_arcs_in_path_to(graph, is_source, target_hit, increase_flow);
 					check_flow_conservation(graph);
 					reachable[my_source_side].reset(assimilated[my_source_side]);
+					invalidate_pierce_candidate_queues();
+					FLOW_CUTTER_INSTRUMENT(count_reset(my_source_side);)
 						
 					was_flow_augmented = true;
 					check_flow_conservation(graph);
@@ -650,8 +1019,15 @@ namespace flow_cutter{
 
 			if(was_flow_augmented){
 				reachable[my_target_side].reset(assimilated[my_target_side]);
-				auto on_new_node = [&](int x){return true;};
-				auto should_follow_arc = [&](int xy){ return !is_backward_saturated(xy); };
+				FLOW_CUTTER_INSTRUMENT(count_reset(my_target_side);)
+				auto on_new_node = [&](int x){
+					FLOW_CUTTER_INSTRUMENT(++counters.reachable_scanned_node_count;)
+					return true;
+				};
+				auto should_follow_arc = [&](int xy){ 
+					FLOW_CUTTER_INSTRUMENT(++counters.reachable_scanned_arc_count;)
+					return !is_backward_saturated(xy); 
+				};
 				auto on_new_arc = [](int xy){};
 				reachable[my_target_side].grow(graph, tmp, search_algo, on_new_node, should_follow_arc, on_new_arc);
 			}
@@ -668,20 +1044,43 @@ namespace flow_cutter{
 				return this->is_saturated(graph, target_side, xy);
 			};
 
-			if(reachable[source_side].node_count_inside() <= reachable[target_side].node_count_inside()){
-				auto on_new_node = [&](int x){return true;};
-				auto should_follow_arc = [&](int xy){ return !is_forward_saturated(xy); };
-				auto on_new_arc = [](int xy){};
+			// Assimilating the lighter side yields the more balanced of both cuts.
+			if(reachable[source_side].node_weight_inside() <= reachable[target_side].node_weight_inside()){
+				auto on_new_node = [&](int x){
+					FLOW_CUTTER_INSTRUMENT(++counters.assimilated_scanned_node_count;)
+					return true;
+				};
+				auto should_follow_arc = [&](int xy){ 
+					FLOW_CUTTER_INSTRUMENT(++counters.assimilated_scanned_arc_count;)
+					return !is_forward_saturated(xy); 
+				};
 				auto has_flow = [&](int xy){ return flow(xy) != 0; };
-				assimilated[source_side].grow(graph, tmp, search_algo, on_new_node, should_follow_arc, on_new_arc, has_flow);
-				assimilated[source_side].shrink_cut_front(graph);
+				auto on_new_front_arc = [&](int xy, int stamp){
+					FLOW_CUTTER_INSTRUMENT(++counters.cut_front_added_arc_count;)
+					if(!pierce_queue[source_side].must_rebuild)
+						pierce_queue[source_side].new_arcs.push_back({xy, stamp});
+				};
+				FLOW_CUTTER_INSTRUMENT(long long front_size = assimilated[source_side].get_cut_front_size() - counters.cut_front_added_arc_count;)
+				assimilated[source_side].grow(graph, tmp, search_algo, cut_front_pos, on_new_node, should_follow_arc, on_new_front_arc, has_flow);
+				FLOW_CUTTER_INSTRUMENT(counters.cut_front_removed_arc_count += front_size + counters.cut_front_added_arc_count - assimilated[source_side].get_cut_front_size();)
 			}else{
-				auto on_new_node = [&](int x){return true;};
-				auto should_follow_arc = [&](int xy){ return !is_backward_saturated(xy); };
-				auto on_new_arc = [](int xy){};
+				auto on_new_node = [&](int x){
+					FLOW_CUTTER_INSTRUMENT(++counters.assimilated_scanned_node_count;)
+					return true;
+				};
+				auto should_follow_arc = [&](int xy){ 
+					FLOW_CUTTER_INSTRUMENT(++counters.assimilated_scanned_arc_count;)
+					return !is_backward_saturated(xy); 
+				};
 				auto has_flow = [&](int xy){ return flow(xy) != 0; };
-				assimilated[target_side].grow(graph, tmp, search_algo, on_new_node, should_follow_arc, on_new_arc, has_flow);
-				assimilated[target_side].shrink_cut_front(graph);
+				auto on_new_front_arc = [&](int xy, int stamp){
+					FLOW_CUTTER_INSTRUMENT(++counters.cut_front_added_arc_count;)
+					if(!pierce_queue[target_side].must_rebuild)
+						pierce_queue[target_side].new_arcs.push_back({xy, stamp});
+				};
+				FLOW_CUTTER_INSTRUMENT(long long front_size = assimilated[target_side].get_cut_front_size() - counters.cut_front_added_arc_count;)
+				assimilated[target_side].grow(graph, tmp, search_algo, cut_front_pos, on_new_node, should_follow_arc, on_new_front_arc, has_flow);
+				FLOW_CUTTER_INSTRUMENT(counters.cut_front_removed_arc_count += front_size + counters.cut_front_added_arc_count - assimilated[target_side].get_cut_front_size();)
 			}
 		}
 
@@ -715,7 +1114,7 @@ namespace flow_cutter{
 			check_flow_conservation(graph);
 
 			int smaller_reachable_side;
-			if(reachable[source_side].node_count_inside() <= reachable[target_side].node_count_inside())
+			if(reachable[source_side].node_weight_inside() <= reachable[target_side].node_weight_inside())
 				smaller_reachable_side = source_side;
 			else
 				smaller_reachable_side = target_side;
@@ -732,7 +1131,13 @@ namespace flow_cutter{
 		AssimilatedNodeSet assimilated[2];
 		ReachableNodeSet reachable[2];
 		UnitFlow flow;
+		ArrayIDFunc<int>cut_front_pos;
 		bool cut_available;
+		PierceCandidateQueue pierce_queue[2];
+		int cached_pierce_side, cached_pierce_node;
+		#ifdef FLOW_CUTTER_INSTRUMENTATION
+		instrumentation::Counters counters;
+		#endif
 	};
 
 
@@ -745,10 +1150,11 @@ namespace flow_cutter{
 
 	class DistanceAwareCutter{
 	private:
-		template<class Graph>
-		static void compute_hop_distance_from(const Graph&graph, TemporaryData&tmp, int source, ArrayIDFunc<int>&dist){
+		template<class Graph, class SourceList>
+		static void compute_hop_distance_from(const Graph&graph, TemporaryData&tmp, const SourceList&source_list, ArrayIDFunc<int>&dist){
 			dist.fill(std::numeric_limits<int>::max());
-			dist[source] = 0;
+			for(auto source:source_list)
+				dist[source] = 0;
 
 			auto was_node_seen = [&](int x){return false;};
 			auto see_node = [](int x){ return true; };
@@ -761,14 +1167,18 @@ namespace flow_cutter{
 				}
 			};
 			auto on_new_arc = [&](int xy){};
-			BreadthFirstSearch()(graph, tmp, source, was_node_seen, see_node, should_follow_arc, on_new_arc);
+			// The searches only follow arcs that decrease a distance and thus the result does not
+			// depend on the order of the sources.
+			for(auto source:source_list)
+				BreadthFirstSearch()(graph, tmp, source, was_node_seen, see_node, should_follow_arc, on_new_arc);
 		}
 
-		template<class Graph>
-		static void compute_weighted_distance_from(const Graph&graph, TemporaryData&tmp, int source, ArrayIDFunc<int>&dist){
+		template<class Graph, class SourceList>
+		static void compute_weighted_distance_from(const Graph&graph, TemporaryData&tmp, const SourceList&source_list, ArrayIDFunc<int>&dist){
 			Dijkstra<BitIDFunc>dij(graph.node_count());
 			dij.clear();
-			dij.add_source_node(source);
+			for(auto source:source_list)
+				dij.add_source_node(source);
 			while(!dij.is_finished())
 				dij.settle_next(graph.out_arc, graph.head, graph.arc_weight, [](int,bool,int){});
 			dist = dij.move_distance_array();
@@ -780,20 +1190,29 @@ namespace flow_cutter{
 			cutter(graph), 
 			node_dist{ArrayIDFunc<int>{graph.node_count()}, ArrayIDFunc<int>{graph.node_count()}}{}
 
-		template<class Graph, class SearchAlgorithm>
-		void init(const Graph&graph, TemporaryData&tmp, const SearchAlgorithm&search_algo, DistanceType dist_type, SourceTargetPair p, int random_seed){
+		//! See BasicCutter::resize.
+		template<class Graph>
+		void resize(const Graph&graph){
+			cutter.resize(graph);
+			node_dist[source_side].discard_and_resize(graph.node_count());
+			node_dist[target_side].discard_and_resize(graph.node_count());
+		}
+
+		//! The distances of terminal sets are the distances to the closest terminal.
+		template<class Graph, class SearchAlgorithm, class Terminals>
+		void init(const Graph&graph, TemporaryData&tmp, const SearchAlgorithm&search_algo, DistanceType dist_type, const Terminals&p, int random_seed){
 			cutter.init(graph, tmp, search_algo, p);
 
 			rng.seed(random_seed);
 
 			switch(dist_type){
 			case DistanceType::hop_distance:
-				compute_hop_distance_from(graph, tmp, p.source, node_dist[source_side]);
-				compute_hop_distance_from(graph, tmp, p.target, node_dist[target_side]);
+				compute_hop_distance_from(graph, tmp, get_source_list(p), node_dist[source_side]);
+				compute_hop_distance_from(graph, tmp, get_target_list(p), node_dist[target_side]);
 				break;
 			case DistanceType::weighted_distance:
-				compute_weighted_distance_from(graph, tmp, p.source, node_dist[source_side]);
-				compute_weighted_distance_from(graph, tmp, p.target, node_dist[target_side]);
+				compute_weighted_distance_from(graph, tmp, get_source_list(p), node_dist[source_side]);
+				compute_weighted_distance_from(graph, tmp, get_target_list(p), node_dist[target_side]);
 				break;
 			case DistanceType::no_distance:
 				break;
@@ -842,6 +1261,10 @@ namespace flow_cutter{
 			return cutter.get_current_cut();
 		}
 
+		int get_current_cut_size()const{
+			return cutter.get_current_cut_size();
+		}
+
 		int get_assimilated_node_count()const{
 			return cutter.get_assimilated_node_count();
 		}
@@ -853,6 +1276,16 @@ namespace flow_cutter{
 		bool is_empty()const{
 			return node_dist[0].preimage_count() == 0;
 		}
+
+		#ifdef FLOW_CUTTER_INSTRUMENTATION
+		instrumentation::Counters&get_instrumentation_counters(){
+			return cutter.get_instrumentation_counters();
+		}
+
+		const instrumentation::Counters&get_instrumentation_counters()const{
+			return cutter.get_instrumentation_counters();
+		}
+		#endif
 	private:
 		BasicCutter cutter;
 		ArrayIDFunc<int>node_dist[2];
@@ -863,14 +1296,19 @@ namespace flow_cutter{
 	public:
 		MultiCutter(){}
 
-		template<class Graph, class SearchAlgorithm,  class ScorePierceNode>
+		//! Every instance gets the terminals p[i], which are SourceTargetPairs or SourceTargetSets.
+		template<class Graph, class SearchAlgorithm,  class ScorePierceNode, class Terminals>
 		void init(
 			const Graph&graph, std::vector<TemporaryData>&tmp, 
 			const SearchAlgorithm&search_algo, const ScorePierceNode&score_pierce_node, DistanceType dist_type, 
-			const std::vector<SourceTargetPair>&p, int random_seed, bool should_skip_non_maximum_sides = true
+			const std::vector<Terminals>&p, int random_seed, bool should_skip_non_maximum_sides = true
 		){
 			while(cutter_list.size() > p.size())
 				cutter_list.pop_back(); // can not use resize because that requires default constructor...
+			// The remaining cutters can stem from an enumeration on another graph, for example of a
+			// CutterStatePool, and are resized while retaining their memory.
+			for(auto&x:cutter_list)
+				x.resize(graph);
 			while(cutter_list.size() < p.size())
 				cutter_list.emplace_back(graph);
 
@@ -884,10 +1322,12 @@ namespace flow_cutter{
 						return score_pierce_node(x, side, causes_augmenting_path, arc_weight, source_dist, target_dist, i);
 					};
 
+					FLOW_CUTTER_INSTRUMENT(long long wall_time = -get_micro_time();)
 					x.init(graph, tmp[thread_id], search_algo, dist_type, p[i], random_seed+1+i);
 					if(should_skip_non_maximum_sides)
 						while(!x.does_next_advance_increase_cut(graph, my_score_pierce_node))
 							x.advance(graph, tmp[thread_id], search_algo, my_score_pierce_node);
+					FLOW_CUTTER_INSTRUMENT(x.get_instrumentation_counters().wall_time_musec += wall_time + get_micro_time();)
 				}
 			}		
 
@@ -898,14 +1338,14 @@ namespace flow_cutter{
 			for(int i=0; i<(int)p.size(); ++i){
 				auto&x = cutter_list[i];
 				if(
-					(int)x.get_current_cut().size() < best_cut_size
+					(int)x.get_current_cut_size() < best_cut_size
 					|| (
-						(int)x.get_current_cut().size() == best_cut_size && 
+						(int)x.get_current_cut_size() == best_cut_size && 
 						x.get_current_smaller_cut_side_size() > best_cutter_weight
 					)
 				){
 					best_cutter_id = i;
-					best_cut_size = x.get_current_cut().size();
+					best_cut_size = x.get_current_cut_size();
 					best_cutter_weight = x.get_current_smaller_cut_side_size();
 				}
 			}
@@ -922,10 +1362,10 @@ namespace flow_cutter{
 
 		template<class Graph, class SearchAlgorithm, class ScorePierceNode>
 		bool advance(const Graph&graph, std::vector<TemporaryData>&tmp, const SearchAlgorithm&search_algo, const ScorePierceNode&score_pierce_node, bool should_skip_non_maximum_sides = true){
-			if(graph.node_count() /2 == get_current_smaller_cut_side_size())
+			if(graph.total_node_weight() /2 == get_current_smaller_cut_side_size())
 				return false;
 
-			int current_cut_size = cutter_list[current_cutter_id].get_current_cut().size();
+			int current_cut_size = cutter_list[current_cutter_id].get_current_cut_size();
 			for(;;){
 				
 
@@ -938,11 +1378,12 @@ namespace flow_cutter{
 						auto my_score_pierce_node = [&](int x, int side, bool causes_augmenting_path, int arc_weight, int source_dist, int target_dist){
 							return score_pierce_node(x, side, causes_augmenting_path, arc_weight, source_dist, target_dist, i);
 						};
+						FLOW_CUTTER_INSTRUMENT(long long wall_time = -get_micro_time();)
 						if(x.is_cut_available()){
-							if((int)x.get_current_cut().size() == current_cut_size){
+							if((int)x.get_current_cut_size() == current_cut_size){
 								assert(x.does_next_advance_increase_cut(graph, my_score_pierce_node));
 								if(x.advance(graph, tmp[thread_id], search_algo, my_score_pierce_node)){
-									assert((int)x.get_current_cut().size() > current_cut_size);
+									assert((int)x.get_current_cut_size() > current_cut_size);
 									while(!x.does_next_advance_increase_cut(graph, my_score_pierce_node)){
 										if(!x.advance(graph, tmp[thread_id], search_algo, my_score_pierce_node))
 											break;
@@ -952,6 +1393,7 @@ namespace flow_cutter{
 								}
 							}
 						}
+						FLOW_CUTTER_INSTRUMENT(x.get_instrumentation_counters().wall_time_musec += wall_time + get_micro_time();)
 
 						cutter_list[i] = std::move(x);
 					}
@@ -960,7 +1402,7 @@ namespace flow_cutter{
 				int next_cut_size = std::numeric_limits<int>::max();
 				for(auto&x:cutter_list)
 					if(x.is_cut_available())
-						min_to(next_cut_size, (int)x.get_current_cut().size());
+						min_to(next_cut_size, (int)x.get_current_cut_size());
 
 				if(next_cut_size == std::numeric_limits<int>::max())
 					return false;
@@ -971,7 +1413,7 @@ namespace flow_cutter{
 				for(int i=0; i<(int)cutter_list.size(); ++i){
 					if(cutter_list[i].is_cut_available()){
 						if(
-							(int)cutter_list[i].get_current_cut().size() == next_cut_size &&
+							(int)cutter_list[i].get_current_cut_size() == next_cut_size &&
 							cutter_list[i].get_current_smaller_cut_side_size() > best_cutter_weight
 						){
 							best_cutter_id = i;
@@ -1005,194 +1447,441 @@ namespace flow_cutter{
 			return cutter_list[current_cutter_id].get_current_cut();
 		}
 
+		int get_current_cut_size()const{
+			return cutter_list[current_cutter_id].get_current_cut_size();
+		}
+
 		int get_current_cutter_id()const{
 			return current_cutter_id;
 		}
 
+		//! The counters of every instance. Empty if the instrumentation is disabled.
+		std::vector<instrumentation::Counters>get_instrumentation_counters_of_every_cutter()const{
+			std::vector<instrumentation::Counters>c;
+			#ifdef FLOW_CUTTER_INSTRUMENTATION
+			for(auto&x:cutter_list)
+				c.push_back(x.get_instrumentation_counters());
+			#endif
+			return c; // NVRO
+		}
+
+		instrumentation::Counters get_instrumentation_counters()const{
+			instrumentation::Counters sum;
+			for(auto&c:get_instrumentation_counters_of_every_cutter())
+				sum += c;
+			return sum;
+		}
+
 	private:
 		std::vector<DistanceAwareCutter>cutter_list;
 		int current_smaller_side_size;
 		int current_cutter_id;
 	};
 
-	struct PierceNodeScore{
+	//! The memory of a SimpleCutter that can outlive it and be reused by the next one.
+	struct CutterState{
+		CutterState():max_node_count(0){}
+
+		std::vector<TemporaryData>tmp;
+		MultiCutter cutter;
+		int max_node_count;
+	};
+
+	// Computing a nested dissection runs a cut enumeration on every subgraph of the recursion and
+	// most of them are tiny. Allocating the cutters, their node sets, flows and distance arrays
+	// anew for each of them dominates the running time at the bottom of the recursion. A pool
+	// keeps the CutterStates of finished enumerations. Their arrays retain their memory when
+	// resized to a smaller graph and are only reallocated if a graph is larger than all graphs
+	// before. The pool is thread-safe and every concurrent enumeration gets a state of its own.
+	class CutterStatePool{
+	private:
+		struct ReturnToPool{
+			std::shared_ptr<CutterStatePool>pool;
+
+			void operator()(CutterState*state)const{
+				if(pool)
+					pool->release(state);
+				else
+					delete state;
+			}
+		};
+
+	public:
+		typedef std::unique_ptr<CutterState, ReturnToPool> Handle;
+
+		CutterStatePool(){}
+		CutterStatePool(const CutterStatePool&) = delete;
+		CutterStatePool&operator=(const CutterStatePool&) = delete;
+
+		~CutterStatePool(){
+			for(auto x:free_state_list)
+				delete x;
+		}
+
+		//! Takes the state out of the pool whose max_node_count is the smallest one not below
+		//! node_count, or the largest one if there is none. Creates a new state if the pool is
+		//! empty or null. The state is returned to the pool when the handle is destroyed.
+		static Handle acquire(const std::shared_ptr<CutterStatePool>&pool, int node_count){
+			CutterState*state = nullptr;
+			if(pool)
+				state = pool->take(node_count);
+			if(state == nullptr)
+				state = new CutterState;
+			max_to(state->max_node_count, node_count);
+			return Handle(state, ReturnToPool{pool});
+		}
+
+		int get_free_state_count()const{
+			std::lock_guard<std::mutex>lock(mutex);
+			return free_state_list.size();
+		}
+
+	private:
+		CutterState*take(int node_count){
+			std::lock_guard<std::mutex>lock(mutex);
+			if(free_state_list.empty())
+				return nullptr;
+			int best = 0;
+			for(int i=1; i<(int)free_state_list.size(); ++i){
+				int best_size = free_state_list[best]->max_node_count;
+				int size = free_state_list[i]->max_node_count;
+				if(best_size < node_count ? size > best_size : (size >= node_count && size < best_size))
+					best = i;
+			}
+			CutterState*state = free_state_list[best];
+			free_state_list[best] = free_state_list.back();
+			free_state_list.pop_back();
+			return state;
+		}
+
+		void release(CutterState*state){
+			std::lock_guard<std::mutex>lock(mutex);
+			free_state_list.push_back(state);
+		}
+
+		mutable std::mutex mutex;
+		std::vector<CutterState*>free_state_list;
+	};
+
+	//! The pseudo random numbers used by the random pierce ratings. They are a hash of the node and
+	//! the side and therefore do not change during the cut enumeration.
+	struct PierceNodeHash{
 		static constexpr unsigned hash_modulo = ((1u<<31u)-1u);
 		unsigned hash_factor, hash_offset;
 
-		PierceNodeScore(Config config): config(config){
+		explicit PierceNodeHash(int random_seed){
 			std::mt19937 gen;
-			gen.seed(config.random_seed);
+			gen.seed(random_seed);
 			gen();
 			hash_factor = gen() % hash_modulo;
 			hash_offset = gen() % hash_modulo;
 		}
 
-		Config config;
+		unsigned operator()(int x, int side)const{
+			if(side == BasicCutter::source_side)
+				return (hash_factor * (unsigned)(x<<1) + hash_offset) % hash_modulo;
+			else
+				return (hash_factor * ((unsigned)(x<<1)+1) + hash_offset) % hash_modulo;
+		}
+	};
 
+	//! If rating and avoid are compile time constants, then the switches are folded away.
+	inline int compute_pierce_node_score(
+		Config::PierceRating rating, Config::AvoidAugmentingPath avoid, const PierceNodeHash&random_number,
+		int x, int side, bool causes_augmenting_path, int arc_weight, int source_dist, int target_dist
+	){
+		int score;
+		switch(rating){
+		case Config::PierceRating::max_target_minus_source_hop_dist: 
+		case Config::PierceRating::max_target_minus_source_weight_dist: 
+			score = target_dist - source_dist; 
+			break;
+		case Config::PierceRating::max_target_hop_dist: 
+		case Config::PierceRating::max_target_weight_dist: 
+			score = target_dist; 
+			break;
+		case Config::PierceRating::min_source_hop_dist: 
+		case Config::PierceRating::min_source_weight_dist: 
+			score = -source_dist; 
+			break;
+		case Config::PierceRating::oldest:
+			score = 0;
+			break;
+		case Config::PierceRating::random:
+			score = random_number(x, side);			
+			break;
+		case Config::PierceRating::max_arc_weight:
+			score = arc_weight;
+			break;
+		case Config::PierceRating::min_arc_weight:
+			score = -arc_weight;
+			break;
+
+		case Config::PierceRating::circular_hop:
+		case Config::PierceRating::circular_weight:
+			if(side == BasicCutter::source_side)
+				return -source_dist;
+			else
+				return target_dist;
+			break;
+		
 
-		int operator()(int x, int side, bool causes_augmenting_path, int arc_weight, int source_dist, int target_dist, int cutter_id)const{
+		default:
+			assert(false);
+			score = 0;
+		}	
+		switch(avoid){
+		case Config::AvoidAugmentingPath::avoid_and_pick_best:
+			if(causes_augmenting_path)
+				score -= 1000000000;
+			break;
+		case Config::AvoidAugmentingPath::do_not_avoid:
+			break;
+		case Config::AvoidAugmentingPath::avoid_and_pick_oldest:
+			if(causes_augmenting_path)
+				score = -1000000000;
+			break;
+		case Config::AvoidAugmentingPath::avoid_and_pick_random:
+			if(causes_augmenting_path)
+				score = random_number(x, side) - 1000000000;
+			break;
+		default:
+			assert(false);
+			score = 0;
+		}
+		return score;
+	}
 
-			auto random_number = [&]{
-				if(side == BasicCutter::source_side)
-					return (hash_factor * (unsigned)(x<<1) + hash_offset) % hash_modulo;
-				else
-					return (hash_factor * ((unsigned)(x<<1)+1) + hash_offset) % hash_modulo;
-			};
+	//! Evaluates the rating and the avoid policy of the config at run time.
+	struct PierceNodeScore{
+		PierceNodeScore(Config config): config(config), random_number(config.random_seed){}
+		PierceNodeScore(Config config, PierceNodeHash random_number): config(config), random_number(random_number){}
 
-			int score;
-			switch(config.pierce_rating){
-			case Config::PierceRating::max_target_minus_source_hop_dist: 
-			case Config::PierceRating::max_target_minus_source_weight_dist: 
-				score = target_dist - source_dist; 
-				break;
-			case Config::PierceRating::max_target_hop_dist: 
-			case Config::PierceRating::max_target_weight_dist: 
-				score = target_dist; 
-				break;
-			case Config::PierceRating::min_source_hop_dist: 
-			case Config::PierceRating::min_source_weight_dist: 
-				score = -source_dist; 
-				break;
-			case Config::PierceRating::oldest:
-				score = 0;
-				break;
-			case Config::PierceRating::random:
-				score = random_number();			
-				break;
-			case Config::PierceRating::max_arc_weight:
-				score = arc_weight;
-				break;
-			case Config::PierceRating::min_arc_weight:
-				score = -arc_weight;
-				break;
+		Config config;
+		PierceNodeHash random_number;
 
-			case Config::PierceRating::circular_hop:
-			case Config::PierceRating::circular_weight:
-				if(side == BasicCutter::source_side)
-					return -source_dist;
-				else
-					return target_dist;
-				break;
-			
+		int operator()(int x, int side, bool causes_augmenting_path, int arc_weight, int source_dist, int target_dist, int cutter_id)const{
+			return compute_pierce_node_score(config.pierce_rating, config.avoid_augmenting_path, random_number, x, side, causes_augmenting_path, arc_weight, source_dist, target_dist);
+		}
+	};
 
-			default:
-				assert(false);
-				score = 0;
-			}	
-			switch(config.avoid_augmenting_path){
-			case Config::AvoidAugmentingPath::avoid_and_pick_best:
-				if(causes_augmenting_path)
-					score -= 1000000000;
-				break;
-			case Config::AvoidAugmentingPath::do_not_avoid:
-				break;
-			case Config::AvoidAugmentingPath::avoid_and_pick_oldest:
-				if(causes_augmenting_path)
-					score = -1000000000;
-				break;
-			case Config::AvoidAugmentingPath::avoid_and_pick_random:
-				if(causes_augmenting_path)
-					score = random_number() - 1000000000;
-				break;
-			default:
-				assert(false);
-				score = 0;
-			}
-			return score;
+	//! The same scores as PierceNodeScore with the rating and the avoid policy fixed at compile time.
+	template<Config::PierceRating rating, Config::AvoidAugmentingPath avoid>
+	struct SpecializedPierceNodeScore{
+		SpecializedPierceNodeScore(const Config&config, PierceNodeHash random_number):random_number(random_number){
+			assert(config.avoid_augmenting_path == avoid || rating == Config::PierceRating::circular_hop);
+		}
+
+		PierceNodeHash random_number;
+
+		int operator()(int x, int side, bool causes_augmenting_path, int arc_weight, int source_dist, int target_dist, int cutter_id)const{
+			return compute_pierce_node_score(rating, avoid, random_number, x, side, causes_augmenting_path, arc_weight, source_dist, target_dist);
 		}
 	};
 
+	inline
+	DistanceType get_distance_type(const Config&config){
+		if(
+			config.pierce_rating == Config::PierceRating::min_source_hop_dist || 
+			config.pierce_rating == Config::PierceRating::max_target_hop_dist || 
+			config.pierce_rating == Config::PierceRating::max_target_minus_source_hop_dist || 
+			config.pierce_rating == Config::PierceRating::circular_hop
+		)
+			return DistanceType::hop_distance;
+		else if(
+			config.pierce_rating == Config::PierceRating::min_source_weight_dist || 
+			config.pierce_rating == Config::PierceRating::max_target_weight_dist || 
+			config.pierce_rating == Config::PierceRating::max_target_minus_source_weight_dist ||
+			config.pierce_rating == Config::PierceRating::circular_weight
+		)
+			return DistanceType::weighted_distance;
+		else
+			return DistanceType::no_distance;
+	}
+
+	// SimpleCutter selects the search algorithm and the pierce node score once in the constructor.
+	// The default pierce rating and avoid policy use a SpecializedPierceNodeScore, the others the
+	// PierceNodeScore. Every score type is a separate instantiation of the cutter's advance code and
+	// specializing all combinations triples the compile time of the console. Define
+	// FLOW_CUTTER_SPECIALIZE_EVERY_PIERCE_RATING to specialize all of them anyway. Ratings with the
+	// same formula share an instantiation.
 	template<class Graph>
 	class SimpleCutter{
 	public:
-		SimpleCutter(const Graph&graph, Config config):
-			graph(graph), tmp(config.thread_count, TemporaryData(graph.node_count())), config(config){
-		}
-
-		void init(const std::vector<SourceTargetPair>&p, int random_seed){
-			DistanceType dist_type;
-
-			if(
-				config.pierce_rating == Config::PierceRating::min_source_hop_dist || 
-				config.pierce_rating == Config::PierceRating::max_target_hop_dist || 
-				config.pierce_rating == Config::PierceRating::max_target_minus_source_hop_dist || 
-				config.pierce_rating == Config::PierceRating::circular_hop
-			)
-				dist_type = DistanceType::hop_distance;
-			else if(
-				config.pierce_rating == Config::PierceRating::min_source_weight_dist || 
-				config.pierce_rating == Config::PierceRating::max_target_weight_dist || 
-				config.pierce_rating == Config::PierceRating::max_target_minus_source_weight_dist ||
-				config.pierce_rating == Config::PierceRating::circular_weight
-			)
-				dist_type = DistanceType::weighted_distance;
-			else
-				dist_type = DistanceType::no_distance;
+		//! If pool is not null then the memory is taken from and later returned to it.
+		SimpleCutter(const Graph&graph, Config config, const std::shared_ptr<CutterStatePool>&pool = nullptr):
+			graph(graph), state(CutterStatePool::acquire(pool, graph.node_count())), config(config), random_number(config.random_seed){
+			state->tmp.resize(config.thread_count);
+			for(auto&x:state->tmp)
+				x.resize(graph.node_count());
 
 			switch(config.graph_search_algorithm){
 			case Config::GraphSearchAlgorithm::pseudo_depth_first_search:
-				cutter.init(graph, tmp, PseudoDepthFirstSearch(), PierceNodeScore(config), dist_type, p, random_seed, config.skip_non_maximum_sides == Config::SkipNonMaximumSides::skip);
+				select_pierce_rating<PseudoDepthFirstSearch>();
 				break;
-			
 			case Config::GraphSearchAlgorithm::breadth_first_search:
-				cutter.init(graph, tmp, BreadthFirstSearch(), PierceNodeScore(config), dist_type, p, random_seed, config.skip_non_maximum_sides == Config::SkipNonMaximumSides::skip);
+				select_pierce_rating<BreadthFirstSearch>();
 				break;
-		
 			case Config::GraphSearchAlgorithm::depth_first_search:
-				throw std::runtime_error("depth first search is not yet implemented");
+				init_func = nullptr;
+				init_from_sets_func = nullptr;
+				advance_func = nullptr;
+				break;
 			default:
 				assert(false);
-				
 			}
 		}
 
-		bool advance(){
+		void init(const std::vector<SourceTargetPair>&p, int random_seed){
+			if(init_func == nullptr)
+				throw std::runtime_error("depth first search is not yet implemented");
+			(this->*init_func)(p, random_seed);
+		}
 
-			switch(config.graph_search_algorithm){
-			case Config::GraphSearchAlgorithm::pseudo_depth_first_search:
-				return cutter.advance(graph, tmp, PseudoDepthFirstSearch(), PierceNodeScore(config), config.skip_non_maximum_sides == Config::SkipNonMaximumSides::skip);
-			
-			case Config::GraphSearchAlgorithm::breadth_first_search:
-				return cutter.advance(graph, tmp, BreadthFirstSearch(), PierceNodeScore(config), config.skip_non_maximum_sides == Config::SkipNonMaximumSides::skip);
-		
-			case Config::GraphSearchAlgorithm::depth_first_search:
+		void init(const std::vector<SourceTargetSets>&p, int random_seed){
+			if(init_from_sets_func == nullptr)
 				throw std::runtime_error("depth first search is not yet implemented");
-			default:
-				assert(false);
-				return false;
-			}
+			(this->*init_from_sets_func)(p, random_seed);
+		}
+
+		bool advance(){
+			if(advance_func == nullptr)
+				throw std::runtime_error("depth first search is not yet implemented");
+			return (this->*advance_func)();
 		}
 
 		CutterStateDump dump_state()const{
-			return cutter.dump_state();
+			return state->cutter.dump_state();
 		}
 
 		int get_current_smaller_cut_side_size()const{
-			return cutter.get_current_smaller_cut_side_size();
+			return state->cutter.get_current_smaller_cut_side_size();
 		}
 
 		bool is_on_smaller_side(int x)const{
-			return cutter.is_on_smaller_side(x);
+			return state->cutter.is_on_smaller_side(x);
 		}
 
 		const std::vector<int>&get_current_cut()const{
-			return cutter.get_current_cut();
+			return state->cutter.get_current_cut();
+		}
+
+		int get_current_cut_size()const{
+			return state->cutter.get_current_cut_size();
 		}
 
 		int get_current_cutter_id()const{
-			return cutter.get_current_cutter_id();
+			return state->cutter.get_current_cutter_id();
+		}
+
+		std::vector<instrumentation::Counters>get_instrumentation_counters_of_every_cutter()const{
+			return state->cutter.get_instrumentation_counters_of_every_cutter();
+		}
+
+		instrumentation::Counters get_instrumentation_counters()const{
+			return state->cutter.get_instrumentation_counters();
 		}
 
 	private:
+		template<class SearchAlgorithm, class ScorePierceNode, class Terminals>
+		void init_with(const std::vector<Terminals>&p, int random_seed){
+			state->cutter.init(graph, state->tmp, SearchAlgorithm(), ScorePierceNode(config, random_number), get_distance_type(config), p, random_seed, config.skip_non_maximum_sides == Config::SkipNonMaximumSides::skip);
+		}
+
+		template<class SearchAlgorithm, class ScorePierceNode>
+		bool advance_with(){
+			return state->cutter.advance(graph, state->tmp, SearchAlgorithm(), ScorePierceNode(config, random_number), config.skip_non_maximum_sides == Config::SkipNonMaximumSides::skip);
+		}
+
+		#ifdef FLOW_CUTTER_SPECIALIZE_EVERY_PIERCE_RATING
+		template<class SearchAlgorithm, Config::PierceRating rating>
+		void select_avoid_augmenting_path(){
+			switch(config.avoid_augmenting_path){
+			case Config::AvoidAugmentingPath::avoid_and_pick_best:
+				select<SearchAlgorithm, SpecializedPierceNodeScore<rating, Config::AvoidAugmentingPath::avoid_and_pick_best>>();
+				break;
+			case Config::AvoidAugmentingPath::do_not_avoid:
+				select<SearchAlgorithm, SpecializedPierceNodeScore<rating, Config::AvoidAugmentingPath::do_not_avoid>>();
+				break;
+			case Config::AvoidAugmentingPath::avoid_and_pick_oldest:
+				select<SearchAlgorithm, SpecializedPierceNodeScore<rating, Config::AvoidAugmentingPath::avoid_and_pick_oldest>>();
+				break;
+			case Config::AvoidAugmentingPath::avoid_and_pick_random:
+				select<SearchAlgorithm, SpecializedPierceNodeScore<rating, Config::AvoidAugmentingPath::avoid_and_pick_random>>();
+				break;
+			default:
+				assert(false);
+			}
+		}
+		#endif
+
+		template<class SearchAlgorithm>
+		void select_pierce_rating(){
+			#ifndef FLOW_CUTTER_SPECIALIZE_EVERY_PIERCE_RATING
+			if(
+				(config.pierce_rating == Config::PierceRating::max_target_minus_source_hop_dist ||
+				config.pierce_rating == Config::PierceRating::max_target_minus_source_weight_dist) &&
+				config.avoid_augmenting_path == Config::AvoidAugmentingPath::avoid_and_pick_best
+			)
+				select<SearchAlgorithm, SpecializedPierceNodeScore<Config::PierceRating::max_target_minus_source_hop_dist, Config::AvoidAugmentingPath::avoid_and_pick_best>>();
+			else
+				select<SearchAlgorithm, PierceNodeScore>();
+			#else
+			switch(config.pierce_rating){
+			case Config::PierceRating::max_target_minus_source_hop_dist: 
+			case Config::PierceRating::max_target_minus_source_weight_dist: 
+				select_avoid_augmenting_path<SearchAlgorithm, Config::PierceRating::max_target_minus_source_hop_dist>();
+				break;
+			case Config::PierceRating::max_target_hop_dist: 
+			case Config::PierceRating::max_target_weight_dist: 
+				select_avoid_augmenting_path<SearchAlgorithm, Config::PierceRating::max_target_hop_dist>();
+				break;
+			case Config::PierceRating::min_source_hop_dist: 
+			case Config::PierceRating::min_source_weight_dist: 
+				select_avoid_augmenting_path<SearchAlgorithm, Config::PierceRating::min_source_hop_dist>();
+				break;
+			case Config::PierceRating::oldest:
+				select_avoid_augmenting_path<SearchAlgorithm, Config::PierceRating::oldest>();
+				break;
+			case Config::PierceRating::random:
+				select_avoid_augmenting_path<SearchAlgorithm, Config::PierceRating::random>();
+				break;
+			case Config::PierceRating::max_arc_weight:
+				select_avoid_augmenting_path<SearchAlgorithm, Config::PierceRating::max_arc_weight>();
+				break;
+			case Config::PierceRating::min_arc_weight:
+				select_avoid_augmenting_path<SearchAlgorithm, Config::PierceRating::min_arc_weight>();
+				break;
+			case Config::PierceRating::circular_hop:
+			case Config::PierceRating::circular_weight:
+				// The avoid policy does not affect circular ratings.
+				select<SearchAlgorithm, SpecializedPierceNodeScore<Config::PierceRating::circular_hop, Config::AvoidAugmentingPath::do_not_avoid>>();
+				break;
+			default:
+				assert(false);
+			}
+			#endif
+		}
+
+		template<class SearchAlgorithm, class ScorePierceNode>
+		void select(){
+			init_func = &SimpleCutter::init_with<SearchAlgorithm, ScorePierceNode, SourceTargetPair>;
+			init_from_sets_func = &SimpleCutter::init_with<SearchAlgorithm, ScorePierceNode, SourceTargetSets>;
+			advance_func = &SimpleCutter::advance_with<SearchAlgorithm, ScorePierceNode>;
+		}
+
 		const Graph&graph;
-		std::vector<TemporaryData>tmp;
-		MultiCutter cutter;
+		CutterStatePool::Handle state;
 		Config config;
+		PierceNodeHash random_number;
+		void (SimpleCutter::*init_func)(const std::vector<SourceTargetPair>&, int);
+		void (SimpleCutter::*init_from_sets_func)(const std::vector<SourceTargetSets>&, int);
+		bool (SimpleCutter::*advance_func)();
 	};
 
 	template<class Graph>
-	SimpleCutter<Graph> make_simple_cutter(const Graph&graph, Config config){
-		return SimpleCutter<Graph>(graph, config);
+	SimpleCutter<Graph> make_simple_cutter(const Graph&graph, Config config, const std::shared_ptr<CutterStatePool>&pool = nullptr){
+		return SimpleCutter<Graph>(graph, config, pool);
 	}
 
 	inline 
@@ -1215,6 +1904,49 @@ namespace flow_cutter{
 		}
 		return p;
 	}
+
+	//! Every cutter starts at a random node and walks to the last node s that a breadth first
+	//! search reaches. The sources are the set_fraction*node_count nodes closest to s and the
+	//! targets the same number of nodes farthest from s, where the distance is the BFS order. This
+	//! is the graph analogue of the first and last nodes along a direction of inertial flow.
+	//! Returns no sets if the component of a start node has fewer than two nodes.
+	template<class OutArc, class Head>
+	std::vector<SourceTargetSets>select_bfs_source_target_sets(const OutArc&out_arc, const Head&head, int cutter_count, double set_fraction, int seed){
+		const int node_count = out_arc.preimage_count();
+
+		std::vector<int>queue(node_count);
+		BitIDFunc was_seen(node_count);
+		auto bfs = [&](int source){
+			was_seen.fill(false);
+			was_seen.set(source, true);
+			queue[0] = source;
+			int queue_begin = 0, queue_end = 1;
+			while(queue_begin != queue_end){
+				int x = queue[queue_begin++];
+				for(auto xy:out_arc(x)){
+					int y = head(xy);
+					if(!was_seen(y)){
+						was_seen.set(y, true);
+						queue[queue_end++] = y;
+					}
+				}
+			}
+			return queue_end;
+		};
+
+		std::vector<SourceTargetSets>p(cutter_count);
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> dist(0, node_count-1);
+		for(auto&x:p){
+			int reached_count = bfs(queue[bfs(dist(rng))-1]);
+			if(reached_count < 2)
+				return {};
+			int set_size = std::max(1, std::min(reached_count/2, static_cast<int>(set_fraction*node_count)));
+			x.source_list.assign(queue.begin(), queue.begin()+set_size);
+			x.target_list.assign(queue.begin()+reached_count-set_size, queue.begin()+reached_count);
+		}
+		return p;
+	}
 } 
 
 #endif
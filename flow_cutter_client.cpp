@@ -0,0 +1,317 @@
+#include "server_protocol.h"
+#include "list_graph.h"
+#include "timer.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace server_protocol;
+
+// A small client for flow_cutter_server. Like the console, it executes the commands given as
+// arguments one after another.
+
+namespace{
+	int in_fd = 0, out_fd = 1;
+	uint32_t next_request_id = 0;
+
+	void connect_to(const string&path){
+		if(path == "-"){
+			// Requests go to stdout and responses come from stdin, which allows connecting the
+			// client to a server in stdin/stdout mode over a pair of pipes.
+			in_fd = 0;
+			out_fd = 1;
+			return;
+		}
+		int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if(fd < 0)
+			throw runtime_error("could not create socket");
+		sockaddr_un addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sun_family = AF_UNIX;
+		if(path.size() >= sizeof(addr.sun_path))
+			throw runtime_error("socket path "+path+" is too long");
+		strcpy(addr.sun_path, path.c_str());
+		if(connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0)
+			throw runtime_error("could not connect to "+path);
+		in_fd = out_fd = fd;
+	}
+
+	// Messages go to stderr because stdout may carry the protocol.
+	ostream&message_out = cerr;
+
+	uint32_t send_request(Opcode opcode, const function<void(PayloadWriter&)>&write_body){
+		PayloadWriter out;
+		uint32_t id = next_request_id++;
+		out.write_u32(id);
+		out.write_u8(static_cast<uint8_t>(opcode));
+		write_body(out);
+		write_frame(out_fd, out.get_data());
+		return id;
+	}
+
+	//! Receives the response of any pending request and passes its id and body to on_body. Throws
+	//! if the request failed.
+	void receive_response(const function<void(uint32_t, PayloadReader&)>&on_body){
+		string payload;
+		if(!read_frame(in_fd, payload))
+			throw runtime_error("server closed the connection");
+		PayloadReader body(payload);
+		uint32_t id = body.read_u32();
+		if(static_cast<Status>(body.read_u8()) != Status::ok)
+			throw runtime_error("request "+to_string(id)+" failed : "+body.read_string());
+		on_body(id, body);
+	}
+
+	//! Sends a request and waits for its response.
+	void call(Opcode opcode, const function<void(PayloadWriter&)>&write_body, const function<void(PayloadReader&)>&read_body){
+		send_request(opcode, write_body);
+		receive_response([&](uint32_t, PayloadReader&body){ read_body(body); });
+	}
+
+	// "default" is the default config, otherwise variable value pairs are separated by commas and
+	// joined by =, for example max_imbalance=0.3,cutter_count=5
+	string parse_config(const string&arg){
+		if(arg == "default")
+			return "";
+		string config = arg;
+		replace(config.begin(), config.end(), ',', ' ');
+		replace(config.begin(), config.end(), '=', ' ');
+		return config;
+	}
+
+	vector<int>load_node_list(const string&arg){
+		vector<int>node_list;
+		if(arg == "all")
+			return node_list;
+		ifstream in(arg);
+		if(!in)
+			throw runtime_error("could not open "+arg);
+		int x;
+		while(in >> x)
+			node_list.push_back(x);
+		return node_list; // NVRO
+	}
+
+	void save_node_list(const string&file_name, const vector<int>&l){
+		if(file_name == "-"){
+			for(auto x:l)
+				message_out << x << '\n';
+			return;
+		}
+		ofstream out(file_name);
+		if(!out)
+			throw runtime_error("could not open "+file_name+" for writing");
+		for(auto x:l)
+			out << x << '\n';
+	}
+
+	void print_graph_size(const string&name, PayloadReader&in){
+		int node_count = in.read_u32();
+		int arc_count = in.read_u32();
+		message_out << name << " : " << node_count << " nodes, " << arc_count << " arcs" << endl;
+	}
+
+	struct Command{
+		string name;
+		int parameter_count;
+		string description;
+		function<void(vector<string>)>func;
+	};
+
+	vector<Command>cmd = {
+		{
+			"load_graph", 3,
+			"Lets the server load the graph file arg3 in the format arg2 (dimacs, metis, pace or binary) under the name arg1.",
+			[](vector<string>args){
+				call(
+					Opcode::load_graph_file,
+					[&](PayloadWriter&out){
+						out.write_string(args[0]);
+						out.write_string(args[1]);
+						out.write_string(args[2]);
+					},
+					[&](PayloadReader&in){ print_graph_size(args[0], in); }
+				);
+			}
+		},
+		{
+			"upload_graph", 2,
+			"Loads the DIMACS graph file arg2 locally and sends it to the server as CSR arrays under the name arg1.",
+			[](vector<string>args){
+				auto g = uncached_load_dimacs_graph(args[1]);
+				const int node_count = g.node_count();
+				const int arc_count = g.arc_count();
+
+				vector<int>first_out(node_count+1, 0), head(arc_count), arc_weight(arc_count);
+				for(int i=0; i<arc_count; ++i)
+					++first_out[g.tail(i)+1];
+				for(int x=0; x<node_count; ++x)
+					first_out[x+1] += first_out[x];
+				vector<int>pos(first_out.begin(), first_out.end()-1);
+				for(int i=0; i<arc_count; ++i){
+					int a = pos[g.tail(i)]++;
+					head[a] = g.head(i);
+					arc_weight[a] = g.arc_weight(i);
+				}
+
+				call(
+					Opcode::load_graph_csr,
+					[&](PayloadWriter&out){
+						out.write_string(args[0]);
+						out.write_i32(node_count);
+						out.write_int_list(first_out);
+						out.write_int_list(head);
+						out.write_int_list(arc_weight);
+					},
+					[&](PayloadReader&in){ print_graph_size(args[0], in); }
+				);
+			}
+		},
+		{
+			"drop_graph", 1,
+			"Removes the graph arg1 from the server.",
+			[](vector<string>args){
+				call(Opcode::drop_graph, [&](PayloadWriter&out){ out.write_string(args[0]); }, [](PayloadReader&){});
+			}
+		},
+		{
+			"list_graphs", 0,
+			"Lists the graphs resident in the server.",
+			[](vector<string>){
+				call(
+					Opcode::list_graphs,
+					[](PayloadWriter&){},
+					[](PayloadReader&in){
+						int graph_count = in.read_u32();
+						for(int i=0; i<graph_count; ++i){
+							string name = in.read_string();
+							print_graph_size(name, in);
+						}
+					}
+				);
+			}
+		},
+		{
+			"compute_separator", 5,
+			"Computes a separator of graph arg1 with config arg2 and seed arg3 (-1 for the seed of the config). arg4 is a file with the nodes of the induced subgraph or \"all\". The separator is saved to arg5 or printed if arg5 is -.",
+			[](vector<string>args){
+				vector<int>separator;
+				call(
+					Opcode::compute_separator,
+					[&](PayloadWriter&out){
+						out.write_string(args[0]);
+						out.write_string(parse_config(args[1]));
+						out.write_i32(stoi(args[2]));
+						out.write_int_list(load_node_list(args[3]));
+					},
+					[&](PayloadReader&in){ separator = in.read_int_list(); }
+				);
+				message_out << "separator size : " << separator.size() << endl;
+				save_node_list(args[4], separator);
+			}
+		},
+		{
+			"compute_order", 6,
+			"Computes an order of graph arg1 with config arg2 and seed arg3. arg4 is a file with the nodes of the induced subgraph or \"all\". arg5 is nd for a nested dissection order or cch for a CCH order. The order is saved to arg6 or printed if arg6 is -.",
+			[](vector<string>args){
+				if(args[4] != "nd" && args[4] != "cch")
+					throw runtime_error("order type must be nd or cch");
+				vector<int>order;
+				call(
+					Opcode::compute_order,
+					[&](PayloadWriter&out){
+						out.write_string(args[0]);
+						out.write_string(parse_config(args[1]));
+						out.write_i32(stoi(args[2]));
+						out.write_u8(args[4] == "cch");
+						out.write_int_list(load_node_list(args[3]));
+					},
+					[&](PayloadReader&in){ order = in.read_int_list(); }
+				);
+				save_node_list(args[5], order);
+			}
+		},
+		{
+			"benchmark_separators", 3,
+			"Sends arg3 separator requests for graph arg1 with config arg2 and the seeds 0 to arg3-1 without waiting for the responses in between. Prints the separator size of every seed and the total running time.",
+			[](vector<string>args){
+				int request_count = stoi(args[2]);
+				string config = parse_config(args[1]);
+
+				long long time = -get_micro_time();
+				map<uint32_t, int>seed_of_request;
+				for(int seed=0; seed<request_count; ++seed){
+					uint32_t id = send_request(
+						Opcode::compute_separator,
+						[&](PayloadWriter&out){
+							out.write_string(args[0]);
+							out.write_string(config);
+							out.write_i32(seed);
+							out.write_int_list(vector<int>());
+						}
+					);
+					seed_of_request[id] = seed;
+				}
+
+				vector<int>separator_size(request_count);
+				for(int i=0; i<request_count; ++i)
+					receive_response([&](uint32_t id, PayloadReader&body){
+						separator_size[seed_of_request.at(id)] = body.read_int_list().size();
+					});
+				time += get_micro_time();
+
+				for(int seed=0; seed<request_count; ++seed)
+					message_out << "seed " << seed << " : separator size " << separator_size[seed] << endl;
+				message_out << "running time : " << time << "musec" << endl;
+			}
+		},
+		{
+			"shutdown", 0,
+			"Stops the server after the pending requests are answered.",
+			[](vector<string>){
+				call(Opcode::shutdown, [](PayloadWriter&){}, [](PayloadReader&){});
+			}
+		}
+	};
+}
+
+int main(int argc, char*argv[]){
+	try{
+		if(argc < 2 || string(argv[1]) == "help"){
+			cout << "Usage: " << argv[0] << " socket_path command args command args ...\n\nsocket_path - uses stdin and stdout. Commands:\n\n";
+			for(auto&c:cmd)
+				cout << c.name << " (" << c.parameter_count << " args) : " << c.description << "\n";
+			return 0;
+		}
+
+		connect_to(argv[1]);
+
+		int arg_pos = 2;
+		while(arg_pos != argc){
+			auto c = find_if(cmd.begin(), cmd.end(), [&](const Command&c){ return c.name == argv[arg_pos]; });
+			if(c == cmd.end())
+				throw runtime_error(string("Unknown command ")+argv[arg_pos]);
+			if(arg_pos+1+c->parameter_count > argc)
+				throw runtime_error("Not enough parameters to command "+c->name);
+			vector<string>args(argv+arg_pos+1, argv+arg_pos+1+c->parameter_count);
+			arg_pos += 1+c->parameter_count;
+			c->func(move(args));
+		}
+	}catch(exception&err){
+		cerr << "Exception : " << err.what() << endl;
+		return 1;
+	}
+}
@@ -16,6 +16,11 @@ namespace flow_cutter{
 		int max_cut_size;
 		float max_imbalance;
 		int branch_factor;
+		int inertial_flow_direction_count;
+		int nested_dissection_cutoff_node_count;
+		int nested_dissection_cutoff_tree_width;
+		int nested_dissection_cutoff_tree_width_max_node_count;
+		float terminal_set_fraction;
 
 		enum class SeparatorSelection{
 			node_min_expansion,
@@ -33,6 +38,12 @@ namespace flow_cutter{
 		};
 		AvoidAugmentingPath avoid_augmenting_path;
 
+		enum class InertialFlowPrincipalDirections{
+			no,
+			yes
+		};
+		InertialFlowPrincipalDirections inertial_flow_principal_directions;
+
 		enum class SkipNonMaximumSides{
 			skip,
 			no_skip
@@ -46,6 +57,12 @@ namespace flow_cutter{
 		};
 		GraphSearchAlgorithm graph_search_algorithm;
 
+		enum class InertialFlowMaxFlowAlgorithm{
+			dinic,
+			push_relabel
+		};
+		InertialFlowMaxFlowAlgorithm inertial_flow_max_flow_algorithm;
+
 		enum class DumpState{
 			no,
 			yes
@@ -58,6 +75,18 @@ namespace flow_cutter{
 		};
 		ReportCuts report_cuts;
 
+		enum class NestedDissectionBottomLevelOrderer{
+			min_degree,
+			min_shortcut
+		};
+		NestedDissectionBottomLevelOrderer nested_dissection_bottom_level_orderer;
+
+		enum class TerminalSelection{
+			random_pair,
+			bfs_set
+		};
+		TerminalSelection terminal_selection;
+
 		enum class PierceRating{
 			max_target_minus_source_hop_dist,
 			min_source_hop_dist,
@@ -83,12 +112,21 @@ namespace flow_cutter{
 			max_cut_size(1000),
 			max_imbalance(0.2),
 			branch_factor(5),
+			inertial_flow_direction_count(4),
+			nested_dissection_cutoff_node_count(0),
+			nested_dissection_cutoff_tree_width(0),
+			nested_dissection_cutoff_tree_width_max_node_count(4096),
+			terminal_set_fraction(0.2),
 			separator_selection(SeparatorSelection::node_min_expansion),
 			avoid_augmenting_path(AvoidAugmentingPath::avoid_and_pick_best),
+			inertial_flow_principal_directions(InertialFlowPrincipalDirections::no),
 			skip_non_maximum_sides(SkipNonMaximumSides::skip),
 			graph_search_algorithm(GraphSearchAlgorithm::pseudo_depth_first_search),
+			inertial_flow_max_flow_algorithm(InertialFlowMaxFlowAlgorithm::dinic),
 			dump_state(DumpState::no),
 			report_cuts(ReportCuts::yes),
+			nested_dissection_bottom_level_orderer(NestedDissectionBottomLevelOrderer::min_degree),
+			terminal_selection(TerminalSelection::random_pair),
 			pierce_rating(PierceRating::max_target_minus_source_hop_dist){}
 
 		void set(const std::string&var, const std::string&val){
@@ -113,6 +151,12 @@ namespace flow_cutter{
 				else if(val == "avoid_and_pick_random" || val_id == static_cast<int>(AvoidAugmentingPath::avoid_and_pick_random)) 
 					avoid_augmenting_path = AvoidAugmentingPath::avoid_and_pick_random;
 				else throw std::runtime_error("Unknown config value "+val+" for variable AvoidAugmentingPath; valid are avoid_and_pick_best, do_not_avoid, avoid_and_pick_oldest, avoid_and_pick_random");
+			}else if(var == "InertialFlowPrincipalDirections" || var == "inertial_flow_principal_directions"){
+				if(val == "no" || val_id == static_cast<int>(InertialFlowPrincipalDirections::no)) 
+					inertial_flow_principal_directions = InertialFlowPrincipalDirections::no;
+				else if(val == "yes" || val_id == static_cast<int>(InertialFlowPrincipalDirections::yes)) 
+					inertial_flow_principal_directions = InertialFlowPrincipalDirections::yes;
+				else throw std::runtime_error("Unknown config value "+val+" for variable InertialFlowPrincipalDirections; valid are no, yes");
 			}else if(var == "SkipNonMaximumSides" || var == "skip_non_maximum_sides"){
 				if(val == "skip" || val_id == static_cast<int>(SkipNonMaximumSides::skip)) 
 					skip_non_maximum_sides = SkipNonMaximumSides::skip;
@@ -127,6 +171,12 @@ namespace flow_cutter{
 				else if(val == "depth_first_search" || val_id == static_cast<int>(GraphSearchAlgorithm::depth_first_search)) 
 					graph_search_algorithm = GraphSearchAlgorithm::depth_first_search;
 				else throw std::runtime_error("Unknown config value "+val+" for variable GraphSearchAlgorithm; valid are pseudo_depth_first_search, breadth_first_search, depth_first_search");
+			}else if(var == "InertialFlowMaxFlowAlgorithm" || var == "inertial_flow_max_flow_algorithm"){
+				if(val == "dinic" || val_id == static_cast<int>(InertialFlowMaxFlowAlgorithm::dinic)) 
+					inertial_flow_max_flow_algorithm = InertialFlowMaxFlowAlgorithm::dinic;
+				else if(val == "push_relabel" || val_id == static_cast<int>(InertialFlowMaxFlowAlgorithm::push_relabel)) 
+					inertial_flow_max_flow_algorithm = InertialFlowMaxFlowAlgorithm::push_relabel;
+				else throw std::runtime_error("Unknown config value "+val+" for variable InertialFlowMaxFlowAlgorithm; valid are dinic, push_relabel");
 			}else if(var == "DumpState" || var == "dump_state"){
 				if(val == "no" || val_id == static_cast<int>(DumpState::no)) 
 					dump_state = DumpState::no;
@@ -139,6 +189,18 @@ namespace flow_cutter{
 				else if(val == "no" || val_id == static_cast<int>(ReportCuts::no)) 
 					report_cuts = ReportCuts::no;
 				else throw std::runtime_error("Unknown config value "+val+" for variable ReportCuts; valid are yes, no");
+			}else if(var == "NestedDissectionBottomLevelOrderer" || var == "nested_dissection_bottom_level_orderer"){
+				if(val == "min_degree" || val_id == static_cast<int>(NestedDissectionBottomLevelOrderer::min_degree)) 
+					nested_dissection_bottom_level_orderer = NestedDissectionBottomLevelOrderer::min_degree;
+				else if(val == "min_shortcut" || val_id == static_cast<int>(NestedDissectionBottomLevelOrderer::min_shortcut)) 
+					nested_dissection_bottom_level_orderer = NestedDissectionBottomLevelOrderer::min_shortcut;
+				else throw std::runtime_error("Unknown config value "+val+" for variable NestedDissectionBottomLevelOrderer; valid are min_degree, min_shortcut");
+			}else if(var == "TerminalSelection" || var == "terminal_selection"){
+				if(val == "random_pair" || val_id == static_cast<int>(TerminalSelection::random_pair)) 
+					terminal_selection = TerminalSelection::random_pair;
+				else if(val == "bfs_set" || val_id == static_cast<int>(TerminalSelection::bfs_set)) 
+					terminal_selection = TerminalSelection::bfs_set;
+				else throw std::runtime_error("Unknown config value "+val+" for variable TerminalSelection; valid are random_pair, bfs_set");
 			}else if(var == "PierceRating" || var == "pierce_rating"){
 				if(val == "max_target_minus_source_hop_dist" || val_id == static_cast<int>(PierceRating::max_target_minus_source_hop_dist)) 
 					pierce_rating = PierceRating::max_target_minus_source_hop_dist;
@@ -202,7 +264,32 @@ namespace flow_cutter{
 				if(!(x>=1))
 					throw std::runtime_error("Value for \"branch_factor\" must fullfill \"x>=1\"");
 				branch_factor = x; 
-			}else throw std::runtime_error("Unknown config variable "+var+"; valid are SeparatorSelection, AvoidAugmentingPath, SkipNonMaximumSides, GraphSearchAlgorithm, DumpState, ReportCuts, PierceRating, cutter_count, random_seed, source, target, thread_count, max_cut_size, max_imbalance, branch_factor");
+			}else if(var == "inertial_flow_direction_count"){
+				int x = std::stoi(val);
+				if(!(x>=1))
+					throw std::runtime_error("Value for \"inertial_flow_direction_count\" must fullfill \"x>=1\"");
+				inertial_flow_direction_count = x; 
+			}else if(var == "nested_dissection_cutoff_node_count"){
+				int x = std::stoi(val);
+				if(!(x>=0))
+					throw std::runtime_error("Value for \"nested_dissection_cutoff_node_count\" must fullfill \"x>=0\"");
+				nested_dissection_cutoff_node_count = x; 
+			}else if(var == "nested_dissection_cutoff_tree_width"){
+				int x = std::stoi(val);
+				if(!(x>=0))
+					throw std::runtime_error("Value for \"nested_dissection_cutoff_tree_width\" must fullfill \"x>=0\"");
+				nested_dissection_cutoff_tree_width = x; 
+			}else if(var == "nested_dissection_cutoff_tree_width_max_node_count"){
+				int x = std::stoi(val);
+				if(!(x>=1))
+					throw std::runtime_error("Value for \"nested_dissection_cutoff_tree_width_max_node_count\" must fullfill \"x>=1\"");
+				nested_dissection_cutoff_tree_width_max_node_count = x; 
+			}else if(var == "terminal_set_fraction"){
+				float x = std::stof(val);
+				if(!(0.5>=x&&x>0.0))
+					throw std::runtime_error("Value for \"terminal_set_fraction\" must fullfill \"0.5>=x&&x>0.0\"");
+				terminal_set_fraction = x; 
+			}else throw std::runtime_error("Unknown config variable "+var+"; valid are SeparatorSelection, AvoidAugmentingPath, InertialFlowPrincipalDirections, SkipNonMaximumSides, GraphSearchAlgorithm, InertialFlowMaxFlowAlgorithm, DumpState, ReportCuts, NestedDissectionBottomLevelOrderer, TerminalSelection, PierceRating, cutter_count, random_seed, source, target, thread_count, max_cut_size, max_imbalance, branch_factor, inertial_flow_direction_count, nested_dissection_cutoff_node_count, nested_dissection_cutoff_tree_width, nested_dissection_cutoff_tree_width_max_node_count, terminal_set_fraction");
 		}
 		std::string get(const std::string&var)const{
 			if(var == "SeparatorSelection" || var == "separator_selection"){
@@ -217,6 +304,10 @@ namespace flow_cutter{
 				else if(avoid_augmenting_path == AvoidAugmentingPath::avoid_and_pick_oldest) return "avoid_and_pick_oldest";
 				else if(avoid_augmenting_path == AvoidAugmentingPath::avoid_and_pick_random) return "avoid_and_pick_random";
 				else {assert(false); return "";}
+			}else if(var == "InertialFlowPrincipalDirections" || var == "inertial_flow_principal_directions"){
+				if(inertial_flow_principal_directions == InertialFlowPrincipalDirections::no) return "no";
+				else if(inertial_flow_principal_directions == InertialFlowPrincipalDirections::yes) return "yes";
+				else {assert(false); return "";}
 			}else if(var == "SkipNonMaximumSides" || var == "skip_non_maximum_sides"){
 				if(skip_non_maximum_sides == SkipNonMaximumSides::skip) return "skip";
 				else if(skip_non_maximum_sides == SkipNonMaximumSides::no_skip) return "no_skip";
@@ -226,6 +317,10 @@ namespace flow_cutter{
 				else if(graph_search_algorithm == GraphSearchAlgorithm::breadth_first_search) return "breadth_first_search";
 				else if(graph_search_algorithm == GraphSearchAlgorithm::depth_first_search) return "depth_first_search";
 				else {assert(false); return "";}
+			}else if(var == "InertialFlowMaxFlowAlgorithm" || var == "inertial_flow_max_flow_algorithm"){
+				if(inertial_flow_max_flow_algorithm == InertialFlowMaxFlowAlgorithm::dinic) return "dinic";
+				else if(inertial_flow_max_flow_algorithm == InertialFlowMaxFlowAlgorithm::push_relabel) return "push_relabel";
+				else {assert(false); return "";}
 			}else if(var == "DumpState" || var == "dump_state"){
 				if(dump_state == DumpState::no) return "no";
 				else if(dump_state == DumpState::yes) return "yes";
@@ -234,6 +329,14 @@ namespace flow_cutter{
 				if(report_cuts == ReportCuts::yes) return "yes";
 				else if(report_cuts == ReportCuts::no) return "no";
 				else {assert(false); return "";}
+			}else if(var == "NestedDissectionBottomLevelOrderer" || var == "nested_dissection_bottom_level_orderer"){
+				if(nested_dissection_bottom_level_orderer == NestedDissectionBottomLevelOrderer::min_degree) return "min_degree";
+				else if(nested_dissection_bottom_level_orderer == NestedDissectionBottomLevelOrderer::min_shortcut) return "min_shortcut";
+				else {assert(false); return "";}
+			}else if(var == "TerminalSelection" || var == "terminal_selection"){
+				if(terminal_selection == TerminalSelection::random_pair) return "random_pair";
+				else if(terminal_selection == TerminalSelection::bfs_set) return "bfs_set";
+				else {assert(false); return "";}
 			}else if(var == "PierceRating" || var == "pierce_rating"){
 				if(pierce_rating == PierceRating::max_target_minus_source_hop_dist) return "max_target_minus_source_hop_dist";
 				else if(pierce_rating == PierceRating::min_source_hop_dist) return "min_source_hop_dist";
@@ -264,17 +367,31 @@ namespace flow_cutter{
 				return std::to_string(max_imbalance);
 			}else if(var == "branch_factor"){
 				return std::to_string(branch_factor);
-			}else throw std::runtime_error("Unknown config variable "+var+"; valid are SeparatorSelection,AvoidAugmentingPath,SkipNonMaximumSides,GraphSearchAlgorithm,DumpState,ReportCuts,PierceRating, cutter_count, random_seed, source, target, thread_count, max_cut_size, max_imbalance, branch_factor");
+			}else if(var == "inertial_flow_direction_count"){
+				return std::to_string(inertial_flow_direction_count);
+			}else if(var == "nested_dissection_cutoff_node_count"){
+				return std::to_string(nested_dissection_cutoff_node_count);
+			}else if(var == "nested_dissection_cutoff_tree_width"){
+				return std::to_string(nested_dissection_cutoff_tree_width);
+			}else if(var == "nested_dissection_cutoff_tree_width_max_node_count"){
+				return std::to_string(nested_dissection_cutoff_tree_width_max_node_count);
+			}else if(var == "terminal_set_fraction"){
+				return std::to_string(terminal_set_fraction);
+			}else throw std::runtime_error("Unknown config variable "+var+"; valid are SeparatorSelection,AvoidAugmentingPath,InertialFlowPrincipalDirections,SkipNonMaximumSides,GraphSearchAlgorithm,InertialFlowMaxFlowAlgorithm,DumpState,ReportCuts,NestedDissectionBottomLevelOrderer,TerminalSelection,PierceRating, cutter_count, random_seed, source, target, thread_count, max_cut_size, max_imbalance, branch_factor, inertial_flow_direction_count, nested_dissection_cutoff_node_count, nested_dissection_cutoff_tree_width, nested_dissection_cutoff_tree_width_max_node_count, terminal_set_fraction");
 		}
 		std::string get_config()const{
 			std::ostringstream out;
 			out
 				<< std::setw(30) << "SeparatorSelection" << " : " << get("SeparatorSelection") << '\n'
 				<< std::setw(30) << "AvoidAugmentingPath" << " : " << get("AvoidAugmentingPath") << '\n'
+				<< std::setw(30) << "InertialFlowPrincipalDirections" << " : " << get("InertialFlowPrincipalDirections") << '\n'
 				<< std::setw(30) << "SkipNonMaximumSides" << " : " << get("SkipNonMaximumSides") << '\n'
 				<< std::setw(30) << "GraphSearchAlgorithm" << " : " << get("GraphSearchAlgorithm") << '\n'
+				<< std::setw(30) << "InertialFlowMaxFlowAlgorithm" << " : " << get("InertialFlowMaxFlowAlgorithm") << '\n'
 				<< std::setw(30) << "DumpState" << " : " << get("DumpState") << '\n'
 				<< std::setw(30) << "ReportCuts" << " : " << get("ReportCuts") << '\n'
+				<< std::setw(30) << "NestedDissectionBottomLevelOrderer" << " : " << get("NestedDissectionBottomLevelOrderer") << '\n'
+				<< std::setw(30) << "TerminalSelection" << " : " << get("TerminalSelection") << '\n'
 				<< std::setw(30) << "PierceRating" << " : " << get("PierceRating") << '\n'
 				<< std::setw(30) << "cutter_count" << " : " << get("cutter_count") << '\n'
 				<< std::setw(30) << "random_seed" << " : " << get("random_seed") << '\n'
@@ -283,7 +400,12 @@ namespace flow_cutter{
 				<< std::setw(30) << "thread_count" << " : " << get("thread_count") << '\n'
 				<< std::setw(30) << "max_cut_size" << " : " << get("max_cut_size") << '\n'
 				<< std::setw(30) << "max_imbalance" << " : " << get("max_imbalance") << '\n'
-				<< std::setw(30) << "branch_factor" << " : " << get("branch_factor") << '\n';
+				<< std::setw(30) << "branch_factor" << " : " << get("branch_factor") << '\n'
+				<< std::setw(30) << "inertial_flow_direction_count" << " : " << get("inertial_flow_direction_count") << '\n'
+				<< std::setw(30) << "nested_dissection_cutoff_node_count" << " : " << get("nested_dissection_cutoff_node_count") << '\n'
+				<< std::setw(30) << "nested_dissection_cutoff_tree_width" << " : " << get("nested_dissection_cutoff_tree_width") << '\n'
+				<< std::setw(30) << "nested_dissection_cutoff_tree_width_max_node_count" << " : " << get("nested_dissection_cutoff_tree_width_max_node_count") << '\n'
+				<< std::setw(30) << "terminal_set_fraction" << " : " << get("terminal_set_fraction") << '\n';
 			return out.str();
 		}
 
@@ -0,0 +1,129 @@
+#ifndef FLOW_CUTTER_INSTRUMENTATION_H
+#define FLOW_CUTTER_INSTRUMENTATION_H
+
+#include <string>
+
+// Counters of the work done inside the flow cutter. They are only collected if the code is
+// compiled with FLOW_CUTTER_INSTRUMENTATION defined, for example using ./build.py --instrument.
+// Otherwise FLOW_CUTTER_INSTRUMENT expands to nothing and the cutters carry no counters.
+//
+// Every BasicCutter instance owns its counters. MultiCutter runs every instance on a single
+// thread at a time and therefore the counters are incremented without atomics. The counters of
+// all instances are summed up when they are queried.
+
+#ifdef FLOW_CUTTER_INSTRUMENTATION
+#define FLOW_CUTTER_INSTRUMENT(x) x
+#else
+#define FLOW_CUTTER_INSTRUMENT(x)
+#endif
+
+namespace flow_cutter{
+	namespace instrumentation{
+
+		#ifdef FLOW_CUTTER_INSTRUMENTATION
+		const bool is_enabled = true;
+		#else
+		const bool is_enabled = false;
+		#endif
+
+		struct Counters{
+			long long reachable_scanned_node_count = 0;
+			long long reachable_scanned_arc_count = 0;
+			long long assimilated_scanned_node_count = 0;
+			long long assimilated_scanned_arc_count = 0;
+			long long augmenting_path_count = 0;
+			long long augmenting_path_arc_count = 0;
+			long long reachable_reset_count = 0;
+			//! The node set copies made by the resets are proportional to the node count.
+			long long reachable_reset_copied_node_count = 0;
+			long long pierce_node_selection_count = 0;
+			long long pierce_node_candidate_arc_count = 0;
+			long long cut_front_added_arc_count = 0;
+			long long cut_front_removed_arc_count = 0;
+			long long advance_count = 0;
+			//! Summed over all instances. With several threads this exceeds the elapsed time.
+			long long wall_time_musec = 0;
+
+			template<class F>
+			void forall_counters(const F&f)const{
+				f("reachable_scanned_node_count", reachable_scanned_node_count);
+				f("reachable_scanned_arc_count", reachable_scanned_arc_count);
+				f("assimilated_scanned_node_count", assimilated_scanned_node_count);
+				f("assimilated_scanned_arc_count", assimilated_scanned_arc_count);
+				f("augmenting_path_count", augmenting_path_count);
+				f("augmenting_path_arc_count", augmenting_path_arc_count);
+				f("reachable_reset_count", reachable_reset_count);
+				f("reachable_reset_copied_node_count", reachable_reset_copied_node_count);
+				f("pierce_node_selection_count", pierce_node_selection_count);
+				f("pierce_node_candidate_arc_count", pierce_node_candidate_arc_count);
+				f("cut_front_added_arc_count", cut_front_added_arc_count);
+				f("cut_front_removed_arc_count", cut_front_removed_arc_count);
+				f("advance_count", advance_count);
+				f("wall_time_musec", wall_time_musec);
+			}
+
+			Counters&operator+=(const Counters&o){
+				reachable_scanned_node_count += o.reachable_scanned_node_count;
+				reachable_scanned_arc_count += o.reachable_scanned_arc_count;
+				assimilated_scanned_node_count += o.assimilated_scanned_node_count;
+				assimilated_scanned_arc_count += o.assimilated_scanned_arc_count;
+				augmenting_path_count += o.augmenting_path_count;
+				augmenting_path_arc_count += o.augmenting_path_arc_count;
+				reachable_reset_count += o.reachable_reset_count;
+				reachable_reset_copied_node_count += o.reachable_reset_copied_node_count;
+				pierce_node_selection_count += o.pierce_node_selection_count;
+				pierce_node_candidate_arc_count += o.pierce_node_candidate_arc_count;
+				cut_front_added_arc_count += o.cut_front_added_arc_count;
+				cut_front_removed_arc_count += o.cut_front_removed_arc_count;
+				advance_count += o.advance_count;
+				wall_time_musec += o.wall_time_musec;
+				return *this;
+			}
+
+			Counters&operator-=(const Counters&o){
+				reachable_scanned_node_count -= o.reachable_scanned_node_count;
+				reachable_scanned_arc_count -= o.reachable_scanned_arc_count;
+				assimilated_scanned_node_count -= o.assimilated_scanned_node_count;
+				assimilated_scanned_arc_count -= o.assimilated_scanned_arc_count;
+				augmenting_path_count -= o.augmenting_path_count;
+				augmenting_path_arc_count -= o.augmenting_path_arc_count;
+				reachable_reset_count -= o.reachable_reset_count;
+				reachable_reset_copied_node_count -= o.reachable_reset_copied_node_count;
+				pierce_node_selection_count -= o.pierce_node_selection_count;
+				pierce_node_candidate_arc_count -= o.pierce_node_candidate_arc_count;
+				cut_front_added_arc_count -= o.cut_front_added_arc_count;
+				cut_front_removed_arc_count -= o.cut_front_removed_arc_count;
+				advance_count -= o.advance_count;
+				wall_time_musec -= o.wall_time_musec;
+				return *this;
+			}
+		};
+
+		//! The counters of all cutters that ran to completion on the calling thread. Separator
+		//! computations add to them, which allows attributing the work to a caller, such as one
+		//! separator of a nested dissection, by taking the difference before and after the call.
+		inline Counters&thread_counters(){
+			static thread_local Counters counters;
+			return counters;
+		}
+
+		//! The comma separated counter names, each preceded by a comma, if the instrumentation is
+		//! enabled and an empty string otherwise. Meant to be appended to a CSV header.
+		inline std::string get_csv_header(){
+			std::string header;
+			if(is_enabled)
+				Counters().forall_counters([&](const char*name, long long){ header += ','; header += name; });
+			return header;
+		}
+
+		//! The values matching get_csv_header.
+		inline std::string get_csv_row(const Counters&c){
+			std::string row;
+			if(is_enabled)
+				c.forall_counters([&](const char*, long long value){ row += ','; row += std::to_string(value); });
+			return row;
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,291 @@
+// build shared library libflowcutter.so
+
+#include "flow_cutter_library.h"
+#include "flow_cutter.h"
+#include "flow_cutter_config.h"
+#include "separator.h"
+#include "min_fill_in.h"
+#include "tree_decomposition.h"
+#include "multi_arc.h"
+#include "connected_components.h"
+#include "permutation.h"
+#include "chain.h"
+#include "array_id_func.h"
+#include <string>
+#include <stdexcept>
+#include <new>
+#include <algorithm>
+#include <memory>
+#include <cstdlib>
+
+struct flow_cutter_config{
+	flow_cutter::Config config;
+};
+
+namespace{
+	thread_local std::string last_error;
+
+	struct InvalidArgument : std::runtime_error{
+		explicit InvalidArgument(const std::string&msg):std::runtime_error(msg){}
+	};
+
+	struct InvalidGraph : std::runtime_error{
+		explicit InvalidGraph(const std::string&msg):std::runtime_error(msg){}
+	};
+
+	// Runs f and translates its exceptions into status codes.
+	template<class F>
+	int guard(const F&f){
+		try{
+			f();
+			return FLOW_CUTTER_OK;
+		}catch(InvalidArgument&err){
+			last_error = err.what();
+			return FLOW_CUTTER_INVALID_ARGUMENT;
+		}catch(InvalidGraph&err){
+			last_error = err.what();
+			return FLOW_CUTTER_INVALID_GRAPH;
+		}catch(std::bad_alloc&){
+			last_error = "out of memory";
+			return FLOW_CUTTER_OUT_OF_MEMORY;
+		}catch(std::exception&err){
+			last_error = err.what();
+			return FLOW_CUTTER_INTERNAL_ERROR;
+		}catch(...){
+			last_error = "unknown error";
+			return FLOW_CUTTER_INTERNAL_ERROR;
+		}
+	}
+
+	void check_pointer(const void*p, const char*name){
+		if(p == nullptr)
+			throw InvalidArgument(std::string(name)+" must not be NULL");
+	}
+
+	flow_cutter::Config get_config(const flow_cutter_config*config, int thread_count){
+		check_pointer(config, "config");
+		if(thread_count < 0)
+			throw InvalidArgument("thread_count must not be negative");
+		flow_cutter::Config c = config->config;
+		if(thread_count != 0)
+			c.thread_count = thread_count;
+		return c;
+	}
+
+	struct InputGraph{
+		ArrayIDIDFunc tail, head;
+		ArrayIDFunc<int>arc_weight;
+	};
+
+	// Copies the CSR arrays and checks that they describe a symmetric graph.
+	InputGraph load_graph(const flow_cutter_graph*graph, int min_node_count){
+		check_pointer(graph, "graph");
+		const int node_count = graph->node_count;
+		if(node_count < min_node_count)
+			throw InvalidGraph("graph must have at least "+std::to_string(min_node_count)+" nodes");
+		check_pointer(graph->first_out, "graph->first_out");
+		if(graph->first_out[0] != 0)
+			throw InvalidGraph("first_out[0] must be 0");
+		for(int x=0; x<node_count; ++x)
+			if(graph->first_out[x] > graph->first_out[x+1])
+				throw InvalidGraph("first_out must be non-decreasing");
+		const int arc_count = graph->first_out[node_count];
+		if(arc_count != 0)
+			check_pointer(graph->head, "graph->head");
+
+		InputGraph g;
+		g.tail = ArrayIDIDFunc(arc_count, node_count);
+		g.head = ArrayIDIDFunc(arc_count, node_count);
+		g.arc_weight = ArrayIDFunc<int>(arc_count);
+		for(int x=0; x<node_count; ++x){
+			for(int i=graph->first_out[x]; i<graph->first_out[x+1]; ++i){
+				int y = graph->head[i];
+				if(y < 0 || y >= node_count)
+					throw InvalidGraph("head of arc "+std::to_string(i)+" is out of bounds");
+				g.tail[i] = x;
+				g.head[i] = y;
+				g.arc_weight[i] = graph->arc_weight == nullptr ? 1 : graph->arc_weight[i];
+			}
+		}
+		if(!is_symmetric(g.tail, g.head))
+			throw InvalidGraph("graph must be symmetric");
+		return g; // NVRO
+	}
+
+	// The flow cutter requires a connected graph without loops and multi arcs.
+	InputGraph load_simple_connected_graph(const flow_cutter_graph*graph, const flow_cutter::Config&config){
+		auto g = load_graph(graph, 2);
+		cch_order::make_graph_simple(g.tail, g.head, g.arc_weight);
+		if(!is_connected(g.tail, g.head))
+			throw InvalidGraph("graph must be connected");
+		if(flow_cutter::requires_non_negative_weights(config))
+			for(int i=0; i<g.arc_weight.preimage_count(); ++i)
+				if(g.arc_weight(i) < 0)
+					throw InvalidGraph("arc weights must be non-negative");
+		return g; // NVRO
+	}
+
+	ArrayIDIDFunc compute_order(const flow_cutter::Config&config, InputGraph g, bool is_cch_order){
+		const int node_count = g.tail.image_count();
+		if(is_cch_order)
+			return cch_order::compute_cch_graph_order(
+				std::move(g.tail), std::move(g.head), identity_permutation(node_count), std::move(g.arc_weight),
+				flow_cutter::ComputeSeparator(config),
+				flow_cutter::get_nested_dissection_cutoff(config)
+			);
+		else
+			return cch_order::compute_nested_dissection_graph_order(
+				std::move(g.tail), std::move(g.head), std::move(g.arc_weight),
+				flow_cutter::ComputeSeparator(config),
+				flow_cutter::get_nested_dissection_cutoff(config)
+			);
+	}
+
+	template<class T>
+	T*copy_to_malloced_array(const ArrayIDFunc<T>&f){
+		T*a = static_cast<T*>(std::malloc(std::max(1, f.preimage_count())*sizeof(T)));
+		if(a == nullptr)
+			throw std::bad_alloc();
+		std::copy(f.begin(), f.end(), a);
+		return a;
+	}
+}
+
+extern "C" {
+
+const char*flow_cutter_get_last_error(void){
+	return last_error.c_str();
+}
+
+int flow_cutter_create_config(flow_cutter_config**config){
+	return guard([&]{
+		check_pointer(config, "config");
+		*config = new flow_cutter_config;
+	});
+}
+
+void flow_cutter_free_config(flow_cutter_config*config){
+	delete config;
+}
+
+int flow_cutter_set_config(flow_cutter_config*config, const char*variable, const char*value){
+	return guard([&]{
+		check_pointer(config, "config");
+		check_pointer(variable, "variable");
+		check_pointer(value, "value");
+		try{
+			config->config.set(variable, value);
+		}catch(std::runtime_error&err){
+			throw InvalidArgument(err.what());
+		}
+	});
+}
+
+int flow_cutter_compute_separator(
+	const flow_cutter_config*config, const flow_cutter_graph*graph, int thread_count,
+	int*separator, int*separator_size
+){
+	return guard([&]{
+		auto c = get_config(config, thread_count);
+		check_pointer(separator, "separator");
+		check_pointer(separator_size, "separator_size");
+		auto g = load_simple_connected_graph(graph, c);
+
+		auto sep = flow_cutter::ComputeSeparator(c)(g.tail, g.head, identity_permutation(graph->node_count), g.arc_weight);
+		std::copy(sep.begin(), sep.end(), separator);
+		*separator_size = sep.size();
+	});
+}
+
+int flow_cutter_compute_bisection(
+	const flow_cutter_config*config, const flow_cutter_graph*graph, int thread_count,
+	unsigned char*side, int*cut_size
+){
+	return guard([&]{
+		auto c = get_config(config, thread_count);
+		check_pointer(side, "side");
+		check_pointer(cut_size, "cut_size");
+		auto g = load_simple_connected_graph(graph, c);
+
+		const int node_count = g.tail.image_count();
+		const int arc_count = g.tail.preimage_count();
+
+		auto out_arc = invert_sorted_id_id_func(g.tail);
+		auto back_arc = compute_back_arc_permutation(g.tail, g.head);
+
+		auto fc_graph = flow_cutter::make_graph(
+			make_const_ref_id_id_func(g.tail),
+			make_const_ref_id_id_func(g.head),
+			make_const_ref_id_id_func(back_arc),
+			make_const_ref_id_func(g.arc_weight),
+			ConstIntIDFunc<1>(arc_count), // capacity
+			make_const_ref_id_func(out_arc)
+		);
+
+		auto cutter = flow_cutter::make_simple_cutter(fc_graph, c);
+		cutter.init(flow_cutter::select_random_source_target_pairs(node_count, c.cutter_count, c.random_seed), c.random_seed);
+		while(cutter.get_current_smaller_cut_side_size() < c.max_imbalance * node_count && cutter.advance()){}
+
+		for(int x=0; x<node_count; ++x)
+			side[x] = cutter.is_on_smaller_side(x);
+		*cut_size = cutter.get_current_cut().size();
+	});
+}
+
+int flow_cutter_compute_nested_dissection_order(
+	const flow_cutter_config*config, const flow_cutter_graph*graph, int thread_count,
+	int is_cch_order, int*order
+){
+	return guard([&]{
+		auto c = get_config(config, thread_count);
+		check_pointer(order, "order");
+
+		auto o = compute_order(c, load_graph(graph, 1), is_cch_order != 0);
+		std::copy(o.begin(), o.end(), order);
+	});
+}
+
+int flow_cutter_compute_tree_decomposition(
+	const flow_cutter_config*config, const flow_cutter_graph*graph, int thread_count,
+	flow_cutter_tree_decomposition**td
+){
+	return guard([&]{
+		auto c = get_config(config, thread_count);
+		check_pointer(td, "td");
+		*td = nullptr;
+
+		auto g = load_graph(graph, 1);
+		auto tail = g.tail, head = g.head;
+		auto order = compute_order(c, std::move(g), true);
+
+		auto inv_order = inverse_permutation(order);
+		auto decomposition = compute_tree_decomposition(chain(tail, inv_order), chain(head, inv_order));
+		for(auto&x:decomposition.node_in_bag)
+			x = order(x);
+
+		std::unique_ptr<flow_cutter_tree_decomposition, void(*)(flow_cutter_tree_decomposition*)>result(
+			static_cast<flow_cutter_tree_decomposition*>(std::calloc(1, sizeof(flow_cutter_tree_decomposition))),
+			flow_cutter_free_tree_decomposition
+		);
+		if(result == nullptr)
+			throw std::bad_alloc();
+		result->node_count = decomposition.node_count;
+		result->bag_count = decomposition.bag_count();
+		result->maximum_bag_size = decomposition.maximum_bag_size;
+		result->first_node_in_bag = copy_to_malloced_array(decomposition.first_node_in_bag);
+		result->node_in_bag = copy_to_malloced_array(decomposition.node_in_bag);
+		result->bag_parent = copy_to_malloced_array(decomposition.bag_parent);
+		*td = result.release();
+	});
+}
+
+void flow_cutter_free_tree_decomposition(flow_cutter_tree_decomposition*td){
+	if(td != nullptr){
+		std::free(td->first_node_in_bag);
+		std::free(td->node_in_bag);
+		std::free(td->bag_parent);
+		std::free(td);
+	}
+}
+
+}
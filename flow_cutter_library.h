@@ -0,0 +1,97 @@
+#ifndef FLOW_CUTTER_LIBRARY_H
+#define FLOW_CUTTER_LIBRARY_H
+
+// C interface of the FlowCutter library, built as libflowcutter.so by build.py.
+//
+// All functions are thread-safe and can be called concurrently from several threads, each call
+// with its own config or sharing a config that is no longer modified. The graph is passed as CSR
+// arrays that are only read and never stored beyond the call.
+//
+// Every function that can fail returns a status code. If the status is not FLOW_CUTTER_OK, then
+// flow_cutter_get_last_error returns a description of the error of the last failed call of the
+// calling thread. The error message is stored per thread and stays valid until the next call on
+// the same thread.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum{
+	FLOW_CUTTER_OK = 0,
+	FLOW_CUTTER_INVALID_ARGUMENT = 1,
+	FLOW_CUTTER_INVALID_GRAPH = 2,
+	FLOW_CUTTER_OUT_OF_MEMORY = 3,
+	FLOW_CUTTER_INTERNAL_ERROR = 4
+};
+
+// A symmetric graph. The neighbors of node x are head[first_out[x]] to head[first_out[x+1]-1].
+// Every edge must be present in both directions. Loops and multi-edges are ignored. arc_weight
+// may be NULL, in which case every arc has weight 1. Weights are only used by weighted pierce
+// ratings.
+typedef struct{
+	int node_count;
+	const int*first_out;
+	const int*head;
+	const int*arc_weight;
+}flow_cutter_graph;
+
+typedef struct flow_cutter_config flow_cutter_config;
+
+// The result of flow_cutter_compute_tree_decomposition. The nodes of bag b are
+// node_in_bag[first_node_in_bag[b]] to node_in_bag[first_node_in_bag[b+1]-1]. The parent of the
+// root bag is -1.
+typedef struct{
+	int node_count;
+	int bag_count;
+	int maximum_bag_size;
+	int*first_node_in_bag;
+	int*node_in_bag;
+	int*bag_parent;
+}flow_cutter_tree_decomposition;
+
+const char*flow_cutter_get_last_error(void);
+
+// Creates a config with the default values of the console.
+int flow_cutter_create_config(flow_cutter_config**config);
+void flow_cutter_free_config(flow_cutter_config*config);
+
+// Sets a variable as the flow_cutter_set console command does, for example "max_imbalance" to "0.1".
+int flow_cutter_set_config(flow_cutter_config*config, const char*variable, const char*value);
+
+// Computes a node separator. separator must have room for node_count elements. The graph must
+// be connected. thread_count overrides the thread count of the config unless it is 0.
+int flow_cutter_compute_separator(
+	const flow_cutter_config*config, const flow_cutter_graph*graph, int thread_count,
+	int*separator, int*separator_size
+);
+
+// Computes an edge bisection. side[x] is set to 1 if x is on the smaller side and to 0 otherwise.
+// The bisection is the smallest enumerated cut whose smaller side contains at least
+// max_imbalance*node_count nodes or the most balanced cut if no such cut exists. cut_size is set to
+// the number of cut edges. The graph must be connected.
+int flow_cutter_compute_bisection(
+	const flow_cutter_config*config, const flow_cutter_graph*graph, int thread_count,
+	unsigned char*side, int*cut_size
+);
+
+// Computes a nested dissection order. order[i] is set to the node of rank i. With
+// is_cch_order != 0 the order of the reorder_nodes_in_flow_cutter_cch_order command is computed,
+// which additionally handles degree two chains and biconnected components.
+int flow_cutter_compute_nested_dissection_order(
+	const flow_cutter_config*config, const flow_cutter_graph*graph, int thread_count,
+	int is_cch_order, int*order
+);
+
+// Computes a tree decomposition from a CCH order. The result must be freed with
+// flow_cutter_free_tree_decomposition.
+int flow_cutter_compute_tree_decomposition(
+	const flow_cutter_config*config, const flow_cutter_graph*graph, int thread_count,
+	flow_cutter_tree_decomposition**td
+);
+void flow_cutter_free_tree_decomposition(flow_cutter_tree_decomposition*td);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,489 @@
+#include "server_protocol.h"
+#include "list_graph.h"
+#include "flow_cutter.h"
+#include "flow_cutter_config.h"
+#include "separator.h"
+#include "min_fill_in.h"
+#include "multi_arc.h"
+#include "connected_components.h"
+#include "back_arc.h"
+#include "id_multi_func.h"
+#include "permutation.h"
+#include "array_id_func.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <csignal>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace server_protocol;
+
+namespace{
+
+	// A graph kept in memory between requests. The arcs are sorted by tail and free of loops and
+	// multi arcs. The out arcs and back arcs are computed once when the graph is loaded.
+	struct ResidentGraph{
+		ArrayIDIDFunc tail, head;
+		ArrayIDFunc<int>arc_weight;
+		RangeIDIDMultiFunc out_arc;
+		ArrayIDIDFunc back_arc;
+
+		int node_count()const{ return tail.image_count(); }
+		int arc_count()const{ return tail.preimage_count(); }
+	};
+
+	shared_ptr<ResidentGraph>make_resident_graph(ArrayIDIDFunc tail, ArrayIDIDFunc head, ArrayIDFunc<int>arc_weight){
+		if(!is_symmetric(tail, head))
+			throw runtime_error("graph must be symmetric");
+		cch_order::make_graph_simple(tail, head, arc_weight);
+
+		auto g = make_shared<ResidentGraph>();
+		g->out_arc = invert_sorted_id_id_func(tail);
+		g->back_arc = compute_back_arc_permutation(tail, head);
+		g->tail = move(tail);
+		g->head = move(head);
+		g->arc_weight = move(arc_weight);
+		return g;
+	}
+
+	// Extracts the subgraph induced by a sorted node list. Because the node ids keep their relative
+	// order, the arcs stay sorted by tail and the back arcs are translated instead of recomputed.
+	shared_ptr<ResidentGraph>extract_induced_subgraph(const ResidentGraph&g, const vector<int>&node_list){
+		const int node_count = g.node_count();
+		const int arc_count = g.arc_count();
+
+		ArrayIDFunc<int>new_node_id(node_count);
+		new_node_id.fill(-1);
+		for(int i=0; i<(int)node_list.size(); ++i)
+			new_node_id[node_list[i]] = i;
+
+		ArrayIDFunc<int>new_arc_id(arc_count);
+		int new_arc_count = 0;
+		for(int i=0; i<arc_count; ++i){
+			if(new_node_id(g.tail(i)) != -1 && new_node_id(g.head(i)) != -1)
+				new_arc_id[i] = new_arc_count++;
+			else
+				new_arc_id[i] = -1;
+		}
+
+		auto sub = make_shared<ResidentGraph>();
+		sub->tail = ArrayIDIDFunc(new_arc_count, node_list.size());
+		sub->head = ArrayIDIDFunc(new_arc_count, node_list.size());
+		sub->back_arc = ArrayIDIDFunc(new_arc_count, new_arc_count);
+		sub->arc_weight = ArrayIDFunc<int>(new_arc_count);
+		for(int i=0; i<arc_count; ++i){
+			int a = new_arc_id(i);
+			if(a != -1){
+				sub->tail[a] = new_node_id(g.tail(i));
+				sub->head[a] = new_node_id(g.head(i));
+				sub->back_arc[a] = new_arc_id(g.back_arc(i));
+				sub->arc_weight[a] = g.arc_weight(i);
+			}
+		}
+		sub->out_arc = invert_sorted_id_id_func(sub->tail);
+		return sub;
+	}
+
+	// The config string is a whitespace separated list of variable value pairs.
+	flow_cutter::Config parse_config(const string&text, int seed){
+		flow_cutter::Config config;
+		istringstream in(text);
+		string var, val;
+		while(in >> var){
+			if(!(in >> val))
+				throw runtime_error("config variable "+var+" has no value");
+			config.set(var, val);
+		}
+		if(seed != -1)
+			config.random_seed = seed;
+		return config;
+	}
+
+	class GraphStore{
+	public:
+		void insert(const string&name, shared_ptr<const ResidentGraph>g){
+			lock_guard<mutex>lock(m);
+			graphs[name] = move(g);
+		}
+
+		void erase(const string&name){
+			lock_guard<mutex>lock(m);
+			if(graphs.erase(name) == 0)
+				throw runtime_error("unknown graph "+name);
+		}
+
+		//! Running requests keep their graph alive even if it is dropped in the meantime.
+		shared_ptr<const ResidentGraph>find(const string&name)const{
+			lock_guard<mutex>lock(m);
+			auto i = graphs.find(name);
+			if(i == graphs.end())
+				throw runtime_error("unknown graph "+name);
+			return i->second;
+		}
+
+		map<string, shared_ptr<const ResidentGraph>>get_all()const{
+			lock_guard<mutex>lock(m);
+			return graphs;
+		}
+
+	private:
+		mutable mutex m;
+		map<string, shared_ptr<const ResidentGraph>>graphs;
+	};
+
+	class ThreadPool{
+	public:
+		explicit ThreadPool(int thread_count):is_stopped(false){
+			for(int i=0; i<thread_count; ++i)
+				workers.emplace_back([this]{ work(); });
+		}
+
+		void push(function<void()>task){
+			{
+				lock_guard<mutex>lock(m);
+				tasks.push_back(move(task));
+			}
+			task_available.notify_one();
+		}
+
+		//! Runs all queued tasks and joins the workers.
+		~ThreadPool(){
+			{
+				lock_guard<mutex>lock(m);
+				is_stopped = true;
+			}
+			task_available.notify_all();
+			for(auto&w:workers)
+				w.join();
+		}
+
+	private:
+		void work(){
+			for(;;){
+				function<void()>task;
+				{
+					unique_lock<mutex>lock(m);
+					task_available.wait(lock, [&]{ return is_stopped || !tasks.empty(); });
+					if(tasks.empty())
+						return;
+					task = move(tasks.front());
+					tasks.pop_front();
+				}
+				task();
+			}
+		}
+
+		mutex m;
+		condition_variable task_available;
+		deque<function<void()>>tasks;
+		vector<thread>workers;
+		bool is_stopped;
+	};
+
+	// The responses of concurrently running requests are written to the connection one frame at a
+	// time. The file descriptors are closed once the reader and all pending requests are done.
+	struct Connection{
+		Connection(int in_fd, int out_fd):in_fd(in_fd), out_fd(out_fd){}
+
+		~Connection(){
+			if(in_fd > 2)
+				close(in_fd);
+			if(out_fd > 2 && out_fd != in_fd)
+				close(out_fd);
+		}
+
+		void send(const string&payload){
+			lock_guard<mutex>lock(write_mutex);
+			try{
+				write_frame(out_fd, payload);
+			}catch(exception&){
+				// The client is gone. Its remaining responses are dropped.
+			}
+		}
+
+		int in_fd, out_fd;
+		mutex write_mutex;
+	};
+
+	GraphStore graph_store;
+	atomic<bool>shutdown_requested(false);
+	int listen_fd = -1;
+
+	vector<int>check_node_list(vector<int>node_list, const ResidentGraph&g){
+		sort(node_list.begin(), node_list.end());
+		if(!node_list.empty() && (node_list.front() < 0 || node_list.back() >= g.node_count()))
+			throw runtime_error("node ID out of bounds");
+		if(adjacent_find(node_list.begin(), node_list.end()) != node_list.end())
+			throw runtime_error("node list contains duplicates");
+		return node_list; // NVRO
+	}
+
+	void write_graph_size(PayloadWriter&out, const ResidentGraph&g){
+		out.write_u32(g.node_count());
+		out.write_u32(g.arc_count());
+	}
+
+	ListGraph load_graph_file(const string&format, const string&file_name){
+		if(format == "dimacs")
+			return uncached_load_dimacs_graph(file_name);
+		else if(format == "metis")
+			return uncached_load_metis_graph(file_name);
+		else if(format == "pace")
+			return uncached_load_pace_graph(file_name);
+		else if(format == "binary")
+			return load_binary_graph(file_name);
+		else
+			throw runtime_error("unknown graph format "+format+", valid formats are dimacs, metis, pace and binary");
+	}
+
+	void process_request(PayloadReader&in, Opcode opcode, PayloadWriter&out){
+		switch(opcode){
+		case Opcode::load_graph_file:
+		{
+			string name = in.read_string();
+			string format = in.read_string();
+			string file_name = in.read_string();
+			auto input = load_graph_file(format, file_name);
+			auto g = make_resident_graph(move(input.tail), move(input.head), move(input.arc_weight));
+			write_graph_size(out, *g);
+			graph_store.insert(name, move(g));
+		}
+		break;
+		case Opcode::load_graph_csr:
+		{
+			string name = in.read_string();
+			int node_count = in.read_i32();
+			auto first_out = in.read_int_list();
+			auto head_list = in.read_int_list();
+			auto arc_weight_list = in.read_int_list();
+
+			// The request is untrusted. first_out is fully validated before it is used as index.
+			if(node_count < 0 || (long long)first_out.size() != (long long)node_count+1 || first_out[0] != 0 || first_out.back() != (int)head_list.size())
+				throw runtime_error("invalid first_out");
+			for(int x=0; x<node_count; ++x)
+				if(first_out[x] > first_out[x+1])
+					throw runtime_error("first_out must be non-decreasing");
+			const int arc_count = head_list.size();
+			if(!arc_weight_list.empty() && (int)arc_weight_list.size() != arc_count)
+				throw runtime_error("arc weight count does not match the arc count");
+
+			ArrayIDIDFunc tail(arc_count, node_count), head(arc_count, node_count);
+			ArrayIDFunc<int>arc_weight(arc_count);
+			for(int x=0; x<node_count; ++x){
+				for(int i=first_out[x]; i<first_out[x+1]; ++i){
+					if(head_list[i] < 0 || head_list[i] >= node_count)
+						throw runtime_error("head of arc "+to_string(i)+" is out of bounds");
+					tail[i] = x;
+					head[i] = head_list[i];
+					arc_weight[i] = arc_weight_list.empty() ? 1 : arc_weight_list[i];
+				}
+			}
+			auto g = make_resident_graph(move(tail), move(head), move(arc_weight));
+			write_graph_size(out, *g);
+			graph_store.insert(name, move(g));
+		}
+		break;
+		case Opcode::drop_graph:
+			graph_store.erase(in.read_string());
+			break;
+		case Opcode::list_graphs:
+		{
+			auto graphs = graph_store.get_all();
+			out.write_u32(graphs.size());
+			for(auto&g:graphs){
+				out.write_string(g.first);
+				write_graph_size(out, *g.second);
+			}
+		}
+		break;
+		case Opcode::compute_separator:
+		case Opcode::compute_order:
+		{
+			auto g = graph_store.find(in.read_string());
+			string config_text = in.read_string();
+			int seed = in.read_i32();
+			bool is_cch_order = opcode == Opcode::compute_order && in.read_u8() != 0;
+			auto node_list = check_node_list(in.read_int_list(), *g);
+			auto config = parse_config(config_text, seed);
+
+			shared_ptr<const ResidentGraph>sub = g;
+			if(!node_list.empty())
+				sub = extract_induced_subgraph(*g, node_list);
+			auto global_node_id = [&](int x){ return node_list.empty() ? x : node_list[x]; };
+
+			vector<int>result;
+			if(opcode == Opcode::compute_separator){
+				if(sub->node_count() < 2)
+					throw runtime_error("graph must have at least two nodes");
+				if(!is_connected(sub->tail, sub->head))
+					throw runtime_error("graph must be connected");
+				if(flow_cutter::requires_non_negative_weights(config))
+					for(int i=0; i<sub->arc_count(); ++i)
+						if(sub->arc_weight(i) < 0)
+							throw runtime_error("arc weights must be non-negative");
+				result = flow_cutter::ComputeSeparator(config).compute_with_back_arcs(sub->tail, sub->head, sub->out_arc, sub->back_arc, sub->arc_weight);
+			}else{
+				ArrayIDIDFunc order;
+				if(is_cch_order)
+					order = cch_order::compute_cch_graph_order(sub->tail, sub->head, identity_permutation(sub->node_count()), sub->arc_weight, flow_cutter::ComputeSeparator(config), flow_cutter::get_nested_dissection_cutoff(config));
+				else
+					order = cch_order::compute_nested_dissection_graph_order(sub->tail, sub->head, sub->arc_weight, flow_cutter::ComputeSeparator(config), flow_cutter::get_nested_dissection_cutoff(config));
+				result.assign(order.begin(), order.end());
+			}
+			for(auto&x:result)
+				x = global_node_id(x);
+			out.write_int_list(result);
+		}
+		break;
+		case Opcode::shutdown:
+			shutdown_requested = true;
+			if(listen_fd != -1)
+				::shutdown(listen_fd, SHUT_RDWR);
+			break;
+		default:
+			throw runtime_error("unknown opcode "+to_string((int)opcode));
+		}
+		if(!in.is_at_end())
+			throw runtime_error("request has trailing bytes");
+	}
+
+	void handle_request(Connection&connection, const string&request){
+		PayloadReader in(request);
+		PayloadWriter out;
+		uint32_t request_id = 0;
+		try{
+			request_id = in.read_u32();
+			Opcode opcode = static_cast<Opcode>(in.read_u8());
+			PayloadWriter body;
+			process_request(in, opcode, body);
+			out.write_u32(request_id);
+			out.write_u8(static_cast<uint8_t>(Status::ok));
+			connection.send(out.get_data() + body.get_data());
+		}catch(exception&err){
+			out = PayloadWriter();
+			out.write_u32(request_id);
+			out.write_u8(static_cast<uint8_t>(Status::error));
+			out.write_string(err.what());
+			connection.send(out.get_data());
+		}
+	}
+
+	bool is_shutdown_request(const string&request){
+		return request.size() > 4 && static_cast<Opcode>(request[4]) == Opcode::shutdown;
+	}
+
+	// Reads the requests of one connection and schedules them on the pool. Only a malformed frame
+	// terminates the connection, errors of individual requests are reported in their responses.
+	// A shutdown request is answered directly and ends the reading.
+	void serve_connection(shared_ptr<Connection>connection, ThreadPool&pool){
+		string payload;
+		try{
+			while(!shutdown_requested && read_frame(connection->in_fd, payload)){
+				if(is_shutdown_request(payload)){
+					handle_request(*connection, payload);
+					break;
+				}
+				auto request = make_shared<string>(move(payload));
+				pool.push([connection, request]{ handle_request(*connection, *request); });
+			}
+		}catch(exception&err){
+			cerr << "Connection closed : " << err.what() << endl;
+		}
+	}
+
+	int open_unix_socket(const string&path){
+		int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if(fd < 0)
+			throw runtime_error("could not create socket");
+		sockaddr_un addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sun_family = AF_UNIX;
+		if(path.size() >= sizeof(addr.sun_path))
+			throw runtime_error("socket path "+path+" is too long");
+		strcpy(addr.sun_path, path.c_str());
+		unlink(path.c_str());
+		if(bind(fd, (sockaddr*)&addr, sizeof(addr)) != 0)
+			throw runtime_error("could not bind socket to "+path);
+		if(listen(fd, 64) != 0)
+			throw runtime_error("could not listen on "+path);
+		return fd;
+	}
+}
+
+int main(int argc, char*argv[]){
+	try{
+		string socket_path;
+		int thread_count = thread::hardware_concurrency();
+		if(thread_count < 1)
+			thread_count = 1;
+
+		for(int i=1; i<argc; ++i){
+			string arg = argv[i];
+			if(arg == "--socket" && i+1 < argc)
+				socket_path = argv[++i];
+			else if(arg == "--threads" && i+1 < argc)
+				thread_count = max(1, stoi(argv[++i]));
+			else{
+				cout
+					<< "Usage: " << argv[0] << " [--socket path] [--threads count]\n\n"
+					<< "Keeps named graphs in memory and answers separator and order requests using the framed\n"
+					<< "binary protocol of server_protocol.h. Without --socket the requests are read from stdin\n"
+					<< "and the responses are written to stdout. Requests run on a pool of count threads." << endl;
+				return arg == "--help" ? 0 : 1;
+			}
+		}
+
+		signal(SIGPIPE, SIG_IGN);
+
+		ThreadPool pool(thread_count);
+
+		if(socket_path.empty()){
+			serve_connection(make_shared<Connection>(0, 1), pool);
+		}else{
+			listen_fd = open_unix_socket(socket_path);
+			vector<thread>readers;
+			vector<weak_ptr<Connection>>connections;
+			while(!shutdown_requested){
+				int fd = accept(listen_fd, nullptr, nullptr);
+				if(fd < 0){
+					if(errno == EINTR)
+						continue;
+					break;
+				}
+				auto connection = make_shared<Connection>(fd, fd);
+				connections.push_back(connection);
+				readers.emplace_back(serve_connection, move(connection), ref(pool));
+			}
+			close(listen_fd);
+			unlink(socket_path.c_str());
+
+			// Wakes up the readers blocked on idle connections. The pending responses can still be
+			// written, as only the reading direction is shut down.
+			for(auto&c:connections)
+				if(auto connection = c.lock())
+					::shutdown(connection->in_fd, SHUT_RD);
+			for(auto&r:readers)
+				r.join();
+		}
+	}catch(exception&err){
+		cerr << "Exception : " << err.what() << endl;
+		return 1;
+	}
+}
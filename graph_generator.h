@@ -0,0 +1,350 @@
+#ifndef GRAPH_GENERATOR_H
+#define GRAPH_GENERATOR_H
+
+#include "list_graph.h"
+#include "array_id_func.h"
+#include "union_find.h"
+#include "connected_components.h"
+#include "histogram.h"
+#include "min_max.h"
+#include <vector>
+#include <utility>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+// Deterministic generators of symmetric test graphs. The graphs are connected and have no loops or
+// multi arcs. Their arcs are sorted by tail and then by head. Graphs whose construction may be
+// disconnected are reduced to their largest connected component. Geometric generators use the
+// rounded Euclidean length in the unit square times 10^6 as arc weight, all others the weight 1.
+namespace graph_generator{
+
+	struct Point{
+		double x, y;
+	};
+
+	struct Edge{
+		int x, y;
+		int weight;
+	};
+
+	//! Turns a list of undirected edges into a graph.
+	inline ListGraph make_graph_from_edge_list(int node_count, std::vector<Edge>edges){
+		for(auto&e:edges)
+			if(e.x > e.y)
+				std::swap(e.x, e.y);
+		std::sort(edges.begin(), edges.end(), [](const Edge&l, const Edge&r){ return std::make_pair(l.x, l.y) < std::make_pair(r.x, r.y); });
+		edges.erase(std::unique(edges.begin(), edges.end(), [](const Edge&l, const Edge&r){ return l.x == r.x && l.y == r.y; }), edges.end());
+		edges.erase(std::remove_if(edges.begin(), edges.end(), [](const Edge&e){ return e.x == e.y; }), edges.end());
+
+		// Keep only the largest connected component.
+		UnionFind uf(node_count);
+		for(auto&e:edges)
+			uf.unite(e.x, e.y);
+		int largest = 0;
+		for(int x=0; x<node_count; ++x)
+			if(uf.component_size(x) > uf.component_size(largest))
+				largest = x;
+		largest = uf(largest);
+
+		ArrayIDFunc<int>new_id(node_count);
+		int new_node_count = 0;
+		for(int x=0; x<node_count; ++x)
+			new_id[x] = uf(x) == largest ? new_node_count++ : -1;
+
+		std::vector<std::pair<int, std::pair<int, int>>>arcs;
+		arcs.reserve(2*edges.size());
+		for(auto&e:edges){
+			if(new_id(e.x) != -1){
+				arcs.push_back({new_id(e.x), {new_id(e.y), e.weight}});
+				arcs.push_back({new_id(e.y), {new_id(e.x), e.weight}});
+			}
+		}
+		std::sort(arcs.begin(), arcs.end());
+
+		ListGraph g(new_node_count, arcs.size());
+		for(int i=0; i<(int)arcs.size(); ++i){
+			g.tail[i] = arcs[i].first;
+			g.head[i] = arcs[i].second.first;
+			g.arc_weight[i] = arcs[i].second.second;
+		}
+		g.node_weight.fill(1);
+		return g; // NVRO
+	}
+
+	inline std::vector<Point>make_random_points(int node_count, int seed){
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<double>dist(0.0, 1.0);
+		std::vector<Point>p(node_count);
+		for(auto&x:p){
+			x.x = dist(gen);
+			x.y = dist(gen);
+		}
+		return p; // NVRO
+	}
+
+	inline int euclidean_weight(Point a, Point b){
+		return std::max(1, (int)std::lround(1000000.0*std::hypot(a.x-b.x, a.y-b.y)));
+	}
+
+	//! A side_length times side_length grid.
+	inline ListGraph make_grid_graph(int side_length){
+		std::vector<Edge>edges;
+		auto node = [&](int x, int y){ return x + y*side_length; };
+		for(int y=0; y<side_length; ++y){
+			for(int x=0; x<side_length; ++x){
+				if(x != side_length-1)
+					edges.push_back({node(x, y), node(x+1, y), 1});
+				if(y != side_length-1)
+					edges.push_back({node(x, y), node(x, y+1), 1});
+			}
+		}
+		return make_graph_from_edge_list(side_length*side_length, std::move(edges));
+	}
+
+	//! Connects all pairs of random points closer than the radius that gives the requested expected
+	//! average degree. The points are bucketed into cells whose side is the radius.
+	inline ListGraph make_random_geometric_graph(int node_count, double average_degree, int seed){
+		auto p = make_random_points(node_count, seed);
+		const double radius = std::sqrt(average_degree / (M_PI * node_count));
+		const int cells_per_side = std::max(1, (int)(1.0/radius));
+
+		auto cell_of = [&](double c){ return std::min(cells_per_side-1, (int)(c*cells_per_side)); };
+
+		std::vector<std::vector<int>>cell(cells_per_side*cells_per_side);
+		for(int i=0; i<node_count; ++i)
+			cell[cell_of(p[i].x) + cells_per_side*cell_of(p[i].y)].push_back(i);
+
+		std::vector<Edge>edges;
+		for(int i=0; i<node_count; ++i){
+			int cx = cell_of(p[i].x), cy = cell_of(p[i].y);
+			for(int y=std::max(0, cy-1); y<=std::min(cells_per_side-1, cy+1); ++y)
+				for(int x=std::max(0, cx-1); x<=std::min(cells_per_side-1, cx+1); ++x)
+					for(int j:cell[x + cells_per_side*y])
+						if(i < j && std::hypot(p[i].x-p[j].x, p[i].y-p[j].y) <= radius)
+							edges.push_back({i, j, euclidean_weight(p[i], p[j])});
+		}
+		return make_graph_from_edge_list(node_count, std::move(edges));
+	}
+
+	namespace detail{
+		inline double orientation(Point a, Point b, Point c){
+			return (b.x-a.x)*(c.y-a.y) - (b.y-a.y)*(c.x-a.x);
+		}
+
+		//! Positive if d lies inside the circumcircle of the counterclockwise triangle abc.
+		inline double in_circle(Point a, Point b, Point c, Point d){
+			double ax = a.x-d.x, ay = a.y-d.y;
+			double bx = b.x-d.x, by = b.y-d.y;
+			double cx = c.x-d.x, cy = c.y-d.y;
+			return
+				(ax*ax + ay*ay) * (bx*cy - cx*by) -
+				(bx*bx + by*by) * (ax*cy - cx*ay) +
+				(cx*cx + cy*cy) * (ax*by - bx*ay);
+		}
+
+		struct Triangle{
+			//! Counterclockwise corners.
+			int v[3];
+			//! The neighbor across the edge opposite to v[i] or -1.
+			int neighbor[3];
+			bool is_alive;
+		};
+	}
+
+	//! The Delaunay triangulation of points in the unit square using the Bowyer-Watson algorithm.
+	//! The points are inserted along a snake order of grid cells, which keeps the walks that locate
+	//! the next point short.
+	inline std::vector<Edge>compute_delaunay_edges(const std::vector<Point>&input_point){
+		using detail::Triangle;
+		const int node_count = input_point.size();
+
+		std::vector<Point>p = input_point;
+		p.push_back({-3.0, -3.0});
+		p.push_back({10.0, -3.0});
+		p.push_back({-3.0, 10.0});
+
+		std::vector<Triangle>tri;
+		std::vector<int>free_triangle;
+		tri.push_back({{node_count, node_count+1, node_count+2}, {-1, -1, -1}, true});
+
+		std::vector<int>insertion_order(node_count);
+		{
+			const int cells_per_side = std::max(1, (int)std::sqrt(node_count/4.0));
+			auto cell_key = [&](int i){
+				int cx = std::min(cells_per_side-1, (int)(p[i].x*cells_per_side));
+				int cy = std::min(cells_per_side-1, (int)(p[i].y*cells_per_side));
+				if(cy % 2 == 1)
+					cx = cells_per_side-1-cx;
+				return cy*cells_per_side + cx;
+			};
+			for(int i=0; i<node_count; ++i)
+				insertion_order[i] = i;
+			std::stable_sort(insertion_order.begin(), insertion_order.end(), [&](int l, int r){ return cell_key(l) < cell_key(r); });
+		}
+
+		std::vector<int>cavity, stack;
+		std::vector<char>in_cavity;
+		struct BoundaryEdge{ int a, b, outside; };
+		std::vector<BoundaryEdge>boundary;
+		std::vector<int>new_triangle;
+
+		int last = 0;
+		for(int q:insertion_order){
+			// Visibility walk to the triangle containing q.
+			int t = last;
+			for(;;){
+				bool moved = false;
+				for(int i=0; i<3; ++i){
+					const Triangle&tr = tri[t];
+					if(detail::orientation(p[tr.v[(i+1)%3]], p[tr.v[(i+2)%3]], p[q]) < 0 && tr.neighbor[i] != -1){
+						t = tr.neighbor[i];
+						moved = true;
+						break;
+					}
+				}
+				if(!moved)
+					break;
+			}
+
+			// Collect the triangles whose circumcircle contains q.
+			in_cavity.resize(tri.size(), false);
+			cavity.clear();
+			boundary.clear();
+			stack.assign(1, t);
+			in_cavity[t] = true;
+			while(!stack.empty()){
+				int s = stack.back();
+				stack.pop_back();
+				cavity.push_back(s);
+				for(int i=0; i<3; ++i){
+					int n = tri[s].neighbor[i];
+					int a = tri[s].v[(i+1)%3], b = tri[s].v[(i+2)%3];
+					if(n != -1 && in_cavity[n])
+						continue;
+					if(n != -1 && detail::in_circle(p[tri[n].v[0]], p[tri[n].v[1]], p[tri[n].v[2]], p[q]) > 0){
+						in_cavity[n] = true;
+						stack.push_back(n);
+					}else{
+						boundary.push_back({a, b, n});
+					}
+				}
+			}
+
+			// Fan the boundary of the cavity around q. The new triangle of the boundary edge ab is
+			// q a b. Its neighbor across qa is the triangle of the edge ending in a.
+			new_triangle.clear();
+			for(auto c:cavity){
+				tri[c].is_alive = false;
+				in_cavity[c] = false;
+				free_triangle.push_back(c);
+			}
+			for(auto&e:boundary){
+				int id;
+				if(!free_triangle.empty()){
+					id = free_triangle.back();
+					free_triangle.pop_back();
+				}else{
+					id = tri.size();
+					tri.push_back(Triangle());
+					in_cavity.push_back(false);
+				}
+				tri[id] = {{q, e.a, e.b}, {e.outside, -1, -1}, true};
+				if(e.outside != -1)
+					for(int i=0; i<3; ++i)
+						if(tri[e.outside].v[(i+1)%3] == e.b && tri[e.outside].v[(i+2)%3] == e.a)
+							tri[e.outside].neighbor[i] = id;
+				new_triangle.push_back(id);
+			}
+			for(auto s:new_triangle){
+				for(auto r:new_triangle){
+					if(tri[r].v[1] == tri[s].v[2])
+						tri[s].neighbor[1] = r;
+					if(tri[r].v[2] == tri[s].v[1])
+						tri[s].neighbor[2] = r;
+				}
+			}
+			last = new_triangle.front();
+		}
+
+		std::vector<Edge>edges;
+		for(auto&tr:tri){
+			if(!tr.is_alive)
+				continue;
+			for(int i=0; i<3; ++i){
+				int a = tr.v[i], b = tr.v[(i+1)%3];
+				// Every edge between input points has a triangle on both sides. Only one of them
+				// sees it in increasing direction.
+				if(a < b && b < node_count)
+					edges.push_back({a, b, euclidean_weight(p[a], p[b])});
+			}
+		}
+		return edges; // NVRO
+	}
+
+	inline ListGraph make_delaunay_graph(int node_count, int seed){
+		return make_graph_from_edge_list(node_count, compute_delaunay_edges(make_random_points(node_count, seed)));
+	}
+
+	//! A sparse planar graph resembling a road network: the Euclidean minimum spanning tree of a
+	//! Delaunay triangulation plus a random fraction of the remaining Delaunay edges. The average
+	//! degree is about 2 + 4*extra_edge_fraction.
+	inline ListGraph make_road_like_graph(int node_count, double extra_edge_fraction, int seed){
+		auto edges = compute_delaunay_edges(make_random_points(node_count, seed));
+		std::sort(edges.begin(), edges.end(), [](const Edge&l, const Edge&r){ return l.weight < r.weight; });
+
+		std::mt19937 gen(seed+1);
+		std::uniform_real_distribution<double>dist(0.0, 1.0);
+
+		UnionFind uf(node_count);
+		std::vector<Edge>road;
+		for(auto&e:edges){
+			double r = dist(gen);
+			if(uf(e.x) != uf(e.y)){
+				uf.unite(e.x, e.y);
+				road.push_back(e);
+			}else if(r < extra_edge_fraction){
+				road.push_back(e);
+			}
+		}
+		return make_graph_from_edge_list(node_count, std::move(road));
+	}
+
+	//! The Barabasi-Albert model. Every new node is connected to edges_per_node distinct earlier
+	//! nodes chosen with probability proportional to their degree, which yields a power-law degree
+	//! distribution.
+	inline ListGraph make_power_law_graph(int node_count, int edges_per_node, int seed){
+		std::mt19937 gen(seed);
+		std::vector<Edge>edges;
+		std::vector<int>arc_end;
+
+		const int initial = std::min(node_count, edges_per_node+1);
+		for(int x=0; x<initial; ++x){
+			for(int y=x+1; y<initial; ++y){
+				edges.push_back({x, y, 1});
+				arc_end.push_back(x);
+				arc_end.push_back(y);
+			}
+		}
+
+		std::vector<int>target;
+		for(int x=initial; x<node_count; ++x){
+			target.clear();
+			std::uniform_int_distribution<int>dist(0, arc_end.size()-1);
+			while((int)target.size() < edges_per_node){
+				int y = arc_end[dist(gen)];
+				if(std::find(target.begin(), target.end(), y) == target.end())
+					target.push_back(y);
+			}
+			for(int y:target){
+				edges.push_back({x, y, 1});
+				arc_end.push_back(x);
+				arc_end.push_back(y);
+			}
+		}
+		return make_graph_from_edge_list(node_count, std::move(edges));
+	}
+}
+
+#endif
@@ -131,6 +131,10 @@ int compute_number_of_shortcuts_added_if_contracted(const ArrayIDFunc<std::vecto
 }
 
 ArrayIDIDFunc compute_greedy_min_degree_order(const ArrayIDIDFunc&tail, const ArrayIDIDFunc&head){
+	return compute_greedy_min_degree_order_with_max_width(tail, head, tail.image_count());
+}
+
+ArrayIDIDFunc compute_greedy_min_degree_order_with_max_width(const ArrayIDIDFunc&tail, const ArrayIDIDFunc&head, int max_width){
 	const int node_count = tail.image_count();
 	
 	auto g = build_dyn_array(tail, head);
@@ -146,6 +150,10 @@ ArrayIDIDFunc compute_greedy_min_degree_order(const ArrayIDIDFunc&tail, const Ar
 	while(!q.empty()){
 		auto x = q.pop();
 
+		// The degree of x is the number of its upward arcs in the chordal supergraph.
+		if((int)g(x).size() > max_width)
+			return ArrayIDIDFunc();
+
 		order[next_pos++] = x;
 
 		for(auto y:contract_node(g, x)){
@@ -4,6 +4,9 @@
 #include "array_id_func.h"
 
 ArrayIDIDFunc compute_greedy_min_degree_order(const ArrayIDIDFunc&tail, const ArrayIDIDFunc&head);
+//! Returns an empty function if the width of the order, and thus the upper tree width bound, exceeds max_width.
+//! The contraction stops as soon as this happens.
+ArrayIDIDFunc compute_greedy_min_degree_order_with_max_width(const ArrayIDIDFunc&tail, const ArrayIDIDFunc&head, int max_width);
 ArrayIDIDFunc compute_greedy_min_shortcut_order(const ArrayIDIDFunc&tail, const ArrayIDIDFunc&head);
 ArrayIDIDFunc compute_greedy_independent_set_order(const ArrayIDIDFunc&tail, const ArrayIDIDFunc&head, bool degree_guided);
 ArrayIDIDFunc compute_greedy_min_shortcut_order(const ArrayIDIDFunc&tail, const ArrayIDIDFunc&head, int hash_factor, int hash_modulo);
@@ -0,0 +1,217 @@
+#include "hypergraph.h"
+#include "io_helper.h"
+
+#include <stdexcept>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+static
+Hypergraph make_hypergraph(
+	int node_count, int net_count,
+	const std::vector<int>&pin_net, const std::vector<int>&pin_node,
+	const std::vector<int>&net_weight, const std::vector<int>&node_weight
+){
+	Hypergraph h(node_count, net_count, pin_net.size());
+	for(int i=0; i<(int)pin_net.size(); ++i){
+		h.pin_net[i] = pin_net[i];
+		h.pin_node[i] = pin_node[i];
+	}
+	for(int i=0; i<net_count; ++i)
+		h.net_weight[i] = net_weight[i];
+	for(int i=0; i<node_count; ++i)
+		h.node_weight[i] = node_weight[i];
+	return h; // NVRO
+}
+
+static
+bool is_comment_or_empty_line(const std::string&line){
+	return line.empty() || line.front() == '%';
+}
+
+static
+Hypergraph load_hmetis_hypergraph_impl(std::istream&in){
+	std::string line;
+	int line_num = 0;
+	bool header_read = false;
+
+	int node_count = 0, net_count = 0;
+	bool has_net_weights = false, has_node_weights = false;
+
+	std::vector<int>pin_net, pin_node, net_weight, node_weight;
+
+	try{
+		while(std::getline(in, line)){
+			++line_num;
+			if(is_comment_or_empty_line(line))
+				continue;
+			std::istringstream line_in(line);
+			if(!header_read){
+				header_read = true;
+
+				if(!(line_in >> net_count >> node_count))
+					throw std::runtime_error("Can not read header");
+				if(net_count < 0)
+					throw std::runtime_error("net_count must be non-negative; it is "+std::to_string(net_count));
+				if(node_count < 0)
+					throw std::runtime_error("node_count must be non-negative; it is "+std::to_string(node_count));
+
+				std::string fmt;
+				if(line_in >> fmt){
+					if(fmt == "1"){
+						has_net_weights = true;
+					}else if(fmt == "10"){
+						has_node_weights = true;
+					}else if(fmt == "11"){
+						has_net_weights = true;
+						has_node_weights = true;
+					}else if(fmt != "0")
+						throw std::runtime_error("The fmt parameter in the header must be 0, 1, 10 or 11.");
+
+					std::string ignore;
+					if(line_in >> ignore)
+						throw std::runtime_error("Header must only contain 2 or 3 integers");
+				}
+			}else if((int)net_weight.size() < net_count){
+				int weight = 1;
+				if(has_net_weights)
+					if(!(line_in >> weight))
+						throw std::runtime_error("Cannot read net weight");
+
+				int net = net_weight.size();
+				int x;
+				while(line_in >> x){
+					if(x < 1 || x > node_count)
+						throw std::runtime_error("Node ID "+std::to_string(x)+" is out of bounds");
+					pin_net.push_back(net);
+					pin_node.push_back(x-1);
+				}
+				if(!line_in.eof())
+					throw std::runtime_error("Cannot read pin");
+				net_weight.push_back(weight);
+			}else if(has_node_weights && (int)node_weight.size() < node_count){
+				int weight;
+				if(!(line_in >> weight))
+					throw std::runtime_error("Cannot read node weight");
+				node_weight.push_back(weight);
+			}else
+				throw std::runtime_error("More nets or node weights than claimed in the header");
+		}
+	}catch(const std::runtime_error&err){
+		throw std::runtime_error(std::string(err.what()) + " in line "+std::to_string(line_num));
+	}
+
+	if(!header_read)
+		throw std::runtime_error("The file is empty");
+	if((int)net_weight.size() != net_count)
+		throw std::runtime_error("Less nets than claimed in the header");
+	if(has_node_weights && (int)node_weight.size() != node_count)
+		throw std::runtime_error("Less node weights than nodes");
+	if(!has_node_weights)
+		node_weight.assign(node_count, 1);
+
+	return make_hypergraph(node_count, net_count, pin_net, pin_node, net_weight, node_weight);
+}
+
+Hypergraph load_hmetis_hypergraph(const std::string&file_name){
+	return load_uncached_text_file(file_name, load_hmetis_hypergraph_impl);
+}
+
+static
+Hypergraph load_patoh_hypergraph_impl(std::istream&in){
+	std::string line;
+	int line_num = 0;
+	bool header_read = false;
+
+	int base = 0, node_count = 0, net_count = 0, pin_count = 0;
+	bool has_net_weights = false, has_node_weights = false;
+
+	std::vector<int>pin_net, pin_node, net_weight, node_weight;
+
+	try{
+		while(std::getline(in, line)){
+			++line_num;
+			if(is_comment_or_empty_line(line))
+				continue;
+			std::istringstream line_in(line);
+			if(!header_read){
+				header_read = true;
+
+				if(!(line_in >> base >> node_count >> net_count >> pin_count))
+					throw std::runtime_error("Can not read header");
+				if(base != 0 && base != 1)
+					throw std::runtime_error("The index base must be 0 or 1; it is "+std::to_string(base));
+				if(node_count < 0)
+					throw std::runtime_error("node_count must be non-negative; it is "+std::to_string(node_count));
+				if(net_count < 0)
+					throw std::runtime_error("net_count must be non-negative; it is "+std::to_string(net_count));
+				if(pin_count < 0)
+					throw std::runtime_error("pin_count must be non-negative; it is "+std::to_string(pin_count));
+
+				int weight_scheme;
+				if(line_in >> weight_scheme){
+					if(weight_scheme < 0 || weight_scheme > 3)
+						throw std::runtime_error("The weight scheme in the header must be 0, 1, 2 or 3.");
+					has_node_weights = weight_scheme & 1;
+					has_net_weights = weight_scheme & 2;
+
+					int constraint_count;
+					if(line_in >> constraint_count)
+						if(constraint_count != 1)
+							throw std::runtime_error("Only one node weight per node is supported");
+				}
+				pin_net.reserve(pin_count);
+				pin_node.reserve(pin_count);
+			}else if((int)net_weight.size() < net_count){
+				int weight = 1;
+				if(has_net_weights)
+					if(!(line_in >> weight))
+						throw std::runtime_error("Cannot read net weight");
+
+				int net = net_weight.size();
+				int x;
+				while(line_in >> x){
+					x -= base;
+					if(x < 0 || x >= node_count)
+						throw std::runtime_error("Node ID "+std::to_string(x+base)+" is out of bounds");
+					pin_net.push_back(net);
+					pin_node.push_back(x);
+				}
+				if(!line_in.eof())
+					throw std::runtime_error("Cannot read pin");
+				net_weight.push_back(weight);
+			}else if(has_node_weights && (int)node_weight.size() < node_count){
+				// The node weights can be spread over several lines.
+				int weight;
+				while(line_in >> weight){
+					if((int)node_weight.size() == node_count)
+						throw std::runtime_error("More node weights than nodes");
+					node_weight.push_back(weight);
+				}
+				if(!line_in.eof())
+					throw std::runtime_error("Cannot read node weight");
+			}else
+				throw std::runtime_error("More nets or node weights than claimed in the header");
+		}
+	}catch(const std::runtime_error&err){
+		throw std::runtime_error(std::string(err.what()) + " in line "+std::to_string(line_num));
+	}
+
+	if(!header_read)
+		throw std::runtime_error("The file is empty");
+	if((int)net_weight.size() != net_count)
+		throw std::runtime_error("Less nets than claimed in the header");
+	if((int)pin_net.size() != pin_count)
+		throw std::runtime_error("The header claims "+std::to_string(pin_count)+" pins but the file contains "+std::to_string(pin_net.size()));
+	if(has_node_weights && (int)node_weight.size() != node_count)
+		throw std::runtime_error("Less node weights than nodes");
+	if(!has_node_weights)
+		node_weight.assign(node_count, 1);
+
+	return make_hypergraph(node_count, net_count, pin_net, pin_node, net_weight, node_weight);
+}
+
+Hypergraph load_patoh_hypergraph(const std::string&file_name){
+	return load_uncached_text_file(file_name, load_patoh_hypergraph_impl);
+}
@@ -0,0 +1,29 @@
+#ifndef HYPERGRAPH_H
+#define HYPERGRAPH_H
+
+#include "array_id_func.h"
+
+#include <string>
+
+//! A hypergraph stored as a list of pins. A pin is a pair of a net and a node contained in it.
+//! The pins are sorted by net.
+struct Hypergraph{
+	Hypergraph()=default;
+	Hypergraph(int node_count, int net_count, int pin_count)
+		:pin_net(pin_count, net_count), pin_node(pin_count, node_count), net_weight(net_count), node_weight(node_count){}
+
+	int node_count()const{ return pin_node.image_count(); }
+	int net_count()const{ return pin_net.image_count(); }
+	int pin_count()const{ return pin_node.preimage_count(); }
+
+	ArrayIDIDFunc pin_net, pin_node;
+	ArrayIDFunc<int>net_weight, node_weight;
+};
+
+//! The hMETIS format. Node IDs in the file start at 1.
+Hypergraph load_hmetis_hypergraph(const std::string&file_name);
+
+//! The PaToH format. Only a single node weight per node is supported.
+Hypergraph load_patoh_hypergraph(const std::string&file_name);
+
+#endif
@@ -0,0 +1,274 @@
+#ifndef HYPERGRAPH_FLOW_CUTTER_H
+#define HYPERGRAPH_FLOW_CUTTER_H
+
+#include "flow_cutter.h"
+#include "range.h"
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+
+namespace flow_cutter{
+
+	//!
+	//! The Lawler expansion is a virtual flow network of a hypergraph whose minimum cuts are
+	//! minimum net cuts of the hypergraph. Its size is linear in the pin count.
+	//!
+	//! Every hypernode is a node. Every net e is represented by two nodes e_in and e_out.
+	//! For every pin of a net e and a node v the arcs v -> e_in and e_out -> v are created
+	//! For every net e the net arc e_in -> e_out is created
+	//! All these arcs have capacity 1 and each has a back arc with capacity 0.
+	//!
+	//! Cutting a pin arc is never cheaper than cutting the net arc of its net. Every cut of the
+	//! expansion thus induces a net cut of the hypergraph that is not larger.
+	//!
+	//! The net nodes have weight 0 and therefore the balance only counts hypernodes.
+	//!
+	//! The nodes are numbered as follows: first the hypernodes, then e_in and e_out of every net.
+	//! The pin p has the arcs 4p to 4p+3, followed by the net arcs. An arc and its back arc only
+	//! differ in the lowest bit.
+	//!
+
+	namespace lawler_expansion{
+		inline int expanded_node_count(int hypernode_count, int net_count){ return hypernode_count+2*net_count; }
+		inline int expanded_arc_count(int pin_count, int net_count){ return 4*pin_count+2*net_count; }
+		inline bool is_hypernode(int x, int hypernode_count){ return x < hypernode_count; }
+		inline int net_to_expanded_node(int e, bool is_out, int hypernode_count){ return hypernode_count+2*e+is_out; }
+		inline int expanded_node_to_net(int x, int hypernode_count){ return (x-hypernode_count)/2; }
+		inline bool is_expanded_net_arc(int a, int pin_count){ return a >= 4*pin_count; }
+		inline int expanded_net_arc_to_net(int a, int pin_count){ return (a-4*pin_count)/2; }
+		inline int net_to_expanded_net_arc(int e, bool is_back_arc, int pin_count){ return 4*pin_count+2*e+is_back_arc; }
+		inline int expanded_pin_arc_to_pin(int a){ return a/4; }
+
+		template<class PinNet, class PinNode>
+		int expanded_arc_tail(int a, const PinNet&pin_net, const PinNode&pin_node){
+			int hypernode_count = pin_node.image_count();
+			int pin_count = pin_node.preimage_count();
+			if(is_expanded_net_arc(a, pin_count)){
+				return net_to_expanded_node(expanded_net_arc_to_net(a, pin_count), a&1, hypernode_count);
+			}else{
+				int p = expanded_pin_arc_to_pin(a);
+				switch(a&3){
+				case 0: // v -> e_in
+				case 3: // v -> e_out
+					return pin_node(p);
+				case 1: // e_in -> v
+					return net_to_expanded_node(pin_net(p), false, hypernode_count);
+				default: // e_out -> v
+					return net_to_expanded_node(pin_net(p), true, hypernode_count);
+				}
+			}
+		}
+
+		template<class PinNet, class PinNode>
+		struct Tail{
+			PinNet pin_net;
+			PinNode pin_node;
+
+			int preimage_count()const{return expanded_arc_count(pin_node.preimage_count(), pin_net.image_count());}
+			int image_count()const{return expanded_node_count(pin_node.image_count(), pin_net.image_count());}
+
+			int operator()(int a)const{
+				return expanded_arc_tail(a, pin_net, pin_node);
+			}
+		};
+
+		template<class PinNet, class PinNode>
+		struct Head{
+			PinNet pin_net;
+			PinNode pin_node;
+
+			int preimage_count()const{return expanded_arc_count(pin_node.preimage_count(), pin_net.image_count());}
+			int image_count()const{return expanded_node_count(pin_node.image_count(), pin_net.image_count());}
+
+			int operator()(int a)const{
+				return expanded_arc_tail(a^1, pin_net, pin_node);
+			}
+		};
+
+		struct BackArc{
+			int pin_count, net_count;
+
+			int preimage_count()const{return expanded_arc_count(pin_count, net_count);}
+			int image_count()const{return expanded_arc_count(pin_count, net_count);}
+
+			int operator()(int a)const{
+				return a^1;
+			}
+		};
+
+		struct Capacity{
+			int pin_count, net_count;
+
+			int preimage_count()const{return expanded_arc_count(pin_count, net_count);}
+
+			int operator()(int a)const{
+				return !(a&1);
+			}
+		};
+
+		template<class HypernodeWeight>
+		struct NodeWeight{
+			int net_count;
+			HypernodeWeight hypernode_weight;
+
+			int preimage_count()const{return expanded_node_count(hypernode_weight.preimage_count(), net_count);}
+
+			int operator()(int x)const{
+				if(is_hypernode(x, hypernode_weight.preimage_count()))
+					return hypernode_weight(x);
+				else
+					return 0;
+			}
+		};
+
+		//! Only used by distance based pierce ratings. Pin arcs have length 1 and net arcs 0.
+		struct ArcWeight{
+			int pin_count, net_count;
+
+			int preimage_count()const{return expanded_arc_count(pin_count, net_count);}
+
+			int operator()(int a)const{
+				return !is_expanded_net_arc(a, pin_count);
+			}
+		};
+
+		//! Iterates over the out arcs of a hypernode, which are two per pin of the node, or over
+		//! the out arcs of e_in or e_out, which are one per pin of e followed by the net arc.
+		template<class NodePinIter>
+		struct OutArcIter{
+			typedef int value_type;
+			typedef int difference_type;
+			typedef const int* pointer;
+			typedef const int& reference;
+			typedef std::forward_iterator_tag iterator_category;
+
+			OutArcIter(){}
+
+			//! The hypernode position pos is the pin iterator plus whether the arc to e_out is next.
+			OutArcIter(NodePinIter node_pin_iter, bool is_to_out):
+				node_pin_iter(node_pin_iter), pos(is_to_out), net_pin_end(-1), net_node_out_flag(false), net_arc(-1){}
+
+			//! At a net node pos is the pin ID and pos == net_pin_end refers to the net arc.
+			OutArcIter(int pos, int net_pin_end, bool net_node_out_flag, int net_arc):
+				node_pin_iter(), pos(pos), net_pin_end(net_pin_end), net_node_out_flag(net_node_out_flag), net_arc(net_arc){}
+
+			OutArcIter&operator++(){
+				if(net_pin_end == -1){
+					if(pos == 1)
+						++node_pin_iter;
+					pos ^= 1;
+				}else{
+					++pos;
+				}
+				return *this;
+			}
+
+			OutArcIter operator++(int) {
+				OutArcIter tmp(*this);
+				operator++();
+				return tmp;
+			}
+
+			int operator*()const{
+				if(net_pin_end == -1)
+					return 4*(*node_pin_iter) + 3*pos;
+				else if(pos != net_pin_end)
+					return 4*pos + 1 + net_node_out_flag;
+				else
+					return net_arc;
+			}
+
+			NodePinIter node_pin_iter;
+			int pos;
+			int net_pin_end;
+			bool net_node_out_flag;
+			int net_arc;
+
+			friend bool operator==(OutArcIter l, OutArcIter r){
+				return l.node_pin_iter == r.node_pin_iter && l.pos == r.pos && l.net_pin_end == r.net_pin_end;
+			}
+
+			friend bool operator!=(OutArcIter l, OutArcIter r){
+				return !(l == r);
+			}
+		};
+
+		//! NodePin maps a hypernode onto its pins. NetPin maps a net onto its pins, which must be
+		//! a range of consecutive pin IDs.
+		template<class NodePin, class NetPin>
+		struct OutArc{
+			typedef typename std::decay<decltype(std::begin(std::declval<const NodePin>()(0)))>::type NodePinIter;
+
+			int pin_count;
+			NodePin node_pin;
+			NetPin net_pin;
+
+			int preimage_count()const{return expanded_node_count(node_pin.preimage_count(), net_pin.preimage_count());}
+
+			Range<OutArcIter<NodePinIter>> operator()(int x)const{
+				int hypernode_count = node_pin.preimage_count();
+				if(is_hypernode(x, hypernode_count)){
+					auto r = node_pin(x);
+					return Range<OutArcIter<NodePinIter>>{
+						OutArcIter<NodePinIter>{std::begin(r), false},
+						OutArcIter<NodePinIter>{std::end(r), false}
+					};
+				}else{
+					int e = expanded_node_to_net(x, hypernode_count);
+					bool out_flag = x != net_to_expanded_node(e, false, hypernode_count);
+					auto r = net_pin(e);
+					int net_arc = net_to_expanded_net_arc(e, out_flag, pin_count);
+					return Range<OutArcIter<NodePinIter>>{
+						OutArcIter<NodePinIter>{*std::begin(r), *std::end(r), out_flag, net_arc},
+						OutArcIter<NodePinIter>{*std::end(r)+1, *std::end(r), out_flag, net_arc}
+					};
+				}
+			}
+		};
+
+		//! PinNet and PinNode map the pins, which must be sorted by net, onto their net and node.
+		//! NodePin and NetPin are their inverses.
+		template<class PinNet, class PinNode, class NodePin, class NetPin, class HypernodeWeight>
+		Graph<
+			lawler_expansion::Tail<PinNet, PinNode>,
+			lawler_expansion::Head<PinNet, PinNode>,
+			lawler_expansion::BackArc,
+			lawler_expansion::NodeWeight<HypernodeWeight>,
+			lawler_expansion::ArcWeight,
+			lawler_expansion::Capacity,
+			lawler_expansion::OutArc<NodePin, NetPin>
+		>
+		make_graph(PinNet pin_net, PinNode pin_node, NodePin node_pin, NetPin net_pin, HypernodeWeight hypernode_weight){
+			int pin_count = pin_node.preimage_count(), net_count = pin_net.image_count();
+			return{
+				lawler_expansion::Tail<PinNet, PinNode>{pin_net, pin_node},
+				lawler_expansion::Head<PinNet, PinNode>{pin_net, pin_node},
+				lawler_expansion::BackArc{pin_count, net_count},
+				lawler_expansion::NodeWeight<HypernodeWeight>{net_count, std::move(hypernode_weight)},
+				lawler_expansion::ArcWeight{pin_count, net_count},
+				lawler_expansion::Capacity{pin_count, net_count},
+				lawler_expansion::OutArc<NodePin, NetPin>{pin_count, std::move(node_pin), std::move(net_pin)}
+			};
+		}
+
+		//! The nets of the hypergraph cut induced by a cut of the expansion, sorted by ID.
+		template<class PinNet>
+		std::vector<int>expanded_cut_to_net_cut(const std::vector<int>&expanded_cut, const PinNet&pin_net){
+			int pin_count = pin_net.preimage_count();
+			std::vector<int>net_cut;
+			net_cut.reserve(expanded_cut.size());
+			for(auto a:expanded_cut){
+				if(is_expanded_net_arc(a, pin_count))
+					net_cut.push_back(expanded_net_arc_to_net(a, pin_count));
+				else
+					net_cut.push_back(pin_net(expanded_pin_arc_to_pin(a)));
+			}
+			std::sort(net_cut.begin(), net_cut.end());
+			net_cut.erase(std::unique(net_cut.begin(), net_cut.end()), net_cut.end());
+			return net_cut; // NVRO
+		}
+	}
+}
+
+#endif
@@ -8,8 +8,15 @@
 #include "geo_pos.h"
 #include "edmond_karp.h"
 #include "dinic.h"
+#include "push_relabel.h"
 #include <vector>
 #include <cassert>
+#include <atomic>
+#include <limits>
+#include <omp.h>
+#include <memory>
+#include <cmath>
+#include <algorithm>
 
 namespace inertial_flow{
 
@@ -68,82 +75,238 @@ namespace inertial_flow{
 			return Cut{~std::move(reachable), node_count-reachable_count, cut_size};
 	}
 
-	template<class CompGeoPos>
-	void build_source_and_target_list(int node_count, double min_balance, const CompGeoPos&comp_geo_pos, ArrayIDIDFunc&source_list, ArrayIDIDFunc&target_list){
+	//! Selects the min_balance*node_count nodes with the smallest projection as sources and 
+	//! the same number of nodes with the largest projection as targets.
+	template<class Projection>
+	void build_source_and_target_list(int node_count, double min_balance, const Projection&projection, ArrayIDIDFunc&source_list, ArrayIDIDFunc&target_list){
 		ArrayIDIDFunc node_order = identity_permutation(node_count);
-		std::sort(node_order.begin(), node_order.end(), comp_geo_pos);
 		int min_side_size = std::max(static_cast<int>(min_balance*node_count), 1);
+		auto comp = [&](int l, int r)->bool{return projection(l) < projection(r);};
+
+		if(2*min_side_size > node_count){
+			std::sort(node_order.begin(), node_order.end(), comp);
+		}else{
+			std::nth_element(node_order.begin(), node_order.begin()+min_side_size-1, node_order.end(), comp);
+			std::nth_element(node_order.begin()+min_side_size, node_order.end()-min_side_size, node_order.end(), comp);
+		}
 
 		source_list = id_id_func(min_side_size, node_count, [&](int x){return node_order[x];});
 		target_list = id_id_func(min_side_size, node_count, [&](int x){return node_order[node_count-x-1];});
+	}
+
+	struct Direction{
+		double lon, lat;
+	};
 
+	//! Returns direction_count directions whose angles are evenly spread over 180 degrees.
+	//! For four directions these are lon, lon+lat, lat and lon-lat.
+	inline std::vector<Direction> make_evenly_spaced_directions(int direction_count){
+		const double pi = 3.14159265359;
+		std::vector<Direction>directions(direction_count);
+		for(int i=0; i<direction_count; ++i){
+			double angle = pi*i/direction_count;
+			if(2*i > direction_count)
+				angle -= pi;
+			directions[i] = {std::cos(angle), std::sin(angle)};
+		}
+		// Make the axis parallel directions exact.
+		for(auto&d:directions){
+			if(std::abs(d.lon) < 1e-12) d.lon = 0.0;
+			if(std::abs(d.lat) < 1e-12) d.lat = 0.0;
+		}
+		return directions; // NVRO
 	}
 
-	template<class InvTail, class Head, class BackArc, class GetGeoPos>
-	Cut compute_inertial_flow_cut(
+	//! Returns the two principal axes of the positions. The first one is the axis along which the 
+	//! nodes are spread the most.
+	template<class GetGeoPos>
+	std::vector<Direction> compute_principal_directions(const GetGeoPos&geo_pos){
+		const int node_count = geo_pos.preimage_count();
+
+		double mean_lon = 0.0, mean_lat = 0.0;
+		for(int x=0; x<node_count; ++x){
+			mean_lon += geo_pos(x).lon;
+			mean_lat += geo_pos(x).lat;
+		}
+		mean_lon /= node_count;
+		mean_lat /= node_count;
+
+		double cov_lon_lon = 0.0, cov_lon_lat = 0.0, cov_lat_lat = 0.0;
+		for(int x=0; x<node_count; ++x){
+			double d_lon = geo_pos(x).lon - mean_lon;
+			double d_lat = geo_pos(x).lat - mean_lat;
+			cov_lon_lon += d_lon*d_lon;
+			cov_lon_lat += d_lon*d_lat;
+			cov_lat_lat += d_lat*d_lat;
+		}
+
+		// The eigenvectors of the symmetric 2x2 covariance matrix are rotated by half the angle 
+		// given by atan2.
+		double angle = 0.5*std::atan2(2*cov_lon_lat, cov_lon_lon - cov_lat_lat);
+		return {
+			{std::cos(angle), std::sin(angle)},
+			{-std::sin(angle), std::cos(angle)}
+		};
+	}
+
+	template<class GetGeoPos>
+	ArrayIDFunc<double> project_geo_pos(const GetGeoPos&geo_pos, Direction d){
+		const int node_count = geo_pos.preimage_count();
+		ArrayIDFunc<double>projection(node_count);
+		for(int x=0; x<node_count; ++x)
+			projection[x] = d.lon*geo_pos(x).lon + d.lat*geo_pos(x).lat;
+		return projection; // NVRO
+	}
+
+	enum class MaxFlowAlgorithm{
+		dinic,
+		push_relabel
+	};
+
+	template<class Instance, class InvTail, class Head, class BackArc>
+	Cut compute_inertial_flow_cut_given_source_and_target_lists(
 		const InvTail&inv_tail, const Head&head, const BackArc&back_arc,
-		const GetGeoPos&geo_pos, 
-		double min_balance
+		const std::vector<ArrayIDIDFunc>&source_list, const std::vector<ArrayIDIDFunc>&target_list,
+		int thread_count
+	){
+		const int instance_count = source_list.size();
+		std::vector<Instance>instance;
+		instance.reserve(instance_count);
+		for(int i=0; i<instance_count; ++i)
+			instance.emplace_back(inv_tail, head, back_arc, source_list[i], target_list[i]);
+
+		if(thread_count <= 1){
+			for(;;){
+				int next_instance = 0;
+				for(int i=1; i<instance_count; ++i)
+					if(instance[i].get_current_flow_intensity() < instance[next_instance].get_current_flow_intensity())
+						next_instance = i;
+
+				if(instance[next_instance].is_finished())
+					return extract_cut_from_maximum_unit_flow(inv_tail, head, instance[next_instance].move_saturated_flags(), source_list[next_instance]);
+				instance[next_instance].advance();
+			}
+		}else{
+			// The winner is the instance with the smallest maximum flow, ties are broken by the
+			// lower instance id. This is the instance that the sequential round robin returns.
+			// Instances are identified by the key flow*instance_count+id. As the flow of an instance 
+			// only grows, it is aborted as soon as its key exceeds the key of a finished instance.
+			std::atomic<long long>best_key(std::numeric_limits<long long>::max());
+
+			#pragma omp parallel for num_threads(std::min(thread_count, instance_count)) schedule(dynamic, 1)
+			for(int i=0; i<instance_count; ++i){
+				for(;;){
+					long long key = (long long)instance_count*instance[i].get_current_flow_intensity() + i;
+					if(key > best_key.load())
+						break;
+					if(instance[i].is_finished()){
+						long long current_best_key = best_key.load();
+						while(key < current_best_key && !best_key.compare_exchange_weak(current_best_key, key))
+							{}
+						break;
+					}
+					instance[i].advance();
+				}
+			}
+
+			int best_instance = best_key.load() % instance_count;
+			return extract_cut_from_maximum_unit_flow(inv_tail, head, instance[best_instance].move_saturated_flags(), source_list[best_instance]);
+		}
+	}
+
+	//! Runs one max flow instance per projection. The sources and targets of an instance are the 
+	//! nodes with the smallest and largest projected values. The cut of the instance with the 
+	//! smallest maximum flow is returned.
+	template<class InvTail, class Head, class BackArc>
+	Cut compute_inertial_flow_cut_given_projections(
+		const InvTail&inv_tail, const Head&head, const BackArc&back_arc,
+		const std::vector<ArrayIDFunc<double>>&projection, 
+		double min_balance,
+		int thread_count = 1,
+		MaxFlowAlgorithm max_flow_algorithm = MaxFlowAlgorithm::dinic
 	){
 		const int node_count = head.image_count();
-		ArrayIDIDFunc 
-			source_list[4], 
-			target_list[4];
-
-		build_source_and_target_list(
-			node_count, min_balance, 
-			[&](int l, int r)->bool{return geo_pos(l).lon < geo_pos(r).lon;}, 
-			source_list[0], target_list[0]
-		);
-		build_source_and_target_list(
-			node_count, min_balance, 
-			[&](int l, int r)->bool{return geo_pos(l).lat < geo_pos(r).lat;}, 
-			source_list[1], target_list[1]
-		);
-		build_source_and_target_list(
-			node_count, min_balance, 
-			[&](int l, int r)->bool{return geo_pos(l).lon+geo_pos(l).lat < geo_pos(r).lon+geo_pos(r).lat;}, 
-			source_list[2], target_list[2]
-		);
-		build_source_and_target_list(
-			node_count, min_balance, 
-			[&](int l, int r)->bool{return geo_pos(l).lon-geo_pos(l).lat < geo_pos(r).lon-geo_pos(r).lat;}, 
-			source_list[3], target_list[3]
-		);
-
-		max_flow::UnitDinicAlgo<InvTail, Head, BackArc, ArrayIDIDFunc, ArrayIDIDFunc> instance [] = { 
-			{inv_tail, head, back_arc, source_list[0], target_list[0]},
-			{inv_tail, head, back_arc, source_list[1], target_list[1]},
-			{inv_tail, head, back_arc, source_list[2], target_list[2]},
-			{inv_tail, head, back_arc, source_list[3], target_list[3]}
-		};
+		const int instance_count = projection.size();
+		assert(instance_count >= 1);
 
-		for(;;){
-			int next_instance = 0;
-			for(int i=1; i<4; ++i)
-				if(instance[i].get_current_flow_intensity() < instance[next_instance].get_current_flow_intensity())
-					next_instance = i;
+		std::vector<ArrayIDIDFunc>
+			source_list(instance_count), 
+			target_list(instance_count);
 
-			if(instance[next_instance].is_finished())
-				return extract_cut_from_maximum_unit_flow(inv_tail, head, instance[next_instance].move_saturated_flags(), source_list[next_instance]);
-			instance[next_instance].advance();
+		#pragma omp parallel for num_threads(std::min(thread_count, instance_count)) if(thread_count > 1)
+		for(int i=0; i<instance_count; ++i)
+			build_source_and_target_list(node_count, min_balance, projection[i], source_list[i], target_list[i]);
+
+		switch(max_flow_algorithm){
+		case MaxFlowAlgorithm::dinic:
+			return compute_inertial_flow_cut_given_source_and_target_lists<max_flow::UnitDinicAlgo<InvTail, Head, BackArc, ArrayIDIDFunc, ArrayIDIDFunc>>(
+				inv_tail, head, back_arc, source_list, target_list, thread_count
+			);
+		case MaxFlowAlgorithm::push_relabel:
+			return compute_inertial_flow_cut_given_source_and_target_lists<max_flow::UnitPushRelabelAlgo<InvTail, Head, BackArc, ArrayIDIDFunc, ArrayIDIDFunc>>(
+				inv_tail, head, back_arc, source_list, target_list, thread_count
+			);
+		default:
+			assert(false);
+			return Cut{};
 		}
 	}
 
+	template<class InvTail, class Head, class BackArc, class GetGeoPos>
+	Cut compute_inertial_flow_cut(
+		const InvTail&inv_tail, const Head&head, const BackArc&back_arc,
+		const GetGeoPos&geo_pos, 
+		double min_balance,
+		int direction_count,
+		int thread_count = 1
+	){
+		std::vector<ArrayIDFunc<double>>projection;
+		for(auto d:make_evenly_spaced_directions(direction_count))
+			projection.push_back(project_geo_pos(geo_pos, d));
+		return compute_inertial_flow_cut_given_projections(inv_tail, head, back_arc, projection, min_balance, thread_count);
+	}
+
 	template<class Tail, class Head, class GetGeoPos>
 	Cut compute_inertial_flow_cut(
 		const Tail&tail, const Head&head, 
 		const GetGeoPos&geo_pos, 
-		double min_balance
+		double min_balance,
+		int direction_count,
+		int thread_count = 1
 	){
 		if(std::is_sorted(tail.begin(), tail.end()))
-			return compute_inertial_flow_cut(invert_sorted_id_id_func(tail), head, compute_back_arc_permutation(tail, head), geo_pos, min_balance);
+			return compute_inertial_flow_cut(invert_sorted_id_id_func(tail), head, compute_back_arc_permutation(tail, head), geo_pos, min_balance, direction_count, thread_count);
 		else
-			return compute_inertial_flow_cut(invert_id_id_func(tail), head, compute_back_arc_permutation(tail, head), geo_pos, min_balance);
+			return compute_inertial_flow_cut(invert_id_id_func(tail), head, compute_back_arc_permutation(tail, head), geo_pos, min_balance, direction_count, thread_count);
+	}
+
+	template<class Tail, class Head>
+	std::vector<int> compute_inertial_flow_separator_given_projections(
+		const Tail&tail, const Head&head, const std::vector<ArrayIDFunc<double>>&projection, double min_balance, 
+		int thread_count = 1, MaxFlowAlgorithm max_flow_algorithm = MaxFlowAlgorithm::dinic
+	){
+		const int arc_count = head.preimage_count();	
+		const int node_count = head.image_count();
+
+		std::vector<int>sep;
+		if(node_count == 1){
+			sep = {0};
+		} else {
+			Cut c;
+			if(std::is_sorted(tail.begin(), tail.end()))
+				c = compute_inertial_flow_cut_given_projections(invert_sorted_id_id_func(tail), head, compute_back_arc_permutation(tail, head), projection, min_balance, thread_count, max_flow_algorithm);
+			else
+				c = compute_inertial_flow_cut_given_projections(invert_id_id_func(tail), head, compute_back_arc_permutation(tail, head), projection, min_balance, thread_count, max_flow_algorithm);
+			
+			for(int i=0; i<arc_count; ++i)
+				if(c.is_on_smaller_side(tail(i)) && !c.is_on_smaller_side(head(i)))
+					sep.push_back(head(i));
+		}
+		return sep; // NVRO
 	}
 
 	template<class Tail, class Head, class GetGeoPos>
-	std::vector<int> compute_inertial_flow_separator(const Tail&tail, const Head&head, const GetGeoPos&geo_pos, double min_balance){
+	std::vector<int> compute_inertial_flow_separator(const Tail&tail, const Head&head, const GetGeoPos&geo_pos, double min_balance, int direction_count, int thread_count = 1){
 		const int arc_count = head.preimage_count();	
 		const int node_count = head.image_count();
 
@@ -151,7 +314,7 @@ namespace inertial_flow{
 		if(node_count == 1){
 			sep = {0};
 		} else {
-			Cut c = compute_inertial_flow_cut(tail, head, geo_pos, min_balance);
+			Cut c = compute_inertial_flow_cut(tail, head, geo_pos, min_balance, direction_count, thread_count);
 			
 			for(int i=0; i<arc_count; ++i)
 				if(c.is_on_smaller_side(tail(i)) && !c.is_on_smaller_side(head(i)))
@@ -160,29 +323,56 @@ namespace inertial_flow{
 		return sep; // NVRO
 	}
 
+	//! The projections onto the fixed directions are computed once for all nodes and looked up 
+	//! through input_node_id in every level of the recursion. The principal directions depend on 
+	//! the subgraph and are therefore recomputed for every call.
 	template<class GetGeoPos>
 	struct InertialFlowSeparator{
-		InertialFlowSeparator(const GetGeoPos&geo_pos, double min_balance):
-			geo_pos(&geo_pos), min_balance(min_balance){}
+		InertialFlowSeparator(const GetGeoPos&geo_pos, double min_balance, int thread_count, int direction_count, bool use_principal_directions, MaxFlowAlgorithm max_flow_algorithm):
+			geo_pos(&geo_pos), min_balance(min_balance), thread_count(thread_count), use_principal_directions(use_principal_directions), max_flow_algorithm(max_flow_algorithm),
+			input_projection(std::make_shared<std::vector<ArrayIDFunc<double>>>()){
+			for(auto d:make_evenly_spaced_directions(direction_count))
+				input_projection->push_back(project_geo_pos(geo_pos, d));
+		}
 
 		template<class Tail, class Head, class InputNodeID, class ArcWeight>
 		std::vector<int>operator()(const Tail&tail, const Head&head, const InputNodeID& input_node_id, const ArcWeight&arc_weight)const{
 			const int node_count = head.image_count();
-			return compute_inertial_flow_separator(
-				tail, head, 
-				id_func(node_count, [&](int x){return (*geo_pos)(input_node_id(x));}),
-				min_balance
-			);
+			if(node_count == 1)
+				return {0};
+
+			std::vector<ArrayIDFunc<double>>projection;
+			for(auto&p:*input_projection){
+				ArrayIDFunc<double>q(node_count);
+				for(int x=0; x<node_count; ++x)
+					q[x] = p(input_node_id(x));
+				projection.push_back(std::move(q));
+			}
+
+			if(use_principal_directions){
+				auto pos = id_func(node_count, [&](int x){return (*geo_pos)(input_node_id(x));});
+				for(auto d:compute_principal_directions(pos))
+					projection.push_back(project_geo_pos(pos, d));
+			}
+
+			return compute_inertial_flow_separator_given_projections(tail, head, projection, min_balance, thread_count, max_flow_algorithm);
 		}
 
 		const GetGeoPos*geo_pos;
 		double min_balance;
+		int thread_count;
+		bool use_principal_directions;
+		MaxFlowAlgorithm max_flow_algorithm;
+		std::shared_ptr<std::vector<ArrayIDFunc<double>>>input_projection;
 	};
 
 	template<class GetGeoPos>
 	InertialFlowSeparator<GetGeoPos>
-		ComputeSeparator(const GetGeoPos&geo_pos, double min_balance){
-		return {geo_pos, min_balance};
+		ComputeSeparator(
+			const GetGeoPos&geo_pos, double min_balance, int thread_count = 1, int direction_count = 4, bool use_principal_directions = false,
+			MaxFlowAlgorithm max_flow_algorithm = MaxFlowAlgorithm::dinic
+		){
+		return {geo_pos, min_balance, thread_count, direction_count, use_principal_directions, max_flow_algorithm};
 	}
 }
 
@@ -0,0 +1,209 @@
+#ifndef KARGER_CUT_H
+#define KARGER_CUT_H
+
+#include "array_id_func.h"
+#include "tiny_id_func.h"
+#include "union_find.h"
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <omp.h>
+
+// Randomized minimum cuts by random contraction. Every arc is treated as an undirected edge, i.e.,
+// on a symmetric graph every edge is counted twice. A trial either contracts the graph once down to
+// two nodes (Karger) or uses the recursive contraction scheme of Karger and Stein. Trials are
+// independent and run in parallel.
+namespace karger{
+
+	struct Cut{
+		//! Number of arcs whose endpoints lie on different sides.
+		int arc_count;
+		//! The side of every node.
+		BitIDFunc side;
+	};
+
+	namespace detail{
+		struct Edge{
+			int tail, head;
+		};
+	}
+
+	//! Shares the loop-free edge list among all trials and hands out the random generators from
+	//! which the trials draw their arc permutations. The generator of a trial only depends on the
+	//! seed and the trial id, so the result does not depend on the thread count. The permutations
+	//! are drawn lazily by a partial Fisher-Yates shuffle, so only as many arcs as are contracted
+	//! are ever drawn.
+	class ArcPermutationSource{
+	public:
+		template<class Tail, class Head>
+		ArcPermutationSource(const Tail&tail, const Head&head, int seed):
+			seed(seed){
+			for(int a=0; a<tail.preimage_count(); ++a)
+				if(tail(a) != head(a))
+					edge_list.push_back({tail(a), head(a)});
+		}
+
+		std::mt19937 make_trial_generator(int trial)const{
+			std::seed_seq seq = {seed, trial};
+			return std::mt19937(seq);
+		}
+
+		const std::vector<detail::Edge>&get_edge_list()const{
+			return edge_list;
+		}
+
+	private:
+		int seed;
+		std::vector<detail::Edge>edge_list;
+	};
+
+	namespace detail{
+		class KargerSteinTrial{
+		public:
+			KargerSteinTrial(int node_count, std::mt19937&gen):
+				node_count(node_count), gen(gen){}
+
+			//! Runs the recursion and returns the best cut found. edge_list must not contain loops
+			//! and the graph must be connected.
+			Cut run(const std::vector<Edge>&edge_list, bool recurse){
+				best.arc_count = std::numeric_limits<int>::max();
+				if(node_count <= 2 || !recurse)
+					contract_and_recurse(edge_list, node_count, 2, 0);
+				else
+					recursive_contract(edge_list, node_count, 0);
+				return std::move(best);
+			}
+
+		private:
+			void recursive_contract(const std::vector<Edge>&edge_list, int current_node_count, int depth){
+				if(current_node_count <= 6){
+					contract_and_recurse(edge_list, current_node_count, 2, depth);
+				}else{
+					int target_node_count = std::ceil(1.0 + current_node_count/std::sqrt(2.0));
+					for(int i=0; i<2; ++i)
+						contract_and_recurse(edge_list, current_node_count, target_node_count, depth);
+				}
+			}
+
+			//! Contracts random edges until only target_node_count nodes remain. The union find
+			//! structure of every recursion depth is reused by all calls at that depth.
+			void contract_and_recurse(const std::vector<Edge>&edge_list, int current_node_count, int target_node_count, int depth){
+				if((int)union_find.size() <= depth){
+					union_find.emplace_back(current_node_count);
+					level_map.emplace_back();
+				}else if(union_find[depth].preimage_count() != current_node_count){
+					union_find[depth] = UnionFind(current_node_count);
+				}else{
+					union_find[depth].reset();
+				}
+				UnionFind&uf = union_find[depth];
+
+				std::vector<Edge>shuffled = edge_list;
+				for(int i=shuffled.size(); i>0 && uf.component_count() > target_node_count; --i){
+					int j = std::uniform_int_distribution<int>(0, i-1)(gen);
+					std::swap(shuffled[i-1], shuffled[j]);
+					uf.unite(shuffled[i-1].tail, shuffled[i-1].head);
+				}
+
+				ArrayIDIDFunc&m = level_map[depth];
+				m = ArrayIDIDFunc(current_node_count, uf.component_count());
+				{
+					ArrayIDFunc<int>rep_id(current_node_count);
+					int next_id = 0;
+					for(int x=0; x<current_node_count; ++x)
+						if(uf.is_representative(x))
+							rep_id[x] = next_id++;
+					for(int x=0; x<current_node_count; ++x)
+						m[x] = rep_id(uf(x));
+				}
+
+				std::vector<Edge>contracted;
+				for(auto e:shuffled){
+					e.tail = m(e.tail);
+					e.head = m(e.head);
+					if(e.tail != e.head)
+						contracted.push_back(e);
+				}
+
+				if(m.image_count() <= 2){
+					if((int)contracted.size() < best.arc_count)
+						record_best(contracted.size(), depth);
+				}else{
+					recursive_contract(contracted, m.image_count(), depth+1);
+				}
+			}
+
+			void record_best(int arc_count, int depth){
+				best.arc_count = arc_count;
+				best.side = BitIDFunc(node_count);
+				for(int x=0; x<node_count; ++x){
+					int y = x;
+					for(int d=0; d<=depth; ++d)
+						y = level_map[d](y);
+					best.side.set(x, y != 0);
+				}
+			}
+
+			int node_count;
+			std::mt19937&gen;
+			std::vector<UnionFind>union_find;
+			std::vector<ArrayIDIDFunc>level_map;
+			Cut best;
+		};
+	}
+
+	//! Runs trial_count independent trials and returns the smallest cut. On ties the cut of the
+	//! trial with the lowest id wins. If the graph is disconnected a cut with no arcs is returned
+	//! without running any trial.
+	template<class Tail, class Head>
+	Cut compute_karger_cut(const Tail&tail, const Head&head, int trial_count, int seed, bool recurse, int thread_count = 1){
+		const int node_count = tail.image_count();
+		const int arc_count = tail.preimage_count();
+
+		if(node_count < 2)
+			throw std::runtime_error("a cut needs at least two nodes");
+
+		{
+			UnionFind uf(node_count);
+			for(int a=0; a<arc_count; ++a)
+				uf.unite(tail(a), head(a));
+			if(uf.component_count() != 1){
+				Cut cut;
+				cut.arc_count = 0;
+				cut.side = BitIDFunc(node_count);
+				int root = uf(0);
+				for(int x=0; x<node_count; ++x)
+					cut.side.set(x, uf(x) != root);
+				return cut; // NVRO
+			}
+		}
+
+		ArcPermutationSource arc_permutation_source(tail, head, seed);
+
+		Cut best;
+		best.arc_count = std::numeric_limits<int>::max();
+		int best_trial = -1;
+
+		#pragma omp parallel for schedule(dynamic) num_threads(thread_count)
+		for(int trial=0; trial<trial_count; ++trial){
+			auto gen = arc_permutation_source.make_trial_generator(trial);
+			detail::KargerSteinTrial t(node_count, gen);
+			Cut cut = t.run(arc_permutation_source.get_edge_list(), recurse);
+
+			#pragma omp critical
+			{
+				if(cut.arc_count < best.arc_count || (cut.arc_count == best.arc_count && trial < best_trial)){
+					best = std::move(cut);
+					best_trial = trial;
+				}
+			}
+		}
+
+		return best; // NVRO
+	}
+}
+
+#endif
+
@@ -12,6 +12,8 @@
 #include "multi_arc.h"
 #include "id_multi_func.h"
 #include "preorder.h"
+#include "greedy_order.h"
+#include "nested_dissection_cutoff.h"
 #include <vector>
 
 #ifndef NDEBUG
@@ -276,6 +278,41 @@ namespace cch_order{
 	}
 
 
+	// Returns an empty order if the connected graph is above the cutoff. Otherwise, the order maps
+	// onto input node IDs.
+	inline
+	ArrayIDIDFunc compute_bottom_level_graph_order_if_graph_is_below_cutoff(
+		const ArrayIDIDFunc&tail, const ArrayIDIDFunc&head, 
+		const ArrayIDIDFunc&input_node_id,
+		const NestedDissectionCutoff&cutoff
+	){
+		const int node_count = tail.image_count();
+
+		auto compute_bottom_level_order = [&]{
+			if(cutoff.bottom_level_orderer == NestedDissectionCutoff::BottomLevelOrderer::min_shortcut)
+				return compute_greedy_min_shortcut_order(tail, head);
+			else
+				return compute_greedy_min_degree_order(tail, head);
+		};
+
+		ArrayIDIDFunc order;
+		if(node_count <= cutoff.max_node_count){
+			order = compute_bottom_level_order();
+		}else if(cutoff.max_tree_width != 0 && node_count <= cutoff.max_tree_width_node_count){
+			// The min degree order is an upper bound on the tree width. If it is small enough, then
+			// it is already the order we are looking for unless another orderer is requested.
+			order = compute_greedy_min_degree_order_with_max_width(tail, head, cutoff.max_tree_width);
+			if(order.preimage_count() != 0 && cutoff.bottom_level_orderer != NestedDissectionCutoff::BottomLevelOrderer::min_degree)
+				order = compute_bottom_level_order();
+		}
+
+		if(order.preimage_count() != 0){
+			order = chain(std::move(order), input_node_id);
+			assert(is_valid_partial_order(order));
+		}
+		return order; // NVRO
+	}
+
 	template<class ComputeSeparator, class ComputePartOrder>
 	ArrayIDIDFunc compute_nested_dissection_graph_order(
 		ArrayIDIDFunc tail, ArrayIDIDFunc head, 
@@ -326,8 +363,15 @@ namespace cch_order{
 		ArrayIDIDFunc tail, ArrayIDIDFunc head, 
 		ArrayIDIDFunc input_node_id,
 		ArrayIDFunc<int> arc_weight, 
-		const ComputeSeparator&compute_separator
+		const ComputeSeparator&compute_separator,
+		const NestedDissectionCutoff&cutoff = NestedDissectionCutoff()
 	){
+		if(cutoff.is_enabled()){
+			auto order = compute_bottom_level_graph_order_if_graph_is_below_cutoff(tail, head, input_node_id, cutoff);
+			if(order.preimage_count() != 0)
+				return order; // NVRO
+		}
+
 		auto compute_graph_part_order = [&](
 			ArrayIDIDFunc a_tail, ArrayIDIDFunc a_head, 
 			ArrayIDIDFunc a_input_node_id, ArrayIDFunc<int>a_arc_weight
@@ -335,7 +379,7 @@ namespace cch_order{
 			return compute_nested_dissection_graph_order(
 				std::move(a_tail), std::move(a_head), 
 				std::move(a_input_node_id), std::move(a_arc_weight), 
-				compute_separator
+				compute_separator, cutoff
 			);
 		};
 		return compute_nested_dissection_graph_order(tail, head, input_node_id, arc_weight, compute_separator, compute_graph_part_order);
@@ -712,7 +756,8 @@ namespace cch_order{
 	ArrayIDIDFunc compute_nested_dissection_graph_order(
 		ArrayIDIDFunc tail, ArrayIDIDFunc head,
 		ArrayIDFunc<int> arc_weight, 
-		const ComputeSeparator&compute_separator
+		const ComputeSeparator&compute_separator,
+		const NestedDissectionCutoff&cutoff = NestedDissectionCutoff()
 	){
 		const int node_count = tail.image_count();
 
@@ -726,7 +771,7 @@ namespace cch_order{
 		){
 			return compute_nested_dissection_graph_order(
 				std::move(a_tail), std::move(a_head), std::move(a_input_node_id), std::move(a_arc_weight), 
-				compute_separator
+				compute_separator, cutoff
 			);
 		};
 
@@ -745,7 +790,8 @@ namespace cch_order{
 		ArrayIDIDFunc tail, ArrayIDIDFunc head,
 		ArrayIDIDFunc input_node_id,
 		ArrayIDFunc<int> arc_weight, 
-		const ComputeSeparator&compute_separator
+		const ComputeSeparator&compute_separator,
+		const NestedDissectionCutoff&cutoff = NestedDissectionCutoff()
 	){
 		make_graph_simple(tail, head, arc_weight);
 
@@ -755,7 +801,7 @@ namespace cch_order{
 		){
 			return compute_nested_dissection_graph_order(
 				std::move(a_tail), std::move(a_head), std::move(a_input_node_id), std::move(a_arc_weight), 
-				compute_separator
+				compute_separator, cutoff
 			);
 		};
 
@@ -804,9 +850,10 @@ namespace cch_order{
 	ArrayIDIDFunc compute_cch_graph_order(
 		ArrayIDIDFunc tail, ArrayIDIDFunc head,
 		ArrayIDFunc<int> arc_weight, 
-		const ComputeSeparator&compute_separator
+		const ComputeSeparator&compute_separator,
+		const NestedDissectionCutoff&cutoff = NestedDissectionCutoff()
 	){
-		return compute_cch_graph_order(std::move(tail), std::move(head), identity_permutation(tail.image_count()), std::move(arc_weight), compute_separator);
+		return compute_cch_graph_order(std::move(tail), std::move(head), identity_permutation(tail.image_count()), std::move(arc_weight), compute_separator, cutoff);
 	}
 
 	class ComputeConstantSeparator{
@@ -825,7 +872,8 @@ namespace cch_order{
 	ArrayIDIDFunc compute_cch_graph_order_given_top_level_separator(
 		ArrayIDIDFunc tail, ArrayIDIDFunc head, 
 		ArrayIDFunc<int> arc_weight, std::vector<int>top_level_separator,
-		const ComputeSeparator&compute_separator
+		const ComputeSeparator&compute_separator,
+		const NestedDissectionCutoff&cutoff = NestedDissectionCutoff()
 	){
 		const int node_count = tail.image_count();
 
@@ -840,7 +888,7 @@ namespace cch_order{
 				ArrayIDIDFunc a_tail, ArrayIDIDFunc a_head,
 				ArrayIDIDFunc a_input_node_id, ArrayIDFunc<int> a_arc_weight
 			){
-				return compute_cch_graph_order(std::move(a_tail), std::move(a_head), std::move(a_input_node_id), std::move(a_arc_weight), compute_separator);
+				return compute_cch_graph_order(std::move(a_tail), std::move(a_head), std::move(a_input_node_id), std::move(a_arc_weight), compute_separator, cutoff);
 			}
 
 		);
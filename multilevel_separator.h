@@ -0,0 +1,624 @@
+#ifndef MULTILEVEL_SEPARATOR_H
+#define MULTILEVEL_SEPARATOR_H
+
+#include "array_id_func.h"
+#include "tiny_id_func.h"
+#include "id_func.h"
+#include "id_multi_func.h"
+#include "count_range.h"
+#include "permutation.h"
+#include "back_arc.h"
+#include "heap.h"
+#include "dinic.h"
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <limits>
+#include <cassert>
+
+// A multilevel node separator that does not depend on an external library. The graph is coarsened
+// using heavy edge matchings, the coarsest graph is bisected by greedy graph growing and the
+// bisection is refined with FM on every level while uncoarsening. On the finest level, where all
+// arcs have unit capacity, the bisection is additionally improved using a max flow computation in a
+// corridor around the cut. The final edge cut is turned into a node separator by computing a
+// minimum vertex cover of the cut arcs.
+namespace multilevel{
+
+	struct Graph{
+		ArrayIDFunc<int>first_out;
+		ArrayIDIDFunc head;
+		ArrayIDFunc<int>arc_weight;
+		ArrayIDFunc<int>node_weight;
+		int total_node_weight;
+
+		int node_count()const{ return node_weight.preimage_count(); }
+		int arc_count()const{ return head.preimage_count(); }
+		CountRange out_arc(int x)const{ return count_range(first_out(x), first_out(x+1)); }
+	};
+
+	template<class Tail, class Head>
+	Graph make_unit_weight_graph(const Tail&tail, const Head&head){
+		const int node_count = head.image_count();
+		const int arc_count = head.preimage_count();
+
+		auto inv_tail = invert_id_id_func(tail);
+
+		Graph g;
+		g.first_out = ArrayIDFunc<int>(node_count+1);
+		g.head = ArrayIDIDFunc(arc_count, node_count);
+		g.arc_weight = ArrayIDFunc<int>(arc_count);
+		g.node_weight = ArrayIDFunc<int>(node_count);
+
+		int arc_pos = 0;
+		for(int x=0; x<node_count; ++x){
+			g.first_out[x] = arc_pos;
+			for(auto xy:inv_tail(x))
+				g.head[arc_pos++] = head(xy);
+		}
+		g.first_out[node_count] = arc_pos;
+		g.arc_weight.fill(1);
+		g.node_weight.fill(1);
+		g.total_node_weight = node_count;
+		return g; // NVRO
+	}
+
+	//! Matches every node with its unmatched neighbor that has the heaviest connecting arc. Nodes are
+	//! visited in random order. Returns a map from the nodes onto the coarse nodes.
+	inline ArrayIDIDFunc compute_heavy_edge_matching(const Graph&g, int max_coarse_node_weight, std::mt19937&rng){
+		const int node_count = g.node_count();
+
+		ArrayIDFunc<int>partner(node_count);
+		partner.fill(-1);
+
+		ArrayIDIDFunc order = identity_permutation(node_count);
+		std::shuffle(order.begin(), order.end(), rng);
+
+		for(auto x:order){
+			if(partner(x) != -1)
+				continue;
+			int best_neighbor = -1;
+			int best_weight = -1;
+			for(auto xy:g.out_arc(x)){
+				auto y = g.head(xy);
+				if(y != x && partner(y) == -1 && g.arc_weight(xy) > best_weight && g.node_weight(x) + g.node_weight(y) <= max_coarse_node_weight){
+					best_neighbor = y;
+					best_weight = g.arc_weight(xy);
+				}
+			}
+			if(best_neighbor == -1){
+				partner[x] = x;
+			}else{
+				partner[x] = best_neighbor;
+				partner[best_neighbor] = x;
+			}
+		}
+
+		int coarse_node_count = 0;
+		for(int x=0; x<node_count; ++x)
+			if(partner(x) >= x)
+				++coarse_node_count;
+
+		ArrayIDIDFunc coarse_node(node_count, coarse_node_count);
+		int next_id = 0;
+		for(int x=0; x<node_count; ++x){
+			if(partner(x) >= x){
+				coarse_node[x] = next_id;
+				coarse_node[partner(x)] = next_id;
+				++next_id;
+			}
+		}
+		return coarse_node; // NVRO
+	}
+
+	//! Merges the nodes that are mapped onto the same coarse node. Parallel arcs are merged and their
+	//! weights are summed. Arcs between nodes of the same coarse node vanish.
+	inline Graph contract_graph(const Graph&g, const ArrayIDIDFunc&coarse_node){
+		const int coarse_node_count = coarse_node.image_count();
+		auto member = invert_id_id_func(coarse_node);
+
+		Graph c;
+		c.first_out = ArrayIDFunc<int>(coarse_node_count+1);
+		c.node_weight = ArrayIDFunc<int>(coarse_node_count);
+		c.total_node_weight = g.total_node_weight;
+
+		std::vector<int>coarse_head, coarse_arc_weight;
+		ArrayIDFunc<int>arc_of_neighbor(coarse_node_count);
+		arc_of_neighbor.fill(-1);
+
+		for(int x=0; x<coarse_node_count; ++x){
+			c.first_out[x] = coarse_head.size();
+			c.node_weight[x] = 0;
+			for(auto u:member(x)){
+				c.node_weight[x] += g.node_weight(u);
+				for(auto uv:g.out_arc(u)){
+					auto y = coarse_node(g.head(uv));
+					if(y == x)
+						continue;
+					int a = arc_of_neighbor(y);
+					if(a < c.first_out(x)){
+						arc_of_neighbor[y] = coarse_head.size();
+						coarse_head.push_back(y);
+						coarse_arc_weight.push_back(g.arc_weight(uv));
+					}else{
+						coarse_arc_weight[a] += g.arc_weight(uv);
+					}
+				}
+			}
+		}
+		c.first_out[coarse_node_count] = coarse_head.size();
+
+		const int coarse_arc_count = coarse_head.size();
+		c.head = ArrayIDIDFunc(coarse_arc_count, coarse_node_count);
+		c.arc_weight = ArrayIDFunc<int>(coarse_arc_count);
+		for(int i=0; i<coarse_arc_count; ++i){
+			c.head[i] = coarse_head[i];
+			c.arc_weight[i] = coarse_arc_weight[i];
+		}
+		return c; // NVRO
+	}
+
+	inline int compute_cut_weight(const Graph&g, const BitIDFunc&side){
+		int cut = 0;
+		for(int x=0; x<g.node_count(); ++x)
+			for(auto xy:g.out_arc(x))
+				if(side(x) != side(g.head(xy)))
+					cut += g.arc_weight(xy);
+		return cut/2;
+	}
+
+	//! Bisections are compared first by how much the heavier side exceeds the allowed weight and
+	//! then by the cut weight.
+	struct BisectionQuality{
+		int overweight;
+		int cut;
+
+		bool operator<(const BisectionQuality&o)const{
+			return overweight < o.overweight || (overweight == o.overweight && cut < o.cut);
+		}
+	};
+
+	inline BisectionQuality measure_bisection(int side_weight0, int side_weight1, int cut, int max_side_weight){
+		return {std::max(0, std::max(side_weight0, side_weight1) - max_side_weight), cut};
+	}
+
+	//! Fiduccia-Mattheyses refinement of an edge bisection. Every pass moves unlocked nodes with
+	//! the largest gain and rolls back to the best bisection seen during the pass.
+	inline void refine_with_fm(const Graph&g, BitIDFunc&side, int max_side_weight, int max_pass_count){
+		const int node_count = g.node_count();
+
+		int side_weight[2] = {0, 0};
+		for(int x=0; x<node_count; ++x)
+			side_weight[side(x)] += g.node_weight(x);
+		int cut = compute_cut_weight(g, side);
+
+		ArrayIDFunc<int>gain(node_count);
+		BitIDFunc is_locked(node_count);
+		kway_max_id_heap<int, 4> queue[2] = {kway_max_id_heap<int, 4>(node_count), kway_max_id_heap<int, 4>(node_count)};
+		std::vector<int>moved;
+
+		const int max_moves_without_improvement = std::max(50, node_count/100);
+
+		for(int pass=0; pass<max_pass_count; ++pass){
+			queue[0].clear();
+			queue[1].clear();
+			is_locked.fill(false);
+			moved.clear();
+
+			for(int x=0; x<node_count; ++x){
+				int external = 0, internal = 0;
+				for(auto xy:g.out_arc(x)){
+					if(side(g.head(xy)) != side(x))
+						external += g.arc_weight(xy);
+					else
+						internal += g.arc_weight(xy);
+				}
+				gain[x] = external - internal;
+				if(external != 0)
+					queue[side(x)].push(x, gain(x));
+			}
+
+			BisectionQuality best_quality = measure_bisection(side_weight[0], side_weight[1], cut, max_side_weight);
+			int best_move_count = 0;
+			int moves_without_improvement = 0;
+
+			while(moves_without_improvement < max_moves_without_improvement){
+				BisectionQuality current_quality = measure_bisection(side_weight[0], side_weight[1], cut, max_side_weight);
+
+				int from = -1;
+				for(int s=0; s<2; ++s){
+					if(queue[s].empty())
+						continue;
+					int x = queue[s].peek_max_id();
+					BisectionQuality q = measure_bisection(
+						side_weight[0] + (s == 0 ? -1 : 1)*g.node_weight(x),
+						side_weight[1] + (s == 1 ? -1 : 1)*g.node_weight(x),
+						cut - gain(x), max_side_weight
+					);
+					if(q.overweight > current_quality.overweight)
+						continue;
+					if(from == -1 || gain(x) > gain(queue[from].peek_max_id()))
+						from = s;
+				}
+				if(from == -1)
+					break;
+
+				int x = queue[from].pop();
+				int to = 1-from;
+				side.set(x, to);
+				side_weight[from] -= g.node_weight(x);
+				side_weight[to] += g.node_weight(x);
+				cut -= gain(x);
+				is_locked.set(x, true);
+				moved.push_back(x);
+
+				for(auto xy:g.out_arc(x)){
+					auto y = g.head(xy);
+					if(is_locked(y))
+						continue;
+					if((int)side(y) == to)
+						gain[y] -= 2*g.arc_weight(xy);
+					else
+						gain[y] += 2*g.arc_weight(xy);
+					queue[side(y)].push_or_set_key(y, gain(y));
+				}
+
+				BisectionQuality q = measure_bisection(side_weight[0], side_weight[1], cut, max_side_weight);
+				if(q < best_quality){
+					best_quality = q;
+					best_move_count = moved.size();
+					moves_without_improvement = 0;
+				}else{
+					++moves_without_improvement;
+				}
+			}
+
+			for(int i=moved.size()-1; i>=best_move_count; --i){
+				int x = moved[i];
+				int s = side(x);
+				side.set(x, !s);
+				side_weight[s] -= g.node_weight(x);
+				side_weight[!s] += g.node_weight(x);
+			}
+			cut = best_quality.cut;
+
+			if(best_move_count == 0)
+				break;
+		}
+	}
+
+	//! Grows side 0 from a random start node by always adding the boundary node with the largest
+	//! gain until it holds half of the weight.
+	inline BitIDFunc compute_greedy_growing_bisection(const Graph&g, int max_side_weight, std::mt19937&rng){
+		const int node_count = g.node_count();
+
+		BitIDFunc side(node_count);
+		side.fill(true);
+
+		ArrayIDFunc<int>gain(node_count);
+		for(int x=0; x<node_count; ++x){
+			gain[x] = 0;
+			for(auto xy:g.out_arc(x))
+				gain[x] -= g.arc_weight(xy);
+		}
+
+		kway_max_id_heap<int, 4> queue(node_count);
+		int start = std::uniform_int_distribution<int>(0, node_count-1)(rng);
+		queue.push(start, gain(start));
+
+		int grown_weight = 0;
+		while(2*grown_weight < g.total_node_weight && !queue.empty()){
+			int x = queue.pop();
+			if(grown_weight + g.node_weight(x) > max_side_weight)
+				continue;
+			side.set(x, false);
+			grown_weight += g.node_weight(x);
+			for(auto xy:g.out_arc(x)){
+				auto y = g.head(xy);
+				if(side(y)){
+					gain[y] += 2*g.arc_weight(xy);
+					queue.push_or_set_key(y, gain(y));
+				}
+			}
+		}
+		return side; // NVRO
+	}
+
+	//! Improves a bisection of a graph with unit node and arc weights. Around the cut a corridor is
+	//! selected that is small enough that every cut within it is balanced. All nodes outside of the
+	//! corridor are sources or targets depending on their side. The minimum cut between them
+	//! replaces the bisection if it is smaller.
+	inline void refine_with_flow(const Graph&g, BitIDFunc&side, int max_side_weight){
+		const int node_count = g.node_count();
+		const int arc_count = g.arc_count();
+
+		int side_weight[2] = {0, 0};
+		for(int x=0; x<node_count; ++x)
+			side_weight[side(x)] += g.node_weight(x);
+
+		BitIDFunc in_corridor(node_count);
+		in_corridor.fill(false);
+		ArrayIDFunc<int>queue(node_count);
+		for(int s=0; s<2; ++s){
+			int budget = max_side_weight - side_weight[1-s];
+			int queue_begin = 0, queue_end = 0;
+			for(int x=0; x<node_count; ++x){
+				if((int)side(x) != s)
+					continue;
+				bool is_boundary = false;
+				for(auto xy:g.out_arc(x))
+					if((int)side(g.head(xy)) != s)
+						is_boundary = true;
+				if(is_boundary && g.node_weight(x) <= budget){
+					budget -= g.node_weight(x);
+					in_corridor.set(x, true);
+					queue[queue_end++] = x;
+				}
+			}
+			while(queue_begin != queue_end){
+				auto x = queue[queue_begin++];
+				for(auto xy:g.out_arc(x)){
+					auto y = g.head(xy);
+					if((int)side(y) == s && !in_corridor(y) && g.node_weight(y) <= budget){
+						budget -= g.node_weight(y);
+						in_corridor.set(y, true);
+						queue[queue_end++] = y;
+					}
+				}
+			}
+		}
+
+		std::vector<int>source_list, target_list;
+		for(int x=0; x<node_count; ++x){
+			if(!in_corridor(x)){
+				if(side(x))
+					target_list.push_back(x);
+				else
+					source_list.push_back(x);
+			}
+		}
+		if(source_list.empty() || target_list.empty())
+			return;
+
+		ArrayIDIDFunc tail(arc_count, node_count);
+		for(int x=0; x<node_count; ++x)
+			for(auto xy:g.out_arc(x))
+				tail[xy] = x;
+		RangeIDIDMultiFunc inv_tail = {g.first_out};
+		auto back_arc = compute_back_arc_permutation(tail, g.head);
+
+		auto sources = id_id_func(source_list.size(), node_count, [&](int i){return source_list[i];});
+		auto targets = id_id_func(target_list.size(), node_count, [&](int i){return target_list[i];});
+		auto is_saturated = max_flow::compute_maximum_unit_flow_using_dinic(inv_tail, g.head, back_arc, sources, targets);
+
+		BitIDFunc is_reachable(node_count);
+		is_reachable.fill(false);
+		int stack_end = 0;
+		for(auto x:source_list){
+			is_reachable.set(x, true);
+			queue[stack_end++] = x;
+		}
+		while(stack_end != 0){
+			auto x = queue[--stack_end];
+			for(auto xy:g.out_arc(x)){
+				auto y = g.head(xy);
+				if(!is_saturated(xy) && !is_reachable(y)){
+					is_reachable.set(y, true);
+					queue[stack_end++] = y;
+				}
+			}
+		}
+
+		BitIDFunc new_side = ~std::move(is_reachable);
+		if(compute_cut_weight(g, new_side) < compute_cut_weight(g, side))
+			side = std::move(new_side);
+	}
+
+	//! Computes a minimum vertex cover of the arcs between the two sides using König's theorem on a
+	//! maximum matching of the bipartite boundary graph. Removing the cover separates the sides.
+	inline std::vector<int> compute_vertex_cover_of_cut(const Graph&g, const BitIDFunc&side){
+		const int node_count = g.node_count();
+
+		ArrayIDFunc<int>mate(node_count);
+		mate.fill(-1);
+
+		std::vector<int>left;
+		for(int x=0; x<node_count; ++x){
+			if(side(x))
+				continue;
+			bool is_boundary = false;
+			for(auto xy:g.out_arc(x)){
+				auto y = g.head(xy);
+				if(side(y)){
+					is_boundary = true;
+					if(mate(x) == -1 && mate(y) == -1){
+						mate[x] = y;
+						mate[y] = x;
+					}
+				}
+			}
+			if(is_boundary)
+				left.push_back(x);
+		}
+
+		// Augmenting paths are searched with an iterative depth first search. The stack alternates
+		// between left nodes and the right nodes through which they were reached.
+		ArrayIDFunc<int>visited(node_count);
+		visited.fill(0);
+		ArrayIDFunc<int>next_arc(node_count);
+		std::vector<int>left_stack, right_stack;
+		int stamp = 0;
+		for(auto root:left){
+			if(mate(root) != -1)
+				continue;
+			++stamp;
+			left_stack = {root};
+			right_stack.clear();
+			next_arc[root] = g.first_out(root);
+			while(!left_stack.empty()){
+				auto x = left_stack.back();
+				if(next_arc(x) == g.first_out(x+1)){
+					left_stack.pop_back();
+					if(!right_stack.empty())
+						right_stack.pop_back();
+					continue;
+				}
+				auto y = g.head(next_arc(x));
+				++next_arc[x];
+				if(!side(y) || visited(y) == stamp)
+					continue;
+				visited[y] = stamp;
+				if(mate(y) == -1){
+					right_stack.push_back(y);
+					for(int i=0; i<(int)left_stack.size(); ++i){
+						mate[left_stack[i]] = right_stack[i];
+						mate[right_stack[i]] = left_stack[i];
+					}
+					break;
+				}else{
+					right_stack.push_back(y);
+					auto z = mate(y);
+					next_arc[z] = g.first_out(z);
+					left_stack.push_back(z);
+				}
+			}
+		}
+
+		// König: Z are the nodes reachable from unmatched left nodes over alternating paths. The
+		// cover consists of the left nodes not in Z and the right nodes in Z.
+		++stamp;
+		std::vector<int>stack;
+		for(auto x:left){
+			if(mate(x) == -1){
+				visited[x] = stamp;
+				stack.push_back(x);
+			}
+		}
+		while(!stack.empty()){
+			auto x = stack.back();
+			stack.pop_back();
+			for(auto xy:g.out_arc(x)){
+				auto y = g.head(xy);
+				if(side(y) && visited(y) != stamp){
+					visited[y] = stamp;
+					auto z = mate(y);
+					if(z != -1 && visited(z) != stamp){
+						visited[z] = stamp;
+						stack.push_back(z);
+					}
+				}
+			}
+		}
+
+		std::vector<int>cover;
+		for(auto x:left){
+			if(visited(x) != stamp)
+				cover.push_back(x);
+			for(auto xy:g.out_arc(x)){
+				auto y = g.head(xy);
+				if(side(y) && visited(y) == stamp && mate(y) != -2){
+					cover.push_back(y);
+					mate[y] = -2;
+				}
+			}
+		}
+		return cover; // NVRO
+	}
+
+	struct Config{
+		double epsilon;
+		int random_seed;
+		int coarsest_node_count;
+		int initial_partition_count;
+		int fm_pass_count;
+
+		Config():
+			epsilon(0.03),
+			random_seed(5489),
+			coarsest_node_count(200),
+			initial_partition_count(8),
+			fm_pass_count(8){}
+	};
+
+	//! The separator is only empty if the graph is empty.
+	inline std::vector<int> compute_separator(Graph g, const Config&config){
+		const int node_count = g.node_count();
+		if(node_count == 0)
+			return {};
+		if(node_count == 1)
+			return {0};
+
+		std::mt19937 rng(config.random_seed);
+		// A side may never hold the whole weight. Otherwise, FM can move all nodes to one side.
+		const int max_side_weight = std::min(g.total_node_weight-1, static_cast<int>((1.0+config.epsilon)*((g.total_node_weight+1)/2)));
+		const int max_coarse_node_weight = std::max(1, (3*g.total_node_weight)/(2*config.coarsest_node_count));
+
+		std::vector<Graph>level;
+		std::vector<ArrayIDIDFunc>coarse_node;
+		level.push_back(std::move(g));
+		while(level.back().node_count() > config.coarsest_node_count){
+			auto m = compute_heavy_edge_matching(level.back(), max_coarse_node_weight, rng);
+			if(m.image_count() > 0.95*level.back().node_count())
+				break;
+			auto c = contract_graph(level.back(), m);
+			coarse_node.push_back(std::move(m));
+			level.push_back(std::move(c));
+		}
+
+		BitIDFunc side;
+		BisectionQuality best_quality = {std::numeric_limits<int>::max(), std::numeric_limits<int>::max()};
+		for(int i=0; i<config.initial_partition_count; ++i){
+			auto s = compute_greedy_growing_bisection(level.back(), max_side_weight, rng);
+			refine_with_fm(level.back(), s, max_side_weight, config.fm_pass_count);
+
+			int side_weight[2] = {0, 0};
+			for(int x=0; x<level.back().node_count(); ++x)
+				side_weight[s(x)] += level.back().node_weight(x);
+			auto q = measure_bisection(side_weight[0], side_weight[1], compute_cut_weight(level.back(), s), max_side_weight);
+			if(q < best_quality){
+				best_quality = q;
+				side = std::move(s);
+			}
+		}
+
+		for(int l=level.size()-2; l>=0; --l){
+			BitIDFunc fine_side(level[l].node_count());
+			for(int x=0; x<level[l].node_count(); ++x)
+				fine_side.set(x, side(coarse_node[l](x)));
+			side = std::move(fine_side);
+			refine_with_fm(level[l], side, max_side_weight, config.fm_pass_count);
+		}
+
+		refine_with_flow(level[0], side, max_side_weight);
+		refine_with_fm(level[0], side, max_side_weight, config.fm_pass_count);
+
+		// The cut can still be empty if no bisection fulfills the balance. A single node keeps the
+		// nested dissection making progress.
+		auto sep = compute_vertex_cover_of_cut(level[0], side);
+		if(sep.empty())
+			sep = {0};
+		return sep; // NVRO
+	}
+
+	struct MultilevelSeparator{
+		explicit MultilevelSeparator(Config config):
+			config(config){}
+
+		template<class Tail, class Head, class InputNodeID, class ArcWeight>
+		std::vector<int>operator()(const Tail&tail, const Head&head, const InputNodeID&, const ArcWeight&)const{
+			return compute_separator(make_unit_weight_graph(tail, head), config);
+		}
+
+		Config config;
+	};
+
+	inline
+	MultilevelSeparator ComputeSeparator(double epsilon, int random_seed){
+		Config config;
+		config.epsilon = epsilon;
+		config.random_seed = random_seed;
+		return MultilevelSeparator(config);
+	}
+}
+
+#endif
+
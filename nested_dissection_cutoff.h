@@ -0,0 +1,33 @@
+#ifndef NESTED_DISSECTION_CUTOFF_H
+#define NESTED_DISSECTION_CUTOFF_H
+
+namespace cch_order{
+	// Deep in the recursion of a nested dissection the graphs are small and computing separators
+	// costs more than it gains over a greedy order. A nested dissection stops recursing on a
+	// component with at most max_node_count nodes or for which the greedy min degree order has a
+	// width of at most max_tree_width and orders it using the bottom level orderer instead. A zero
+	// disables the respective criterion. By default, the recursion continues down to trivial graphs.
+	//
+	// The min degree order is only tried on components with at most max_tree_width_node_count
+	// nodes. Otherwise, it would run on every level of the recursion on large components.
+	struct NestedDissectionCutoff{
+		enum class BottomLevelOrderer{
+			min_degree,
+			min_shortcut
+		};
+
+		NestedDissectionCutoff():
+			max_node_count(0), max_tree_width(0), max_tree_width_node_count(4096), bottom_level_orderer(BottomLevelOrderer::min_degree){}
+
+		bool is_enabled()const{
+			return max_node_count != 0 || max_tree_width != 0;
+		}
+
+		int max_node_count;
+		int max_tree_width;
+		int max_tree_width_node_count;
+		BottomLevelOrderer bottom_level_orderer;
+	};
+}
+
+#endif
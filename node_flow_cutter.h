@@ -2,6 +2,7 @@
 #define NODE_FLOW_CUTTER_H
 
 #include "flow_cutter.h"
+#include "range.h"
 
 namespace flow_cutter{
 
@@ -12,6 +13,7 @@ namespace flow_cutter{
 	//! For each arc x->y two new inter arcs x_out -> y_in and y_in -> x_out are created
 	//! For each node x two new intra arcs x_out -> x_in and x_in -> x_out are created
 	//! Every in to out arc has capacity 1 and every out to in arc has capacity 0. 
+	//! Both v_in and v_out have the weight of v.
 	//!
 
 	namespace expanded_graph{
@@ -112,6 +114,17 @@ namespace flow_cutter{
 			return {original_node_count, original_arc_count};
 		}
 
+		template<class OriginalNodeWeight>
+		struct NodeWeight{
+			OriginalNodeWeight original_node_weight;
+
+			int preimage_count()const{return expanded_node_count(original_node_weight.preimage_count());}
+
+			int operator()(int x)const{
+				return original_node_weight(expanded_node_to_original_node(x));
+			}
+		};
+
 		template<class OriginalArcWeight>
 		struct ArcWeight{
 			int original_node_count, original_arc_count;
@@ -215,11 +228,36 @@ namespace flow_cutter{
 		}
 
 
+		template<class Tail, class Head, class BackArc, class NodeWeight, class ArcWeight, class OutArc>
+		Graph<
+			expanded_graph::Tail<Tail>, 
+			expanded_graph::Head<Head>, 
+			expanded_graph::BackArc<BackArc>, 
+			expanded_graph::NodeWeight<NodeWeight>, 
+			expanded_graph::ArcWeight<ArcWeight>, 
+			expanded_graph::Capacity, 
+			expanded_graph::OutArc<OutArc>
+		>
+		make_graph(Tail tail, Head head, BackArc back_arc, NodeWeight node_weight, ArcWeight arc_weight, OutArc out_arc){
+			int node_count = tail.image_count(), arc_count = tail.preimage_count();
+			return{
+				expanded_graph::tail(node_count, arc_count, std::move(tail)),
+				expanded_graph::head(node_count, arc_count, std::move(head)),
+				expanded_graph::back_arc(node_count, arc_count, std::move(back_arc)),
+				expanded_graph::NodeWeight<NodeWeight>{std::move(node_weight)},
+				expanded_graph::arc_weight(node_count, arc_count, std::move(arc_weight)),
+				expanded_graph::capacity(node_count, arc_count),
+				expanded_graph::out_arc(node_count, arc_count, std::move(out_arc))
+			};
+		}
+
+		//! Every expanded node has weight 1.
 		template<class Tail, class Head, class BackArc, class ArcWeight, class OutArc>
 		Graph<
 			expanded_graph::Tail<Tail>, 
 			expanded_graph::Head<Head>, 
 			expanded_graph::BackArc<BackArc>, 
+			ConstIntIDFunc<1>, 
 			expanded_graph::ArcWeight<ArcWeight>, 
 			expanded_graph::Capacity, 
 			expanded_graph::OutArc<OutArc>
@@ -230,6 +268,7 @@ namespace flow_cutter{
 				expanded_graph::tail(node_count, arc_count, std::move(tail)),
 				expanded_graph::head(node_count, arc_count, std::move(head)),
 				expanded_graph::back_arc(node_count, arc_count, std::move(back_arc)),
+				ConstIntIDFunc<1>(expanded_node_count(node_count)),
 				expanded_graph::arc_weight(node_count, arc_count, std::move(arc_weight)),
 				expanded_graph::capacity(node_count, arc_count),
 				expanded_graph::out_arc(node_count, arc_count, std::move(out_arc))
@@ -260,21 +299,26 @@ namespace flow_cutter{
 			int small_side_size;
 		};
 
-		template<class Tail, class Head, class FlowCutter>
-		Separator extract_original_separator(const Tail&tail, const Head&head, const FlowCutter&cutter){
-			int original_node_count = tail.image_count();
+		//! The side sizes are measured in node weight and the cutter must run on an expanded graph
+		//! with the same node weights.
+		template<class Tail, class Head, class NodeWeight, class FlowCutter>
+		Separator extract_original_separator(const Tail&tail, const Head&head, const NodeWeight&node_weight, const FlowCutter&cutter){
 			int original_arc_count = tail.preimage_count();
 
 			Separator sep;
 
+			int sep_weight = 0;
 			for(auto x:cutter.get_current_cut()){
 				if(is_expanded_intra_arc(x, original_arc_count)){
-					sep.sep.push_back(expanded_intra_arc_to_original_node(x, original_arc_count));
+					int v = expanded_intra_arc_to_original_node(x, original_arc_count);
+					sep.sep.push_back(v);
+					sep_weight += node_weight(v);
 				}
 			}
 
-			int left_side_size = (cutter.get_current_smaller_cut_side_size()-sep.sep.size())/2;
-			int right_side_size = original_node_count - sep.sep.size() - left_side_size;
+			// Of every separator node exactly one expanded node is on the smaller side.
+			int left_side_size = (cutter.get_current_smaller_cut_side_size()-sep_weight)/2;
+			int right_side_size = compute_total_node_weight(node_weight) - sep_weight - left_side_size;
 
 			auto is_original_node_left = [&](int x){
 				return cutter.is_on_smaller_side(original_node_to_expanded_node(x, true));
@@ -289,10 +333,10 @@ namespace flow_cutter{
 
 					if(left_side_size > right_side_size){
 						sep.sep.push_back(l);
-						--left_side_size;
+						left_side_size -= node_weight(l);
 					}else{
 						sep.sep.push_back(r);
-						--right_side_size;
+						right_side_size -= node_weight(r);
 					}
 				}
 			}
@@ -305,6 +349,11 @@ namespace flow_cutter{
 			return sep; // NVRO
 		}
 
+		template<class Tail, class Head, class FlowCutter>
+		Separator extract_original_separator(const Tail&tail, const Head&head, const FlowCutter&cutter){
+			return extract_original_separator(tail, head, ConstIntIDFunc<1>(tail.image_count()), cutter);
+		}
+
 		inline
 		std::vector<SourceTargetPair>expand_source_target_pair_list(std::vector<SourceTargetPair>p){
 			for(auto&x:p){
@@ -313,6 +362,26 @@ namespace flow_cutter{
 			}
 			return std::move(p);
 		}
+
+		//! Both expanded nodes of a terminal are terminals and thus terminals are never separator
+		//! nodes.
+		inline
+		std::vector<SourceTargetSets>expand_source_target_set_list(std::vector<SourceTargetSets>p){
+			auto expand = [](std::vector<int>&node_list){
+				std::vector<int>expanded_node_list;
+				expanded_node_list.reserve(2*node_list.size());
+				for(auto x:node_list){
+					expanded_node_list.push_back(original_node_to_expanded_node(x, false));
+					expanded_node_list.push_back(original_node_to_expanded_node(x, true));
+				}
+				node_list.swap(expanded_node_list);
+			};
+			for(auto&x:p){
+				expand(x.source_list);
+				expand(x.target_list);
+			}
+			return std::move(p);
+		}
 	}
 
 	
@@ -0,0 +1,171 @@
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include "flow_cutter.h"
+#include "flow_cutter_config.h"
+#include "timer.h"
+#include <vector>
+#include <string>
+#include <sstream>
+#include <atomic>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <omp.h>
+
+// Runs several flow cutter configurations concurrently on the same graph and merges the cuts into
+// one Pareto front of (cut size, balance). All runs share the read-only graph including its
+// out_arc and back_arc functions.
+namespace portfolio{
+
+	struct ParetoCut{
+		int cut_size;
+		int smaller_side_size;
+		int config_id;
+		std::vector<int>cut;
+	};
+
+	struct RunStatistic{
+		int cut_count;
+		long long running_time;
+		bool was_stopped_early;
+	};
+
+	//! Parses one config per line. Every line is a whitespace separated list of variable value pairs
+	//! that are applied to the base config. Empty lines and lines starting with # are skipped.
+	inline std::vector<flow_cutter::Config> parse_config_list(const std::string&text, const flow_cutter::Config&base){
+		std::vector<flow_cutter::Config>configs;
+		std::istringstream in(text);
+		std::string line;
+		while(std::getline(in, line)){
+			std::istringstream line_in(line);
+			std::string var, val;
+			if(!(line_in >> var) || var[0] == '#')
+				continue;
+			flow_cutter::Config config = base;
+			do{
+				if(!(line_in >> val))
+					throw std::runtime_error("config variable "+var+" has no value");
+				config.set(var, val);
+			}while(line_in >> var);
+			configs.push_back(config);
+		}
+		return configs; // NVRO
+	}
+
+	//! Varies the pierce rating and the augmenting path avoidance of the base config. Every config
+	//! gets its own seed.
+	inline std::vector<flow_cutter::Config> make_default_config_list(const flow_cutter::Config&base){
+		typedef flow_cutter::Config Config;
+		const Config::PierceRating pierce_rating[] = {
+			Config::PierceRating::max_target_minus_source_hop_dist,
+			Config::PierceRating::max_target_hop_dist,
+			Config::PierceRating::min_source_hop_dist,
+			Config::PierceRating::circular_hop
+		};
+		const Config::AvoidAugmentingPath avoid_augmenting_path[] = {
+			Config::AvoidAugmentingPath::avoid_and_pick_best,
+			Config::AvoidAugmentingPath::do_not_avoid
+		};
+
+		std::vector<Config>configs;
+		for(auto a:avoid_augmenting_path){
+			for(auto p:pierce_rating){
+				Config config = base;
+				config.pierce_rating = p;
+				config.avoid_augmenting_path = a;
+				config.random_seed = base.random_seed + configs.size();
+				configs.push_back(config);
+			}
+		}
+		return configs; // NVRO
+	}
+
+	//! Merges cuts into a Pareto front sorted by increasing cut size and strictly increasing balance.
+	//! Among equal cuts the one of the lowest config id is kept.
+	inline std::vector<ParetoCut> compute_pareto_front(std::vector<ParetoCut>cuts){
+		std::sort(
+			cuts.begin(), cuts.end(),
+			[](const ParetoCut&l, const ParetoCut&r){
+				if(l.cut_size != r.cut_size)
+					return l.cut_size < r.cut_size;
+				if(l.smaller_side_size != r.smaller_side_size)
+					return l.smaller_side_size > r.smaller_side_size;
+				return l.config_id < r.config_id;
+			}
+		);
+		std::vector<ParetoCut>front;
+		for(auto&c:cuts)
+			if(front.empty() || c.smaller_side_size > front.back().smaller_side_size)
+				front.push_back(std::move(c));
+		return front; // NVRO
+	}
+
+	//! Runs every config in its own thread. The cuts of a run only grow, so once any run has found a
+	//! perfectly balanced cut, every run whose current cut is at least as large can only find
+	//! dominated cuts and is stopped.
+	template<class Graph>
+	std::vector<ParetoCut> run(
+		const Graph&graph, const std::vector<flow_cutter::Config>&configs,
+		int max_cut_size, int thread_count,
+		std::vector<RunStatistic>*statistic = nullptr
+	){
+		const int node_count = graph.node_count();
+		const int config_count = configs.size();
+		const int perfect_smaller_side_size = node_count/2;
+
+		std::atomic<int>perfectly_balanced_cut_size(std::numeric_limits<int>::max());
+
+		std::vector<std::vector<ParetoCut>>cuts_of_run(config_count);
+		std::vector<RunStatistic>run_statistic(config_count);
+
+		#pragma omp parallel for schedule(dynamic) num_threads(thread_count)
+		for(int i=0; i<config_count; ++i){
+			long long start_time = get_micro_time();
+			auto config = configs[i];
+			config.thread_count = 1;
+
+			auto cutter = flow_cutter::make_simple_cutter(graph, config);
+			cutter.init(flow_cutter::select_random_source_target_pairs(node_count, config.cutter_count, config.random_seed), config.random_seed);
+
+			RunStatistic&stat = run_statistic[i];
+			stat.cut_count = 0;
+			stat.was_stopped_early = false;
+			for(;;){
+				int cut_size = cutter.get_current_cut().size();
+				if(cut_size >= max_cut_size)
+					break;
+				if(cut_size >= perfectly_balanced_cut_size.load()){
+					stat.was_stopped_early = true;
+					break;
+				}
+
+				int smaller_side_size = cutter.get_current_smaller_cut_side_size();
+				cuts_of_run[i].push_back({cut_size, smaller_side_size, i, cutter.get_current_cut()});
+				++stat.cut_count;
+
+				if(smaller_side_size == perfect_smaller_side_size){
+					int expected = perfectly_balanced_cut_size.load();
+					while(cut_size < expected && !perfectly_balanced_cut_size.compare_exchange_weak(expected, cut_size)){}
+					break;
+				}
+
+				if(!cutter.advance())
+					break;
+			}
+			stat.running_time = get_micro_time() - start_time;
+		}
+
+		if(statistic != nullptr)
+			*statistic = std::move(run_statistic);
+
+		std::vector<ParetoCut>all_cuts;
+		for(auto&c:cuts_of_run)
+			for(auto&x:c)
+				all_cuts.push_back(std::move(x));
+		return compute_pareto_front(std::move(all_cuts));
+	}
+}
+
+#endif
+
@@ -0,0 +1,585 @@
+#ifndef PUSH_RELABEL_H
+#define PUSH_RELABEL_H
+
+#include "tiny_id_func.h"
+#include "array_id_func.h"
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <omp.h>
+
+namespace max_flow{
+
+	// The flow is stored as in UnitDinicAlgo: An arc is saturated if it carries one unit of flow.
+	// At most one of an arc and its back arc is saturated. The flags are stored as bytes instead of
+	// bits so that the parallel algorithm can modify neighboring arcs from different threads.
+	namespace push_relabel_detail{
+		template<class BackArc>
+		int residual_capacity(const ArrayIDFunc<unsigned char>&is_saturated, const BackArc&back_arc, int a){
+			return !is_saturated(a) + is_saturated(back_arc(a));
+		}
+
+		template<class BackArc>
+		void push_unit(ArrayIDFunc<unsigned char>&is_saturated, const BackArc&back_arc, int a){
+			int b = back_arc(a);
+			if(is_saturated(b))
+				is_saturated[b] = false;
+			else
+				is_saturated[a] = true;
+		}
+
+		//! Sets the label of every node to its hop distance to the closest target in the residual
+		//! network. Nodes that cannot reach a target and sources get the label node_count.
+		template<class InvTail, class Head, class BackArc, class TargetList>
+		void compute_exact_labels(
+			const InvTail&inv_tail, const Head&head, const BackArc&back_arc,
+			const BitIDFunc&is_source, const TargetList&target_list,
+			const ArrayIDFunc<unsigned char>&is_saturated,
+			ArrayIDFunc<int>&label, ArrayIDFunc<int>&queue
+		){
+			const int node_count = head.image_count();
+			label.fill(node_count);
+
+			int queue_begin = 0, queue_end = 0;
+			for(int i=0; i<target_list.preimage_count(); ++i){
+				label[target_list(i)] = 0;
+				queue[queue_end++] = target_list(i);
+			}
+
+			while(queue_begin != queue_end){
+				auto y = queue[queue_begin++];
+				for(auto yx:inv_tail(y)){
+					auto x = head(yx);
+					if(label(x) == node_count && !is_source(x) && residual_capacity(is_saturated, back_arc, back_arc(yx)) > 0){
+						label[x] = label(y)+1;
+						queue[queue_end++] = x;
+					}
+				}
+			}
+		}
+
+		//! Turns a maximum preflow into a maximum flow by sending the excess of every node back to
+		//! the sources. Every step cancels one unit of flow on an arc that enters a node with excess.
+		//! As every step removes flow, this terminates after at most arc_count steps.
+		template<class InvTail, class Head, class BackArc>
+		void return_excess_to_sources(
+			const InvTail&inv_tail, const Head&head, const BackArc&back_arc,
+			const BitIDFunc&is_source, const BitIDFunc&is_target,
+			ArrayIDFunc<unsigned char>&is_saturated, ArrayIDFunc<int>&excess,
+			ArrayIDFunc<int>&current_arc, ArrayIDFunc<int>&stack
+		){
+			const int node_count = head.image_count();
+			current_arc.fill(0);
+
+			int stack_end = 0;
+			for(int x=0; x<node_count; ++x)
+				if(excess(x) > 0 && !is_source(x) && !is_target(x))
+					stack[stack_end++] = x;
+
+			while(stack_end != 0){
+				auto x = stack[stack_end-1];
+				if(excess(x) == 0){
+					--stack_end;
+					continue;
+				}
+				auto arc_begin = std::begin(inv_tail(x));
+				int i = current_arc(x);
+				while(!is_saturated(back_arc(arc_begin[i]))){
+					++i;
+					assert(arc_begin + i != std::end(inv_tail(x)));
+				}
+				current_arc[x] = i;
+
+				auto xy = arc_begin[i];
+				is_saturated[back_arc(xy)] = false;
+				--excess[x];
+
+				auto y = head(xy);
+				if(!is_source(y)){
+					if(excess(y) == 0)
+						stack[stack_end++] = y;
+					++excess[y];
+				}
+			}
+		}
+
+		inline BitIDFunc to_bit_id_func(const ArrayIDFunc<unsigned char>&f){
+			BitIDFunc r(f.preimage_count());
+			for(int i=0; i<f.preimage_count(); ++i)
+				r.set(i, f(i));
+			return r; // NVRO
+		}
+	}
+
+	//! Highest label push relabel with global relabeling and the gap heuristic. The interface
+	//! follows UnitDinicAlgo. Every call to advance discharges nodes until the next global
+	//! relabeling is due. The current flow intensity is the flow that already reached the targets
+	//! and thus a lower bound on the maximum flow.
+	template<class InvTail, class Head, class BackArc, class SourceList, class TargetList>
+	class UnitPushRelabelAlgo{
+	public:
+		UnitPushRelabelAlgo(
+			const InvTail&inv_tail, const Head&head, const BackArc&back_arc,
+			const SourceList&source_list, const TargetList&target_list
+		):
+			node_count(head.image_count()), arc_count(head.preimage_count()),
+			inv_tail(inv_tail), head(head), back_arc(back_arc), source_list(source_list), target_list(target_list),
+			is_source(node_count), is_target(node_count), is_saturated(arc_count),
+			excess(node_count), label(node_count), current_arc(node_count),
+			all_first(node_count+1), all_next(node_count), all_prev(node_count),
+			active_first(node_count+1), active_next(node_count),
+			queue(node_count){
+
+			is_source.fill(false);
+			for(int i=0; i<source_list.preimage_count(); ++i)
+				is_source.set(source_list(i), true);
+
+			is_target.fill(false);
+			for(int i=0; i<target_list.preimage_count(); ++i)
+				is_target.set(target_list(i), true);
+
+			is_saturated.fill(false);
+			excess.fill(0);
+			flow_intensity = 0;
+
+			for(int i=0; i<source_list.preimage_count(); ++i){
+				for(auto xy:inv_tail(source_list(i))){
+					auto y = head(xy);
+					if(!is_source(y)){
+						is_saturated[xy] = true;
+						if(is_target(y))
+							++flow_intensity;
+						else
+							++excess[y];
+					}
+				}
+			}
+
+			global_relabel();
+			is_finished_flag = false;
+		}
+
+	private:
+		void insert_into_label_list(int x, int d){
+			all_prev[x] = -1;
+			all_next[x] = all_first(d);
+			if(all_first(d) != -1)
+				all_prev[all_first(d)] = x;
+			all_first[d] = x;
+			max_label = std::max(max_label, d);
+		}
+
+		void remove_from_label_list(int x, int d){
+			if(all_prev(x) != -1)
+				all_next[all_prev(x)] = all_next(x);
+			else
+				all_first[d] = all_next(x);
+			if(all_next(x) != -1)
+				all_prev[all_next(x)] = all_prev(x);
+		}
+
+		void push_active(int x, int d){
+			active_next[x] = active_first(d);
+			active_first[d] = x;
+			max_active_label = std::max(max_active_label, d);
+		}
+
+		void global_relabel(){
+			push_relabel_detail::compute_exact_labels(inv_tail, head, back_arc, is_source, target_list, is_saturated, label, queue);
+
+			all_first.fill(-1);
+			active_first.fill(-1);
+			max_label = 0;
+			max_active_label = 0;
+			for(int x=0; x<node_count; ++x){
+				if(!is_source(x) && !is_target(x) && label(x) < node_count){
+					insert_into_label_list(x, label(x));
+					if(excess(x) > 0)
+						push_active(x, label(x));
+				}
+			}
+			current_arc.fill(0);
+			work_since_global_relabel = 0;
+		}
+
+		//! All nodes with a label above d can no longer reach a target.
+		void remove_nodes_above_gap(int d){
+			for(int l=d+1; l<=max_label; ++l){
+				for(int x=all_first(l); x!=-1; x=all_next(x))
+					label[x] = node_count;
+				all_first[l] = -1;
+				active_first[l] = -1;
+			}
+			max_label = d;
+			max_active_label = std::min(max_active_label, d);
+		}
+
+		void discharge(int x){
+			auto arc_begin = std::begin(inv_tail(x));
+			int degree = std::end(inv_tail(x)) - arc_begin;
+			int d = label(x);
+
+			for(;;){
+				int i = current_arc(x);
+				work_since_global_relabel += degree - i;
+				for(; i<degree; ++i){
+					auto xy = arc_begin[i];
+					auto y = head(xy);
+					if(label(y) == d-1){
+						int r = push_relabel_detail::residual_capacity(is_saturated, back_arc, xy);
+						while(r > 0 && excess(x) > 0){
+							push_relabel_detail::push_unit(is_saturated, back_arc, xy);
+							--r;
+							--excess[x];
+							if(is_target(y))
+								++flow_intensity;
+							else{
+								if(excess(y) == 0)
+									push_active(y, d-1);
+								++excess[y];
+							}
+						}
+						if(excess(x) == 0)
+							break;
+					}
+				}
+				current_arc[x] = i;
+				if(excess(x) == 0)
+					return;
+
+				remove_from_label_list(x, d);
+				if(all_first(d) == -1){
+					remove_nodes_above_gap(d);
+					label[x] = node_count;
+					return;
+				}
+
+				int new_d = node_count;
+				for(int j=0; j<degree; ++j){
+					auto xy = arc_begin[j];
+					if(push_relabel_detail::residual_capacity(is_saturated, back_arc, xy) > 0)
+						new_d = std::min(new_d, label(head(xy))+1);
+				}
+				work_since_global_relabel += degree + 12;
+
+				current_arc[x] = 0;
+				if(new_d >= node_count){
+					label[x] = node_count;
+					return;
+				}
+				label[x] = new_d;
+				insert_into_label_list(x, new_d);
+				d = new_d;
+			}
+		}
+
+	public:
+		void advance(){
+			if(is_finished_flag)
+				return;
+
+			const long long global_relabel_work = 6ll*node_count + arc_count;
+			while(work_since_global_relabel <= global_relabel_work){
+				while(max_active_label > 0 && active_first(max_active_label) == -1)
+					--max_active_label;
+				if(active_first(max_active_label) == -1){
+					push_relabel_detail::return_excess_to_sources(inv_tail, head, back_arc, is_source, is_target, is_saturated, excess, current_arc, queue);
+					is_finished_flag = true;
+					return;
+				}
+				auto x = active_first(max_active_label);
+				active_first[max_active_label] = active_next(x);
+				if(label(x) == max_active_label && excess(x) > 0)
+					discharge(x);
+			}
+			global_relabel();
+		}
+
+		int get_current_flow_intensity()const{
+			return flow_intensity;
+		}
+
+		BitIDFunc get_saturated_flags()const{
+			return push_relabel_detail::to_bit_id_func(is_saturated);
+		}
+
+		BitIDFunc move_saturated_flags()const{
+			return push_relabel_detail::to_bit_id_func(is_saturated);
+		}
+
+		bool is_finished()const{
+			return is_finished_flag;
+		}
+
+	private:
+		int node_count, arc_count;
+		const InvTail&inv_tail;
+		const Head&head;
+		const BackArc&back_arc;
+		const SourceList&source_list;
+		const TargetList&target_list;
+
+		BitIDFunc is_source;
+		BitIDFunc is_target;
+		ArrayIDFunc<unsigned char>is_saturated;
+		int flow_intensity;
+
+		ArrayIDFunc<int>excess;
+		ArrayIDFunc<int>label;
+		ArrayIDFunc<int>current_arc;
+
+		// All nodes with a label below node_count are kept in a doubly linked list per label. The
+		// active nodes are additionally kept in a singly linked list per label.
+		ArrayIDFunc<int>all_first, all_next, all_prev;
+		ArrayIDFunc<int>active_first, active_next;
+		int max_label;
+		int max_active_label;
+
+		ArrayIDFunc<int>queue;
+		long long work_since_global_relabel;
+
+		bool is_finished_flag;
+	};
+
+	//! Synchronous parallel push relabel. In every round all active nodes push along admissible
+	//! arcs with respect to the labels of the previous round. As an arc can only be admissible in
+	//! one direction, every arc pair is modified by at most one thread in a round. Nodes that ran
+	//! out of admissible arcs are relabeled after all pushes of the round are done.
+	template<class InvTail, class Head, class BackArc, class SourceList, class TargetList>
+	class UnitParallelPushRelabelAlgo{
+	public:
+		UnitParallelPushRelabelAlgo(
+			const InvTail&inv_tail, const Head&head, const BackArc&back_arc,
+			const SourceList&source_list, const TargetList&target_list,
+			int thread_count
+		):
+			node_count(head.image_count()), arc_count(head.preimage_count()), thread_count(thread_count),
+			inv_tail(inv_tail), head(head), back_arc(back_arc), source_list(source_list), target_list(target_list),
+			is_source(node_count), is_target(node_count), is_saturated(arc_count),
+			excess(node_count), label(node_count), new_label(node_count), last_activation_round(node_count),
+			queue(node_count), current_arc(node_count),
+			next_active(thread_count), relabel_list(thread_count){
+
+			is_source.fill(false);
+			for(int i=0; i<source_list.preimage_count(); ++i)
+				is_source.set(source_list(i), true);
+
+			is_target.fill(false);
+			for(int i=0; i<target_list.preimage_count(); ++i)
+				is_target.set(target_list(i), true);
+
+			is_saturated.fill(false);
+			excess.fill(0);
+			flow_intensity = 0;
+
+			for(int i=0; i<source_list.preimage_count(); ++i){
+				for(auto xy:inv_tail(source_list(i))){
+					auto y = head(xy);
+					if(!is_source(y)){
+						is_saturated[xy] = true;
+						if(is_target(y))
+							++flow_intensity;
+						else
+							++excess[y];
+					}
+				}
+			}
+
+			last_activation_round.fill(0);
+			round = 0;
+			global_relabel();
+			is_finished_flag = false;
+		}
+
+	private:
+		void global_relabel(){
+			push_relabel_detail::compute_exact_labels(inv_tail, head, back_arc, is_source, target_list, is_saturated, label, queue);
+			active.clear();
+			for(int x=0; x<node_count; ++x)
+				if(excess(x) > 0 && !is_source(x) && !is_target(x) && label(x) < node_count)
+					active.push_back(x);
+		}
+
+		int compute_new_label(int x)const{
+			int new_d = node_count;
+			for(auto xy:inv_tail(x))
+				if(push_relabel_detail::residual_capacity(is_saturated, back_arc, xy) > 0)
+					new_d = std::min(new_d, label(head(xy))+1);
+			return new_d;
+		}
+
+		long long run_round(){
+			++round;
+			long long round_work = 0;
+			int round_flow = 0;
+
+			#pragma omp parallel num_threads(thread_count) reduction(+:round_work, round_flow)
+			{
+				int thread_id = omp_get_thread_num();
+				auto&my_next_active = next_active[thread_id];
+				auto&my_relabel_list = relabel_list[thread_id];
+				my_next_active.clear();
+				my_relabel_list.clear();
+
+				auto activate = [&](int x){
+					int old_round;
+					#pragma omp atomic capture
+					{old_round = last_activation_round[x]; last_activation_round[x] = round;}
+					if(old_round != round)
+						my_next_active.push_back(x);
+				};
+
+				#pragma omp for schedule(dynamic, 64)
+				for(int i=0; i<(int)active.size(); ++i){
+					auto x = active[i];
+					auto d = label(x);
+					int e;
+					#pragma omp atomic read
+					e = excess[x];
+
+					int pushed = 0;
+					for(auto xy:inv_tail(x)){
+						if(pushed == e)
+							break;
+						++round_work;
+						auto y = head(xy);
+						if(label(y) == d-1){
+							int r = push_relabel_detail::residual_capacity(is_saturated, back_arc, xy);
+							while(r > 0 && pushed < e){
+								push_relabel_detail::push_unit(is_saturated, back_arc, xy);
+								--r;
+								++pushed;
+								if(is_target(y))
+									++round_flow;
+								else{
+									#pragma omp atomic
+									excess[y] += 1;
+									activate(y);
+								}
+							}
+						}
+					}
+
+					int remaining;
+					#pragma omp atomic capture
+					{excess[x] -= pushed; remaining = excess[x];}
+
+					if(pushed < e)
+						my_relabel_list.push_back(x);
+					if(remaining > 0)
+						activate(x);
+				}
+
+				for(auto x:my_relabel_list){
+					new_label[x] = compute_new_label(x);
+					round_work += 12;
+				}
+
+				#pragma omp barrier
+
+				for(auto x:my_relabel_list)
+					label[x] = new_label(x);
+			}
+
+			flow_intensity += round_flow;
+
+			active.clear();
+			for(auto&l:next_active)
+				for(auto x:l)
+					if(label(x) < node_count)
+						active.push_back(x);
+
+			return round_work;
+		}
+
+	public:
+		void advance(){
+			if(is_finished_flag)
+				return;
+
+			const long long global_relabel_work = 6ll*node_count + arc_count;
+			long long work = 0;
+			while(work <= global_relabel_work){
+				if(active.empty()){
+					push_relabel_detail::return_excess_to_sources(inv_tail, head, back_arc, is_source, is_target, is_saturated, excess, current_arc, queue);
+					is_finished_flag = true;
+					return;
+				}
+				work += run_round();
+			}
+			global_relabel();
+		}
+
+		int get_current_flow_intensity()const{
+			return flow_intensity;
+		}
+
+		BitIDFunc get_saturated_flags()const{
+			return push_relabel_detail::to_bit_id_func(is_saturated);
+		}
+
+		BitIDFunc move_saturated_flags()const{
+			return push_relabel_detail::to_bit_id_func(is_saturated);
+		}
+
+		bool is_finished()const{
+			return is_finished_flag;
+		}
+
+	private:
+		int node_count, arc_count, thread_count;
+		const InvTail&inv_tail;
+		const Head&head;
+		const BackArc&back_arc;
+		const SourceList&source_list;
+		const TargetList&target_list;
+
+		BitIDFunc is_source;
+		BitIDFunc is_target;
+		ArrayIDFunc<unsigned char>is_saturated;
+		int flow_intensity;
+
+		ArrayIDFunc<int>excess;
+		ArrayIDFunc<int>label;
+		ArrayIDFunc<int>new_label;
+		ArrayIDFunc<int>last_activation_round;
+		int round;
+
+		ArrayIDFunc<int>queue;
+		ArrayIDFunc<int>current_arc;
+
+		std::vector<int>active;
+		std::vector<std::vector<int>>next_active;
+		std::vector<std::vector<int>>relabel_list;
+
+		bool is_finished_flag;
+	};
+
+	template<class InvTail, class Head, class BackArc, class SourceList, class TargetList>
+	BitIDFunc compute_maximum_unit_flow_using_push_relabel(
+		const InvTail&inv_tail, const Head&head, const BackArc&back_arc,
+		const SourceList&source_list, const TargetList&target_list
+	){
+		UnitPushRelabelAlgo<InvTail, Head, BackArc, SourceList, TargetList> algo(inv_tail, head, back_arc, source_list, target_list);
+		do{
+			algo.advance();
+		}while(!algo.is_finished());
+		return algo.move_saturated_flags();
+	}
+
+	template<class InvTail, class Head, class BackArc, class SourceList, class TargetList>
+	BitIDFunc compute_maximum_unit_flow_using_parallel_push_relabel(
+		const InvTail&inv_tail, const Head&head, const BackArc&back_arc,
+		const SourceList&source_list, const TargetList&target_list,
+		int thread_count
+	){
+		UnitParallelPushRelabelAlgo<InvTail, Head, BackArc, SourceList, TargetList> algo(inv_tail, head, back_arc, source_list, target_list, thread_count);
+		do{
+			algo.advance();
+		}while(!algo.is_finished());
+		return algo.move_saturated_flags();
+	}
+}
+
+#endif
+
@@ -8,22 +8,202 @@
 #include "tiny_id_func.h"
 #include "min_max.h"
 #include "timer.h"
+#include "compact_id_func.h"
+#include "nested_dissection_cutoff.h"
+#include <cstdint>
 
 namespace flow_cutter{
 
+	//! Labels of the nodes of the input graph, for example the sides of a partition computed by a
+	//! previous run on the same or on a slightly modified graph. Negative labels mark unlabeled
+	//! nodes. The hint is only given from outside. A nested dissection does not pass the sides of
+	//! a separator on to its children, as every child lies on one side and the sides carry no
+	//! split of it.
+	struct SeparatorHint{
+		explicit SeparatorHint(ArrayIDFunc<int>label):label(std::move(label)){}
+
+		ArrayIDFunc<int>label;
+	};
+
+	//! Restricts the hint to a subgraph, whose nodes are mapped onto the nodes of the input graph
+	//! by input_node_id. The sources are nodes with the most frequent label and the targets nodes
+	//! with the second most frequent one. Of each label the set_fraction of its nodes farthest from
+	//! the boundary of the labels is taken, so that the cutter starts from the cores of the hinted
+	//! regions and remains free to move the cut near the hinted boundary. As all cutters would
+	//! start from the same sets, a single one is returned. Returns none if fewer than two labels
+	//! occur in the subgraph.
+	template<class InputNodeID, class OutArc, class Head>
+	std::vector<SourceTargetSets>select_source_target_sets_from_hint(const SeparatorHint&hint, const InputNodeID&input_node_id, const OutArc&out_arc, const Head&head, double set_fraction){
+		const int node_count = input_node_id.preimage_count();
+
+		ArrayIDFunc<int>label(node_count);
+		std::vector<int>sorted_label;
+		for(int x=0; x<node_count; ++x){
+			label[x] = hint.label(input_node_id(x));
+			if(label[x] >= 0)
+				sorted_label.push_back(label[x]);
+		}
+		std::sort(sorted_label.begin(), sorted_label.end());
+
+		int first_label = -1, first_size = 0, second_label = -1, second_size = 0;
+		for(int begin = 0, end; begin != (int)sorted_label.size(); begin = end){
+			end = begin+1;
+			while(end != (int)sorted_label.size() && sorted_label[end] == sorted_label[begin])
+				++end;
+			if(end - begin > first_size){
+				second_label = first_label;
+				second_size = first_size;
+				first_label = sorted_label[begin];
+				first_size = end - begin;
+			}else if(end - begin > second_size){
+				second_label = sorted_label[begin];
+				second_size = end - begin;
+			}
+		}
+
+		// A label that covers only few nodes of the subgraph is not a hinted side but a remainder
+		// of the boundary, or noise. Starting from it leads to unbalanced cuts.
+		std::vector<SourceTargetSets>p;
+		if(second_size == 0 || second_size < set_fraction*node_count)
+			return p;
+
+		// Breadth first search from the nodes of both labels that have a differently labeled
+		// neighbor. Nodes that are not reached count as farthest.
+		std::vector<int>order;
+		order.reserve(node_count);
+		BitIDFunc was_seen(node_count);
+		was_seen.fill(false);
+		for(int x=0; x<node_count; ++x){
+			if(label(x) != first_label && label(x) != second_label)
+				continue;
+			for(auto xy:out_arc(x)){
+				if(label(head(xy)) != label(x)){
+					was_seen.set(x, true);
+					order.push_back(x);
+					break;
+				}
+			}
+		}
+		for(int i=0; i<(int)order.size(); ++i){
+			for(auto xy:out_arc(order[i])){
+				int y = head(xy);
+				if(!was_seen(y)){
+					was_seen.set(y, true);
+					order.push_back(y);
+				}
+			}
+		}
+		for(int x=0; x<node_count; ++x)
+			if(!was_seen(x))
+				order.push_back(x);
+
+		auto select_core = [&](int l, int label_size, std::vector<int>&core){
+			int core_size = std::max(1, static_cast<int>(set_fraction*label_size));
+			for(int i=node_count-1; i>=0 && (int)core.size() < core_size; --i)
+				if(label(order[i]) == l)
+					core.push_back(order[i]);
+		};
+
+		p.resize(1);
+		select_core(first_label, first_size, p[0].source_list);
+		select_core(second_label, second_size, p[0].target_list);
+		return p;
+	}
+
+	//! Copies share a CutterStatePool, which reuses the memory of the cutters across the separator
+	//! computations of a nested dissection. If a hint is given, the cutter starts from the terminal
+	//! sets of select_source_target_sets_from_hint, which carries the hint into every level of the
+	//! recursion, and otherwise from the terminals selected by the config. If node weights of the
+	//! input graph are given, the balance is measured in node weight instead of node count. They
+	//! must be positive.
 	class ComputeSeparator{
 	public:
-		explicit ComputeSeparator(Config config):config(config){}
+		explicit ComputeSeparator(Config config, std::shared_ptr<const SeparatorHint>hint = nullptr, std::shared_ptr<const ArrayIDFunc<int>>input_node_weight = nullptr):
+			config(config), cutter_state_pool(std::make_shared<CutterStatePool>()), hint(std::move(hint)), input_node_weight(std::move(input_node_weight)){}
 
 		template<class Tail, class Head, class InputNodeID, class ArcWeight>
-		std::vector<int> operator()(const Tail&tail, const Head&head, const InputNodeID&, const ArcWeight&arc_weight)const{
-
+		std::vector<int> operator()(const Tail&tail, const Head&head, const InputNodeID&input_node_id, const ArcWeight&arc_weight)const{
 			const int node_count = tail.image_count();
-			const int arc_count = tail.preimage_count();
 
 			auto out_arc = invert_sorted_id_id_func(tail);
 			auto back_arc = compute_back_arc_permutation(tail, head);
 
+			std::vector<SourceTargetSets>hinted_sets;
+			if(hint){
+				if(hint->label.preimage_count() != input_node_id.image_count())
+					throw std::runtime_error("The separator hint has "+std::to_string(hint->label.preimage_count())+" labels but the graph has "+std::to_string(input_node_id.image_count())+" nodes");
+				hinted_sets = select_source_target_sets_from_hint(*hint, input_node_id, out_arc, head, config.terminal_set_fraction);
+			}
+
+			if(input_node_weight){
+				if(input_node_weight->preimage_count() != input_node_id.image_count())
+					throw std::runtime_error("There are "+std::to_string(input_node_weight->preimage_count())+" node weights but the graph has "+std::to_string(input_node_id.image_count())+" nodes");
+				ArrayIDFunc<int>node_weight(node_count);
+				for(int x=0; x<node_count; ++x){
+					node_weight[x] = (*input_node_weight)(input_node_id(x));
+					if(node_weight[x] <= 0)
+						throw std::runtime_error("node weights must be positive");
+				}
+				return compute_with_hinted_sets(tail, head, out_arc, back_arc, make_const_ref_id_func(node_weight), arc_weight, hinted_sets);
+			}else{
+				return compute_with_hinted_sets(tail, head, out_arc, back_arc, ConstIntIDFunc<1>(node_count), arc_weight, hinted_sets);
+			}
+		}
+
+		//! Reuses the out arcs and back arcs of a graph with sorted tails, for example of a graph
+		//! that is kept in memory across many separator computations. The nodes are not weighted.
+		template<class Tail, class Head, class OutArc, class BackArc, class ArcWeight>
+		std::vector<int> compute_with_back_arcs(const Tail&tail, const Head&head, const OutArc&out_arc, const BackArc&back_arc, const ArcWeight&arc_weight)const{
+			return compute_with_hinted_sets(tail, head, out_arc, back_arc, ConstIntIDFunc<1>(tail.image_count()), arc_weight, {});
+		}
+	private:
+		//! Initializes the cutter with the hinted sets or, if there are none, with the terminals
+		//! selected by the config. If is_expanded is set, then the cutter runs on the expanded graph.
+		template<class Cutter, class OutArc, class Head>
+		void init_cutter(Cutter&cutter, const OutArc&out_arc, const Head&head, std::vector<SourceTargetSets>hinted_sets, bool is_expanded)const{
+			if(!hinted_sets.empty()){
+				if(is_expanded)
+					hinted_sets = expanded_graph::expand_source_target_set_list(std::move(hinted_sets));
+				cutter.init(hinted_sets, config.random_seed);
+				return;
+			}
+			if(config.terminal_selection == Config::TerminalSelection::bfs_set){
+				auto sets = select_bfs_source_target_sets(out_arc, head, config.cutter_count, config.terminal_set_fraction, config.random_seed);
+				if(!sets.empty()){
+					if(is_expanded)
+						sets = expanded_graph::expand_source_target_set_list(std::move(sets));
+					cutter.init(sets, config.random_seed);
+					return;
+				}
+			}
+			auto pairs = select_random_source_target_pairs(out_arc.preimage_count(), config.cutter_count, config.random_seed);
+			if(is_expanded)
+				pairs = expanded_graph::expand_source_target_pair_list(std::move(pairs));
+			cutter.init(pairs, config.random_seed);
+		}
+
+		template<class Tail, class Head, class OutArc, class BackArc, class NodeWeight, class ArcWeight>
+		std::vector<int> compute_with_hinted_sets(const Tail&tail, const Head&head, const OutArc&out_arc, const BackArc&back_arc, const NodeWeight&node_weight, const ArcWeight&arc_weight, const std::vector<SourceTargetSets>&hinted_sets)const{
+			// Most graphs deep in a nested dissection are small. Storing their node and arc IDs in 16
+			// bits halves the memory that the cutters scan and keeps more of it in cache.
+			typedef CompactIDIDFunc<std::uint16_t> CompactID;
+			if(CompactID::can_store_ids_below(tail.image_count()) && CompactID::can_store_ids_below(tail.preimage_count()+1)){
+				return compute_on_graph(
+					CompactID(tail), CompactID(head), 
+					CompactRangeIDIDMultiFunc<std::uint16_t>(out_arc), CompactID(back_arc), 
+					node_weight, arc_weight, hinted_sets
+				);
+			}else{
+				return compute_on_graph(tail, head, out_arc, back_arc, node_weight, arc_weight, hinted_sets);
+			}
+		}
+
+		//! NodeWeight is copied into the flow graph and should be cheap to copy.
+		template<class Tail, class Head, class OutArc, class BackArc, class NodeWeight, class ArcWeight>
+		std::vector<int> compute_on_graph(const Tail&tail, const Head&head, const OutArc&out_arc, const BackArc&back_arc, const NodeWeight&node_weight, const ArcWeight&arc_weight, const std::vector<SourceTargetSets>&hinted_sets)const{
+
+			const int arc_count = tail.preimage_count();
+
 			std::vector<int>separator;
 
 			switch(config.separator_selection){
@@ -34,16 +214,16 @@ namespace flow_cutter{
 						make_const_ref_id_id_func(tail), 
 						make_const_ref_id_id_func(head), 
 						make_const_ref_id_id_func(back_arc), 
+						node_weight,
 						make_const_ref_id_id_func(arc_weight), 
 						make_const_ref_id_func(out_arc)
 					);
 
-					auto cutter = make_simple_cutter(expanded_graph, config);
-					auto pairs = select_random_source_target_pairs(node_count, config.cutter_count, config.random_seed);
+					auto cutter = make_simple_cutter(expanded_graph, config, cutter_state_pool);
 
 					double best_score = std::numeric_limits<double>::max();
 
-					cutter.init(expanded_graph::expand_source_target_pair_list(pairs), config.random_seed);
+					init_cutter(cutter, out_arc, head, hinted_sets, true);
 					for(;;){
 
 						double cut_size = cutter.get_current_cut().size();
@@ -51,16 +231,16 @@ namespace flow_cutter{
 
 						double score = cut_size / small_side_size;
 
-						if(cutter.get_current_smaller_cut_side_size() < config.max_imbalance * expanded_graph::expanded_node_count(node_count))
+						if(cutter.get_current_smaller_cut_side_size() < config.max_imbalance * expanded_graph.total_node_weight())
 							score += 1000000;
 						
 
 						if(score < best_score){
 							best_score = score;
-							separator = expanded_graph::extract_original_separator(tail, head, cutter).sep;
+							separator = expanded_graph::extract_original_separator(tail, head, node_weight, cutter).sep;
 						}
 
-						double potential_best_next_score = (double)(cut_size+1)/(double)(expanded_graph::expanded_node_count(node_count)/2);
+						double potential_best_next_score = (double)(cut_size+1)/(double)(expanded_graph.total_node_weight()/2);
 						if(potential_best_next_score >= best_score)
 							break;
 						
@@ -68,6 +248,7 @@ namespace flow_cutter{
 							break;
 						
 					}
+					FLOW_CUTTER_INSTRUMENT(instrumentation::thread_counters() += cutter.get_instrumentation_counters();)
 				}
 				break;
 				case Config::SeparatorSelection::edge_min_expansion:
@@ -76,17 +257,18 @@ namespace flow_cutter{
 						make_const_ref_id_id_func(tail), 
 						make_const_ref_id_id_func(head), 
 						make_const_ref_id_id_func(back_arc), 
+						node_weight,
 						make_const_ref_id_func(arc_weight),
 						ConstIntIDFunc<1>(arc_count),
 						make_const_ref_id_func(out_arc)
 					);
 
-					auto cutter = make_simple_cutter(graph, config);
+					auto cutter = make_simple_cutter(graph, config, cutter_state_pool);
 
 					std::vector<int>best_cut;
 					double best_score = std::numeric_limits<double>::max();
 
-					cutter.init(select_random_source_target_pairs(node_count, config.cutter_count, config.random_seed), config.random_seed);
+					init_cutter(cutter, out_arc, head, hinted_sets, false);
 
 					for(;;){
 
@@ -95,7 +277,7 @@ namespace flow_cutter{
 
 						double score = cut_size / small_side_size;
 
-						if(cutter.get_current_smaller_cut_side_size() < config.max_imbalance * node_count)
+						if(cutter.get_current_smaller_cut_side_size() < config.max_imbalance * graph.total_node_weight())
 							score += 1000000;
 						
 
@@ -104,7 +286,7 @@ namespace flow_cutter{
 							best_cut = cutter.get_current_cut();
 						}
 
-						double potential_best_next_score = (double)(cut_size+1)/(double)(expanded_graph::expanded_node_count(node_count)/2);
+						double potential_best_next_score = (double)(cut_size+1)/(double)(graph.total_node_weight());
 						if(potential_best_next_score >= best_score)
 							break;
 						
@@ -112,6 +294,7 @@ namespace flow_cutter{
 							break;
 						
 					}
+					FLOW_CUTTER_INSTRUMENT(instrumentation::thread_counters() += cutter.get_instrumentation_counters();)
 
 					for(auto x:best_cut)
 						separator.push_back(head(x));
@@ -126,16 +309,18 @@ namespace flow_cutter{
 						make_const_ref_id_id_func(tail), 
 						make_const_ref_id_id_func(head), 
 						make_const_ref_id_id_func(back_arc), 
+						node_weight,
 						make_const_ref_id_func(arc_weight),
 						ConstIntIDFunc<1>(arc_count),
 						make_const_ref_id_func(out_arc)
 					);
 
-					auto cutter = make_simple_cutter(graph, config);
-					cutter.init(select_random_source_target_pairs(node_count, config.cutter_count, config.random_seed), config.random_seed);
-					while(cutter.get_current_smaller_cut_side_size() < config.max_imbalance * node_count)
+					auto cutter = make_simple_cutter(graph, config, cutter_state_pool);
+					init_cutter(cutter, out_arc, head, hinted_sets, false);
+					while(cutter.get_current_smaller_cut_side_size() < config.max_imbalance * graph.total_node_weight())
 						if(!cutter.advance())
 							break;
+					FLOW_CUTTER_INSTRUMENT(instrumentation::thread_counters() += cutter.get_instrumentation_counters();)
 
 					for(auto x:cutter.get_current_cut())
 						separator.push_back(head(x));
@@ -150,19 +335,20 @@ namespace flow_cutter{
 						make_const_ref_id_id_func(tail), 
 						make_const_ref_id_id_func(head), 
 						make_const_ref_id_id_func(back_arc), 
+						node_weight,
 						make_const_ref_id_id_func(arc_weight), 
 						make_const_ref_id_func(out_arc)
 					);
 
-					auto cutter = make_simple_cutter(expanded_graph, config);
-					auto pairs = select_random_source_target_pairs(node_count, config.cutter_count, config.random_seed);
+					auto cutter = make_simple_cutter(expanded_graph, config, cutter_state_pool);
 
-					cutter.init(expanded_graph::expand_source_target_pair_list(pairs), config.random_seed);
-					while(cutter.get_current_smaller_cut_side_size() < config.max_imbalance * expanded_graph::expanded_node_count(node_count))
+					init_cutter(cutter, out_arc, head, hinted_sets, true);
+					while(cutter.get_current_smaller_cut_side_size() < config.max_imbalance * expanded_graph.total_node_weight())
 						if(!cutter.advance())
 							break;
+					FLOW_CUTTER_INSTRUMENT(instrumentation::thread_counters() += cutter.get_instrumentation_counters();)
 
-					separator = expanded_graph::extract_original_separator(tail, head, cutter).sep;
+					separator = expanded_graph::extract_original_separator(tail, head, node_weight, cutter).sep;
 				}
 				break;
 				default:
@@ -173,10 +359,26 @@ namespace flow_cutter{
 			return std::move(separator);
 
 		}
-	private:
+
 		Config config;
+		std::shared_ptr<CutterStatePool>cutter_state_pool;
+		std::shared_ptr<const SeparatorHint>hint;
+		std::shared_ptr<const ArrayIDFunc<int>>input_node_weight;
 	};
 
+	//! The cutoff of the nested dissection recursion set in the config.
+	inline
+	cch_order::NestedDissectionCutoff get_nested_dissection_cutoff(const Config&config){
+		cch_order::NestedDissectionCutoff cutoff;
+		cutoff.max_node_count = config.nested_dissection_cutoff_node_count;
+		cutoff.max_tree_width = config.nested_dissection_cutoff_tree_width;
+		cutoff.max_tree_width_node_count = config.nested_dissection_cutoff_tree_width_max_node_count;
+		if(config.nested_dissection_bottom_level_orderer == Config::NestedDissectionBottomLevelOrderer::min_shortcut)
+			cutoff.bottom_level_orderer = cch_order::NestedDissectionCutoff::BottomLevelOrderer::min_shortcut;
+		else
+			cutoff.bottom_level_orderer = cch_order::NestedDissectionCutoff::BottomLevelOrderer::min_degree;
+		return cutoff;
+	}
 
 	class ComputeIsOnSmallerSideOfCut{
 	public:
@@ -247,7 +449,7 @@ namespace separator{
 	public:
 		ReportSeparatorStatistics(std::ostream&out, ComputeSeparator compute_separator):
 			out(out), compute_separator(std::move(compute_separator)){
-			out << "node_count,arc_count,sep_node_count,large_node_count,running_time,reporting_running_time\n";
+			out << "node_count,arc_count,sep_node_count,large_node_count,running_time,reporting_running_time" << flow_cutter::instrumentation::get_csv_header() << '\n';
 		}
 
 		template<class Tail, class Head, class InputNodeID, class ArcWeight>
@@ -256,15 +458,18 @@ namespace separator{
 			const int node_count = tail.image_count();
 			const int arc_count = tail.preimage_count();
 
+			auto counters = flow_cutter::instrumentation::thread_counters();
 			long long running_time = -get_micro_time();
 			auto sep = compute_separator(tail, head, input_node_id, arc_weight);
 			running_time += get_micro_time();
+			auto separator_counters = flow_cutter::instrumentation::thread_counters();
+			separator_counters -= counters;
 
 			long long reporting_running_time = -get_micro_time();
 			auto large_node_count = determine_largest_part_size(tail, head, sep);
 			reporting_running_time += get_micro_time();
 
-			out << node_count << ',' << arc_count << ',' << sep.size() << ',' << large_node_count << ',' << running_time << ',' << reporting_running_time << '\n';
+			out << node_count << ',' << arc_count << ',' << sep.size() << ',' << large_node_count << ',' << running_time << ',' << reporting_running_time << flow_cutter::instrumentation::get_csv_row(separator_counters) << '\n';
 			return std::move(sep);
 		}
 	
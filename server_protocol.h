@@ -0,0 +1,191 @@
+#ifndef SERVER_PROTOCOL_H
+#define SERVER_PROTOCOL_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <cerrno>
+#include <unistd.h>
+
+// The framed binary protocol spoken between flow_cutter_server and its clients.
+//
+// Every message is a frame consisting of the payload size as 32 bit little endian unsigned integer
+// followed by the payload. A request payload starts with a request id and an opcode, a response
+// payload with the id of the request it answers and a status. Responses may arrive in a different
+// order than the requests were sent.
+//
+// Payload fields are 8 bit or 32 bit little endian integers, strings stored as their byte count
+// followed by the bytes, and int lists stored as their element count followed by the elements.
+namespace server_protocol{
+
+	enum class Opcode : std::uint8_t{
+		// string name, string format, string file name -> u32 node_count, u32 arc_count
+		load_graph_file = 1,
+		// string name, i32 node_count, list first_out, list head, list arc_weight -> u32 node_count, u32 arc_count
+		load_graph_csr = 2,
+		// string name ->
+		drop_graph = 3,
+		// -> u32 graph count, (string name, u32 node_count, u32 arc_count) per graph
+		list_graphs = 4,
+		// string name, string config, i32 seed, list nodes -> list separator
+		compute_separator = 5,
+		// string name, string config, i32 seed, u8 is_cch_order, list nodes -> list order
+		compute_order = 6,
+		// ->
+		shutdown = 7
+	};
+
+	enum class Status : std::uint8_t{
+		ok = 0,
+		// string message
+		error = 1
+	};
+
+	const std::uint32_t max_frame_size = 1u << 30;
+
+	class PayloadWriter{
+	public:
+		void write_u8(std::uint8_t x){
+			data.push_back(static_cast<char>(x));
+		}
+
+		void write_u32(std::uint32_t x){
+			for(int i=0; i<4; ++i)
+				data.push_back(static_cast<char>((x >> (8*i)) & 0xFF));
+		}
+
+		void write_i32(int x){
+			write_u32(static_cast<std::uint32_t>(x));
+		}
+
+		void write_string(const std::string&s){
+			write_u32(s.size());
+			data.append(s);
+		}
+
+		template<class List>
+		void write_int_list(const List&l){
+			write_u32(l.end() - l.begin());
+			for(auto x:l)
+				write_i32(x);
+		}
+
+		const std::string&get_data()const{
+			return data;
+		}
+
+	private:
+		std::string data;
+	};
+
+	class PayloadReader{
+	public:
+		explicit PayloadReader(const std::string&data):data(data), pos(0){}
+
+		std::uint8_t read_u8(){
+			require(1);
+			return static_cast<std::uint8_t>(data[pos++]);
+		}
+
+		std::uint32_t read_u32(){
+			require(4);
+			std::uint32_t x = 0;
+			for(int i=0; i<4; ++i)
+				x |= static_cast<std::uint32_t>(static_cast<std::uint8_t>(data[pos++])) << (8*i);
+			return x;
+		}
+
+		int read_i32(){
+			return static_cast<int>(read_u32());
+		}
+
+		std::string read_string(){
+			std::uint32_t size = read_u32();
+			require(size);
+			std::string s = data.substr(pos, size);
+			pos += size;
+			return s; // NVRO
+		}
+
+		std::vector<int>read_int_list(){
+			std::uint32_t size = read_u32();
+			require(4ull*size);
+			std::vector<int>l(size);
+			for(auto&x:l)
+				x = read_i32();
+			return l; // NVRO
+		}
+
+		bool is_at_end()const{
+			return pos == data.size();
+		}
+
+	private:
+		void require(unsigned long long n)const{
+			if(data.size() - pos < n)
+				throw std::runtime_error("payload is truncated");
+		}
+
+		const std::string&data;
+		std::size_t pos;
+	};
+
+	//! Returns false if the file descriptor is at its end before the first byte.
+	inline bool read_all(int fd, char*buffer, std::size_t size){
+		std::size_t done = 0;
+		while(done != size){
+			ssize_t r = ::read(fd, buffer+done, size-done);
+			if(r < 0 && errno == EINTR)
+				continue;
+			if(r < 0)
+				throw std::runtime_error("read failed");
+			if(r == 0){
+				if(done == 0)
+					return false;
+				throw std::runtime_error("frame is truncated");
+			}
+			done += r;
+		}
+		return true;
+	}
+
+	inline void write_all(int fd, const char*buffer, std::size_t size){
+		std::size_t done = 0;
+		while(done != size){
+			ssize_t r = ::write(fd, buffer+done, size-done);
+			if(r < 0 && errno == EINTR)
+				continue;
+			if(r < 0)
+				throw std::runtime_error("write failed");
+			done += r;
+		}
+	}
+
+	//! Returns false if the connection was closed between two frames.
+	inline bool read_frame(int fd, std::string&payload){
+		char size_buffer[4];
+		if(!read_all(fd, size_buffer, 4))
+			return false;
+		std::uint32_t size = 0;
+		for(int i=0; i<4; ++i)
+			size |= static_cast<std::uint32_t>(static_cast<std::uint8_t>(size_buffer[i])) << (8*i);
+		if(size > max_frame_size)
+			throw std::runtime_error("frame is too large");
+		payload.resize(size);
+		if(size != 0 && !read_all(fd, &payload[0], size))
+			throw std::runtime_error("frame is truncated");
+		return true;
+	}
+
+	inline void write_frame(int fd, const std::string&payload){
+		if(payload.size() > max_frame_size)
+			throw std::runtime_error("frame is too large");
+		PayloadWriter size;
+		size.write_u32(payload.size());
+		std::string frame = size.get_data() + payload;
+		write_all(fd, frame.data(), frame.size());
+	}
+}
+
+#endif
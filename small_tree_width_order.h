@@ -323,7 +323,7 @@ namespace small_tree_width{
 		auto orderer = [&](ArrayIDIDFunc a_tail, ArrayIDIDFunc a_head, ArrayIDIDFunc a_input_node_id, ArrayIDFunc<int>a_weight){
 			(void)a_weight;
 
-			static int recurse_level = 0;
+			thread_local int recurse_level = 0;
 			++recurse_level;
 			ArrayIDIDFunc order;
 			if(recurse_level < 3)
@@ -500,7 +500,7 @@ namespace small_tree_width{
 		if(separator_set.empty())
 			return chain(compute_greedy_min_shortcut_order(tail, head), input_node_id);
 	
-static int recurse_level = 0;
+thread_local int recurse_level = 0;
 ++recurse_level;
 /*
 {
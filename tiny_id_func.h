@@ -74,6 +74,12 @@ public:
 		return operator()(id);
 	}
 
+	//! Changes the preimage count, leaves the values unspecified and reuses the memory if possible.
+	void discard_and_resize(int preimage){
+		preimage_ = preimage;
+		data_.discard_and_resize((preimage + entry_count_per_uint64 - 1) / entry_count_per_uint64);
+	}
+
 	void swap(TinyIntIDFunc&other)noexcept{
 		std::swap(preimage_, other.preimage_);
 		data_.swap(other.data_);
@@ -1,193 +1,192 @@
 #include "tree_decomposition.h"
 #include "io_helper.h"
+#include "elimination_tree.h"
+#include "permutation.h"
+#include "chain.h"
 #include <string>
 #include <vector>
 #include <algorithm>
 #include <cassert>
-#include "heap.h"
-#include "tiny_id_func.h"
-#include "contraction_graph.h"
-#include "id_multi_func.h"
+#include <omp.h>
 using namespace std;
 
-void print_tree_decompostion(const std::string&file_name, ArrayIDIDFunc tail, ArrayIDIDFunc head, const ArrayIDIDFunc&order){
+TreeDecomposition compute_tree_decomposition(const ArrayIDIDFunc&tail, const ArrayIDIDFunc&head){
 	const int node_count = tail.image_count();
-	assert(node_count > 1);
 
-	auto inv_order = inverse_permutation(order);
-	tail = chain(tail, inv_order);
-	head = chain(head, inv_order);
+	auto parent = elimination_tree::compute_elimination_tree_parent(tail, head);
 
-	vector<vector<int>>nodes_in_bag;
-	ArrayIDFunc<vector<int>>bags_of_node(node_count);
+	ArrayIDFunc<int>first_up(node_count+1);
+	first_up.fill(0);
+	elimination_tree::forall_chordal_supergraph_arcs(tail, head, parent, [&](int x, int){ ++first_up[x+1]; });
+	for(int x=0; x<node_count; ++x)
+		first_up[x+1] += first_up[x];
 
-	auto is_left_subset_of_right = [](const std::vector<int>&l, const std::vector<int>&r){
-		auto i = l.begin(), j = r.begin();
+	// The arcs are enumerated by increasing head and thus every upward neighborhood is sorted.
+	ArrayIDFunc<int>up_head(first_up(node_count));
+	{
+		ArrayIDFunc<int>pos = first_up;
+		elimination_tree::forall_chordal_supergraph_arcs(tail, head, parent, [&](int x, int y){ up_head[pos[x]++] = y; });
+	}
 
-		for(;;){
-			if(i == l.end())
-				return true;
-			if(j == r.end())
-				return false;
+	auto up_deg = [&](int x){ return first_up(x+1) - first_up(x); };
+
+	// The bag of x is x together with its upward neighbors. The upward neighbors of x without the
+	// parent p are a subset of the upward neighbors of p. The bag of p is therefore contained in
+	// the bag of x if and only if x has exactly one upward neighbor more than p. Such a p is
+	// merged into x. This leaves exactly the maximal cliques of the chordal supergraph.
+	ArrayIDFunc<int>absorbed_into(node_count);
+	absorbed_into.fill(-1);
+	for(int x=0; x<node_count; ++x){
+		int p = parent(x);
+		if(p != -1 && absorbed_into(p) == -1 && up_deg(x) == up_deg(p)+1)
+			absorbed_into[p] = x;
+	}
 
-			if(*i < *j)
-				return false;
-			if(*i == *j)
-				++i;
-			++j;
-		}
-	};
+	// Nodes are absorbed into lower nodes, so increasing order resolves the chains.
+	ArrayIDFunc<int>bag_of_node(node_count);
+	int bag_count = 0;
+	for(int x=0; x<node_count; ++x){
+		if(absorbed_into(x) == -1)
+			bag_of_node[x] = bag_count++;
+		else
+			bag_of_node[x] = bag_of_node(absorbed_into(x));
+	}
 
-	auto compute_intersection_size = [](const std::vector<int>&l, const std::vector<int>&r){
-		auto i = l.begin(), j = r.begin();
-		int n = 0;
-		for(;;){
-			if(i == l.end() || j == r.end())
-				return n;
-			if(*i < *j)
-				++i;
-			else if(*i > *j)
-				++j;
-			else{
-				++i;
-				++j;
-				++n;
-			}
+	TreeDecomposition td;
+	td.node_count = node_count;
+	td.maximum_bag_size = 0;
+	td.first_node_in_bag = ArrayIDFunc<int>(bag_count+1);
+	td.bag_parent = ArrayIDFunc<int>(bag_count);
+
+	int bag_size_sum = 0;
+	for(int x=0; x<node_count; ++x)
+		if(absorbed_into(x) == -1)
+			bag_size_sum += up_deg(x)+1;
+	td.node_in_bag = ArrayIDFunc<int>(bag_size_sum);
+
+	int root_bag = -1;
+	int pos = 0;
+	for(int x=0; x<node_count; ++x){
+		if(absorbed_into(x) != -1)
+			continue;
+		int b = bag_of_node(x);
+		td.first_node_in_bag[b] = pos;
+		td.node_in_bag[pos++] = x;
+		for(int i=first_up(x); i<first_up(x+1); ++i)
+			td.node_in_bag[pos++] = up_head(i);
+		max_to(td.maximum_bag_size, up_deg(x)+1);
+
+		int top = x;
+		while(parent(top) != -1 && absorbed_into(parent(top)) == top)
+			top = parent(top);
+
+		if(parent(top) != -1){
+			td.bag_parent[b] = bag_of_node(parent(top));
+		}else if(root_bag == -1){
+			td.bag_parent[b] = -1;
+			root_bag = b;
+		}else{
+			// The graph is disconnected. The elimination trees are joined at an arbitrary bag.
+			td.bag_parent[b] = root_bag;
 		}
-	};
+	}
+	td.first_node_in_bag[bag_count] = pos;
 
-	auto on_new_potential_maximal_clique = [&](int lowest_node_in_clique, std::vector<int>clique){
-		for(auto b:bags_of_node(lowest_node_in_clique))
-			if(is_left_subset_of_right(clique, nodes_in_bag[b]))
-				return;
-		int bag_id = nodes_in_bag.size();
-		for(auto x:clique)
-			bags_of_node[x].push_back(bag_id);
-		nodes_in_bag.push_back(move(clique));
-	};
+	return td; // NVRO
+}
 
+namespace{
+	void append_int(std::string&s, int x){
+		char buffer[16];
+		char*end = buffer+sizeof(buffer);
+		char*begin = end;
+		do{
+			*--begin = '0' + x % 10;
+			x /= 10;
+		}while(x != 0);
+		s.append(begin, end);
+	}
+}
+
+void write_tree_decomposition(std::ostream&out, const TreeDecomposition&td, const ArrayIDIDFunc&node_label, int thread_count){
+	const int bag_count = td.bag_count();
 
 	{
-		BitIDFunc is_root(node_count);
-		is_root.fill(true);
-		std::vector<int>upper_neighborhood_of_z;
-		int z = -1;
-		compute_chordal_supergraph(
-			tail, head, 
-			[&](int x, int y){
-				is_root.set(x, false);
-				if(z != -1 && z != x){
-					upper_neighborhood_of_z.push_back(z);
-					sort(upper_neighborhood_of_z.begin(), upper_neighborhood_of_z.end());
-					on_new_potential_maximal_clique(z, move(upper_neighborhood_of_z));
-					upper_neighborhood_of_z.clear();
-				}
-				z = x;
-				upper_neighborhood_of_z.push_back(y);
+		std::string header = "s td ";
+		append_int(header, bag_count);
+		header += ' ';
+		append_int(header, td.maximum_bag_size);
+		header += ' ';
+		append_int(header, td.node_count);
+		header += '\n';
+		out << header;
+	}
+
+	// The bags are formatted in blocks. A round formats a bounded number of blocks in parallel
+	// and then writes them in order, which bounds the memory of the buffers.
+	const int bags_per_block = 4096;
+	const int block_count = (bag_count + bags_per_block - 1) / bags_per_block;
+	const int blocks_per_round = 4*thread_count;
+	std::vector<std::string>buffer(blocks_per_round);
+
+	auto format_bags = [&](std::string&s, int begin, int end){
+		s.clear();
+		for(int b=begin; b<end; ++b){
+			s += "b ";
+			append_int(s, b+1);
+			for(int i=td.first_node_in_bag(b); i<td.first_node_in_bag(b+1); ++i){
+				s += ' ';
+				append_int(s, node_label(td.node_in_bag(i))+1);
 			}
-		);
-		upper_neighborhood_of_z.push_back(z);
-		sort(upper_neighborhood_of_z.begin(), upper_neighborhood_of_z.end());
-		on_new_potential_maximal_clique(z, move(upper_neighborhood_of_z));
-								
-		for(int x=0; x<node_count; ++x){
-			if(is_root(x)){
-				on_new_potential_maximal_clique(x, {x});
+			s += '\n';
+		}
+	};
+
+	auto format_edges = [&](std::string&s, int begin, int end){
+		s.clear();
+		for(int b=begin; b<end; ++b){
+			if(td.bag_parent(b) != -1){
+				append_int(s, td.bag_parent(b)+1);
+				s += ' ';
+				append_int(s, b+1);
+				s += '\n';
 			}
 		}
-	}
+	};
 
+	for(int pass=0; pass<2; ++pass){
+		for(int round_begin=0; round_begin<block_count; round_begin += blocks_per_round){
+			int round_end = std::min(block_count, round_begin + blocks_per_round);
+
+			#pragma omp parallel for schedule(dynamic) num_threads(thread_count)
+			for(int block=round_begin; block<round_end; ++block){
+				int begin = block*bags_per_block;
+				int end = std::min(bag_count, begin + bags_per_block);
+				if(pass == 0)
+					format_bags(buffer[block-round_begin], begin, end);
+				else
+					format_edges(buffer[block-round_begin], begin, end);
+			}
 
+			for(int block=round_begin; block<round_end; ++block)
+				out.write(buffer[block-round_begin].data(), buffer[block-round_begin].size());
+		}
+	}
+}
 
-	int bag_count = nodes_in_bag.size();
+void print_tree_decompostion(const std::string&file_name, ArrayIDIDFunc tail, ArrayIDIDFunc head, const ArrayIDIDFunc&order){
+	assert(tail.image_count() > 1);
 
-	int maximum_bag_size = 0;
-	for(auto&b:nodes_in_bag)
-		if((int)b.size() > maximum_bag_size)
-			maximum_bag_size = b.size();
+	auto inv_order = inverse_permutation(order);
+	tail = chain(tail, inv_order);
+	head = chain(head, inv_order);
 
+	auto td = compute_tree_decomposition(tail, head);
 
 	save_text_file(
-		file_name, 
+		file_name,
 		[&](std::ostream&out){
-			out << "s td "<< nodes_in_bag.size() << ' ' << maximum_bag_size << ' ' << node_count << '\n';
-			for(int i=0; i<bag_count; ++i){
-				out << "b "<<(i+1);
-				for(auto x:nodes_in_bag[i])
-					out << ' ' << (order(x)+1);
-				out << '\n';
-				
-			}
-
-			{
-				auto output_backbone_edge = [&](int b, int p){
-					out << (b+1) << ' ' << (p+1) << '\n';
-				};
-
-				std::vector<int>tail, head, weight;
-
-				for(int b=0; b<bag_count; ++b){
-					vector<int>neighbor_bags;
-					for(auto x:nodes_in_bag[b]){
-						vector<int>tmp;
-						std::set_union(
-							bags_of_node[x].begin(), bags_of_node[x].end(),
-							neighbor_bags.begin(), neighbor_bags.end(),
-							std::back_inserter(tmp)
-						);
-						neighbor_bags.swap(tmp);
-					}
-					for(auto p:neighbor_bags){
-						if(p != b){
-							tail.push_back(b);
-							head.push_back(p);
-							weight.push_back(compute_intersection_size(nodes_in_bag[b], nodes_in_bag[p]));
-						}
-					}
-				}
-
-				int arc_count = tail.size();
-
-				auto out_arc = invert_id_id_func(
-					id_id_func(
-						arc_count, bag_count, 
-						[&](unsigned a){return tail[a];}
-					)
-				);
-
-				BitIDFunc in_tree(bag_count);
-				in_tree.fill(false);
-				max_id_heap<int>q(arc_count);
-		
-				for(int b=0; b<bag_count; ++b){
-					if(!in_tree(b)){
-						if(b != 0)
-							output_backbone_edge(0, b);
-						in_tree.set(b, true);
-						for(int a:out_arc(b))
-							q.push(a, weight[a]);
-						while(!q.empty()){
-							int xy = q.pop();
-							
-							int x = tail[xy];
-							int y = head[xy];
-
-							assert(in_tree(x));
-
-							if(!in_tree(y)){
-								output_backbone_edge(x, y);
-								in_tree.set(y, true);
-								for(int yz:out_arc(y)){
-									assert(!q.contains(yz));
-									q.push(yz, weight[yz]);
-								}
-							}
-						}
-						
-					}
-				}
-			}
+			write_tree_decomposition(out, td, order);
 		}
 	);
 }
-
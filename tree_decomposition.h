@@ -3,6 +3,30 @@
 
 #include "array_id_func.h"
 #include <string>
+#include <ostream>
+
+//! A tree decomposition whose bags are the maximal cliques of the chordal supergraph.
+struct TreeDecomposition{
+	int node_count;
+	int maximum_bag_size;
+
+	//! The nodes of bag b are node_in_bag[first_node_in_bag[b]] to node_in_bag[first_node_in_bag[b+1]-1].
+	ArrayIDFunc<int>first_node_in_bag;
+	ArrayIDFunc<int>node_in_bag;
+
+	//! The parent of every bag in the decomposition tree or -1 for the root bag.
+	ArrayIDFunc<int>bag_parent;
+
+	int bag_count()const{ return bag_parent.preimage_count(); }
+};
+
+//! The node IDs of the symmetric graph are the elimination order. The running time is linear in the
+//! size of the chordal supergraph.
+TreeDecomposition compute_tree_decomposition(const ArrayIDIDFunc&tail, const ArrayIDIDFunc&head);
+
+//! Writes the decomposition in the PACE 2016 format. Node x is written as node_label(x)+1. The text
+//! of the bags is formatted by thread_count threads.
+void write_tree_decomposition(std::ostream&out, const TreeDecomposition&td, const ArrayIDIDFunc&node_label, int thread_count = 1);
 
 void print_tree_decompostion(const std::string&file_name, ArrayIDIDFunc tail, ArrayIDIDFunc head, const ArrayIDIDFunc&order);
 